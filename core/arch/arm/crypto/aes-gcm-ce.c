@@ -27,24 +27,46 @@ static void put_be_block(void *dst, const void *src)
 	put_be64((uint8_t *)dst + 8, s[0]);
 }
 
-void internal_aes_gcm_set_key(struct internal_aes_gcm_state *state,
-			      const struct internal_aes_gcm_key *enc_key)
+static void hash_subkey_to_le(uint64_t k[2], const uint8_t h[16])
 {
-	uint64_t k[2];
 	uint64_t a;
 	uint64_t b;
 
-	internal_aes_gcm_encrypt_block(enc_key, state->ctr, state->hash_subkey);
-
 	/* Store hash key in little endian and multiply by 'x' */
-	b = get_be64(state->hash_subkey);
-	a = get_be64(state->hash_subkey + 8);
+	b = get_be64(h);
+	a = get_be64(h + 8);
 	k[0] = (a << 1) | (b >> 63);
 	k[1] = (b << 1) | (a >> 63);
 	if (b >> 63)
 		k[1] ^= 0xc200000000000000UL;
+}
 
+void internal_aes_gcm_set_key(struct internal_aes_gcm_state *state,
+			      const struct internal_aes_gcm_key *enc_key)
+{
+	uint8_t h[TEE_AES_BLOCK_SIZE];
+	uint64_t k[2];
+#ifdef ARM64
+	size_t n;
+#endif
+
+	internal_aes_gcm_encrypt_block(enc_key, state->ctr, h);
+	hash_subkey_to_le(k, h);
 	memcpy(state->hash_subkey, k, TEE_AES_BLOCK_SIZE);
+
+#ifdef ARM64
+	/*
+	 * Precompute H^2, H^3 and H^4 for the four blocks at a time
+	 * payload functions. hash_state is still zero here so hashing the
+	 * block H^n gives H^(n+1).
+	 */
+	for (n = 0; n < ARRAY_SIZE(state->hash_subkey_pow); n++) {
+		internal_aes_gcm_ghash_update(state, h, NULL, 0);
+		memcpy(h, state->hash_state, sizeof(h));
+		memset(state->hash_state, 0, sizeof(state->hash_state));
+		hash_subkey_to_le(state->hash_subkey_pow[n], h);
+	}
+#endif
 }
 
 void internal_aes_gcm_ghash_update(struct internal_aes_gcm_state *state,
@@ -146,31 +168,80 @@ void internal_aes_gcm_encrypt_block(const struct internal_aes_gcm_key *ek,
 	thread_kernel_disable_vfp(vfp_state);
 }
 
+static void dec_ctr(uint64_t ctr[2])
+{
+	if (!ctr[0]--)
+		ctr[1]--;
+}
+
+static void inc_ctr(uint64_t ctr[2])
+{
+	if (!++ctr[0])
+		ctr[1]++;
+}
+
 void internal_aes_gcm_update_payload_block_aligned(
 				struct internal_aes_gcm_state *state,
 				const struct internal_aes_gcm_key *ek,
 				TEE_OperationMode mode, const void *src,
 				size_t num_blocks, void *dst)
 {
+	size_t n4 = ROUNDDOWN(num_blocks, 4);
+	const uint8_t *s = src;
+	uint8_t *d = dst;
 	uint32_t vfp_state;
 	uint64_t dg[2];
 	uint64_t ctr[2];
+	uint64_t *kpow;
 	uint64_t *k;
 
 	get_be_block(dg, state->hash_state);
 	get_be_block(ctr, state->ctr);
 
 	k = (void *)state->hash_subkey;
+	kpow = state->hash_subkey_pow[0];
 
 	vfp_state = thread_kernel_enable_vfp();
 
 	pmull_gcm_load_round_keys(ek->data, ek->rounds);
 
-	if (mode == TEE_MODE_ENCRYPT)
-		pmull_gcm_encrypt(num_blocks, dg, dst, src, k, ctr, ek->rounds,
-				  state->buf_cryp);
-	else
-		pmull_gcm_decrypt(num_blocks, dg, dst, src, k, ctr, ek->rounds);
+	/*
+	 * Process as much as possible four blocks at a time, the AES
+	 * rounds of the four blocks are interleaved and the GHASH
+	 * multiplications share a single reduction.
+	 */
+	if (n4) {
+		if (mode == TEE_MODE_ENCRYPT) {
+			/*
+			 * state->buf_cryp holds the key stream for the
+			 * block before state->ctr, step back one counter
+			 * and compute a new key stream block afterwards
+			 * for the remaining blocks.
+			 */
+			dec_ctr(ctr);
+			pmull_gcm_encrypt_4x(n4, dg, d, s, k, ctr, ek->rounds,
+					     kpow);
+			put_be_block(state->buf_cryp, ctr);
+			pmull_gcm_encrypt_block(state->buf_cryp,
+						state->buf_cryp, ek->rounds);
+			inc_ctr(ctr);
+		} else {
+			pmull_gcm_decrypt_4x(n4, dg, d, s, k, ctr, ek->rounds,
+					     kpow);
+		}
+		num_blocks -= n4;
+		s += n4 * TEE_AES_BLOCK_SIZE;
+		d += n4 * TEE_AES_BLOCK_SIZE;
+	}
+
+	if (num_blocks) {
+		if (mode == TEE_MODE_ENCRYPT)
+			pmull_gcm_encrypt(num_blocks, dg, d, s, k, ctr,
+					  ek->rounds, state->buf_cryp);
+		else
+			pmull_gcm_decrypt(num_blocks, dg, d, s, k, ctr,
+					  ek->rounds);
+	}
 
 	thread_kernel_disable_vfp(vfp_state);
 
@@ -24,6 +24,19 @@ void pmull_gcm_decrypt(int blocks, uint64_t dg[2], uint8_t dst[],
 		       const uint8_t src[], const uint64_t k[2],
 		       uint64_t ctr[], int rounds);
 
+/*
+ * Four blocks at a time variants of the functions above, @blocks must be
+ * a non-zero multiple of 4 and @kpow holds H^2, H^3 and H^4 in the same
+ * format as @k. Unlike pmull_gcm_encrypt() the first block is encrypted
+ * with @ctr, not with a previously computed key stream block.
+ */
+void pmull_gcm_encrypt_4x(int blocks, uint64_t dg[2], uint8_t dst[],
+			  const uint8_t src[], const uint64_t k[2],
+			  uint64_t ctr[], int rounds, const uint64_t kpow[6]);
+void pmull_gcm_decrypt_4x(int blocks, uint64_t dg[2], uint8_t dst[],
+			  const uint8_t src[], const uint64_t k[2],
+			  uint64_t ctr[], int rounds, const uint64_t kpow[6]);
+
 uint32_t pmull_gcm_aes_sub(uint32_t input);
 
 void pmull_gcm_encrypt_block(uint8_t dst[], const uint8_t src[], int rounds);
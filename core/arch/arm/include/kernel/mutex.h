@@ -23,15 +23,47 @@ struct mutex {
 	struct wait_queue wq;
 	short state;		/* -1: write, 0: unlocked, > 0: readers */
 	short owner_id;		/* Only valid for state == -1 (write lock) */
+	short write_waiters;	/* Sleeping writers, new readers must wait */
 };
 #define MUTEX_INITIALIZER \
 	{ .owner_id = MUTEX_OWNER_ID_NONE, .wq = WAIT_QUEUE_INITIALIZER, }
 
 TAILQ_HEAD(mutex_head, mutex);
 
+#ifdef CFG_WITH_STATS
+#define MUTEX_STATS_NUM_TOP	4
+
+/*
+ * struct mutex_stats - contention statistics of all mutexes
+ * @contended:	lock attempts which found the mutex locked
+ * @spun:	contended lock attempts which got the mutex while spinning
+ * @sleeps:	times a thread slept in normal world waiting for a mutex
+ * @top:	the mutexes causing the most sleeps, approximated as a mutex
+ *		is replaced by another once all entries are used
+ */
+struct mutex_stats {
+	uint32_t contended;
+	uint32_t spun;
+	uint32_t sleeps;
+	struct {
+		vaddr_t va;
+		uint32_t sleeps;
+	} top[MUTEX_STATS_NUM_TOP];
+};
+
+void mutex_get_stats(struct mutex_stats *stats, bool reset);
+#endif /*CFG_WITH_STATS*/
+
 void mutex_init(struct mutex *m);
 void mutex_destroy(struct mutex *m);
 
+/*
+ * Waiting writers have precedence over new readers: while a writer sleeps
+ * waiting for the mutex, mutex_read_trylock() fails and mutex_read_lock()
+ * blocks even if the mutex is only read locked. Consequently a thread
+ * already holding a read lock must not read lock the same mutex again, it
+ * deadlocks if a writer started waiting in between.
+ */
 #ifdef CFG_MUTEX_DEBUG
 void mutex_unlock_debug(struct mutex *m, const char *fname, int lineno);
 #define mutex_unlock(m) mutex_unlock_debug((m), __FILE__, __LINE__)
@@ -38,6 +38,17 @@ struct pseudo_ta_head {
 	TEE_Result (*invoke_command_entry_point)(void *pSessionContext,
 			uint32_t nCommandID, uint32_t nParamTypes,
 			TEE_Param pParams[TEE_NUM_PARAMS]);
+	/*
+	 * Optional, invoked by OPTEE_SMC_CALL_PTA_FAST with two
+	 * TEE_PARAM_TYPE_VALUE_INOUT parameters. There's no session and
+	 * no thread, all exceptions are masked and the entry point may be
+	 * called concurrently on several CPUs. It must not block, do RPC
+	 * or rely on create_entry_point() having been called. Commands
+	 * which can't be served this way return TEE_ERROR_NOT_SUPPORTED.
+	 */
+	TEE_Result (*fast_invoke_command_entry_point)(uint32_t nCommandID,
+			uint32_t nParamTypes,
+			TEE_Param pParams[TEE_NUM_PARAMS]);
 };
 
 #define pseudo_ta_register(...)	\
@@ -60,5 +71,28 @@ static inline struct pseudo_ta_ctx *to_pseudo_ta_ctx(struct tee_ta_ctx *ctx)
 TEE_Result tee_ta_init_pseudo_ta_session(const TEE_UUID *uuid,
 			struct tee_ta_session *s);
 
+/*
+ * pseudo_ta_get_fast_handle() - get handle for pseudo_ta_fast_invoke()
+ * @uuid:	UUID of the pseudo TA
+ * @handle:	returned handle
+ *
+ * Returns TEE_SUCCESS on success, TEE_ERROR_ITEM_NOT_FOUND if there's no
+ * such pseudo TA or TEE_ERROR_NOT_SUPPORTED if the pseudo TA has no fast
+ * invoke entry point.
+ */
+TEE_Result pseudo_ta_get_fast_handle(const TEE_UUID *uuid, uint32_t *handle);
+
+/*
+ * pseudo_ta_fast_invoke() - invoke the fast entry point of a pseudo TA
+ * @handle:	handle from pseudo_ta_get_fast_handle()
+ * @cmd:	command ID
+ * @params:	two value parameters
+ *
+ * Returns TEE_ERROR_BAD_PARAMETERS if @handle is invalid, else the result
+ * of the fast invoke entry point.
+ */
+TEE_Result pseudo_ta_fast_invoke(uint32_t handle, uint32_t cmd,
+				 TEE_Param params[TEE_NUM_PARAMS]);
+
 #endif /* KERNEL_PSEUDO_TA_H */
 
@@ -294,6 +294,13 @@ int thread_get_id(void);
  */
 int thread_get_id_may_fail(void);
 
+/*
+ * Returns true if the thread is executing on a CPU, that is, it's neither
+ * free nor suspended waiting for normal world. Only a hint as the state
+ * may change at any time unless it's the current thread.
+ */
+bool thread_is_active(int thread_id);
+
 /* Returns Thread Specific Data (TSD) pointer. */
 struct thread_specific_data *thread_get_tsd(void);
 
@@ -94,6 +94,68 @@ static inline TEE_Result tee_ta_init_user_ta_session(
 }
 #endif
 
+#ifdef CFG_TA_IMAGE_CACHE
+/*
+ * Drops the cached copy of a TA image, if any, so the TA is read from its
+ * store next time it's loaded. Used when a TA is updated.
+ */
+void ta_image_cache_invalidate(const TEE_UUID *uuid);
+
+/*
+ * Loads and verifies a TA image into the cache, where it's kept until
+ * released with ta_image_cache_release(). Needs tee-supplicant when the
+ * TA isn't cached yet and is read from the REE FS or secure storage, an
+ * image which is already cached is only pinned. Preloading an image
+ * several times pins it as many times. Returns TEE_ERROR_OUT_OF_MEMORY
+ * if the image doesn't fit in the part of the cache which can be pinned.
+ */
+TEE_Result ta_image_cache_preload(const TEE_UUID *uuid);
+
+/*
+ * Drops one pin of a preloaded TA image, once all pins are dropped the
+ * image can be evicted from the cache again
+ */
+TEE_Result ta_image_cache_release(const TEE_UUID *uuid);
+
+/*
+ * Reports how many times a cached TA image is pinned and how many times
+ * it has been read from the cache. Returns TEE_ERROR_ITEM_NOT_FOUND if
+ * the TA isn't cached.
+ */
+TEE_Result ta_image_cache_get_info(const TEE_UUID *uuid,
+				   unsigned int *pin_count,
+				   unsigned int *num_hits);
+
+/* Evicts all cached images which are neither pinned nor being read */
+void ta_image_cache_flush(void);
+#else
+static inline void ta_image_cache_invalidate(const TEE_UUID *uuid __unused)
+{
+}
+
+static inline TEE_Result ta_image_cache_preload(const TEE_UUID *uuid __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+
+static inline TEE_Result ta_image_cache_release(const TEE_UUID *uuid __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+
+static inline TEE_Result
+ta_image_cache_get_info(const TEE_UUID *uuid __unused,
+			unsigned int *pin_count __unused,
+			unsigned int *num_hits __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+
+static inline void ta_image_cache_flush(void)
+{
+}
+#endif
+
 /*
  * Registers a TA storage.
  *
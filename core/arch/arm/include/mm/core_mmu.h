@@ -513,6 +513,19 @@ static inline bool core_mmu_is_dynamic_vaspace(struct tee_mmap_region *mm)
 TEE_Result core_mmu_map_pages(vaddr_t vstart, paddr_t *pages, size_t num_pages,
 			      enum teecore_memtypes memtype);
 
+/*
+ * core_mmu_map_contiguous() - map physically contiguous pages at given
+ *  virtual address, using pgdir level block entries where possible
+ * @vstart:	Virtual address where mapping begins
+ * @pstart:	Physical address of the first page
+ * @num_pages:	Number of pages
+ * @memtype:	Type of memory to be mapped
+ * @returns:	TEE_SUCCESS on success, TEE_ERROR_XXX on error
+ */
+TEE_Result core_mmu_map_contiguous(vaddr_t vstart, paddr_t pstart,
+				   size_t num_pages,
+				   enum teecore_memtypes memtype);
+
 /*
  * core_mmu_unmap_pages() - remove mapping at given virtual address
  * @vstart:	Virtual address where mapping begins
@@ -124,6 +124,31 @@ struct mobj *mobj_phys_alloc(paddr_t pa, size_t size, uint32_t cattr,
 struct mobj *mobj_reg_shm_alloc(paddr_t *pages, size_t num_pages,
 				paddr_t page_offset, uint64_t cookie);
 
+/*
+ * struct mobj_reg_shm_run - physically contiguous pages of a reg_shm
+ * @pa:		Physical address of the first page
+ * @num_pages:	Number of pages
+ */
+struct mobj_reg_shm_run {
+	paddr_t pa;
+	size_t num_pages;
+};
+
+/**
+ * mobj_reg_shm_alloc_runs() - allocate a reg_shm from contiguous runs
+ * @runs:	Array of runs of pages, in buffer order
+ * @num_runs:	Number of runs in @runs
+ * @page_offset: Offset of the buffer into the first page
+ * @cookie:	Cookie identifying the buffer
+ *
+ * Same as mobj_reg_shm_alloc(), but avoids describing each page of a
+ * large buffer individually.
+ * Returns a valid pointer on success or NULL on failure.
+ */
+struct mobj *mobj_reg_shm_alloc_runs(const struct mobj_reg_shm_run *runs,
+				     size_t num_runs, paddr_t page_offset,
+				     uint64_t cookie);
+
 /**
  * mobj_reg_shm_get_by_cookie() - get a MOBJ based on cookie
  * @cookie:	Cookie used by normal world when suppling the shared memory
@@ -171,6 +196,17 @@ TEE_Result mobj_reg_shm_inc_map(struct mobj *mobj);
  */
 TEE_Result mobj_reg_shm_dec_map(struct mobj *mobj);
 
+/**
+ * mobj_reg_shm_get() - get a reference to a reg_shm
+ * @mobj:	pointer to a MOBJ, the caller must hold a reference
+ *
+ * Increases the reference counter of @mobj if it's a registered shared
+ * memory MOBJ. The reference is put with mobj_reg_shm_put().
+ *
+ * Returns @mobj or NULL if @mobj isn't a registered shared memory MOBJ.
+ */
+struct mobj *mobj_reg_shm_get(struct mobj *mobj);
+
 /**
  * mobj_reg_shm_unguard() - unguards a reg_shm
  * @mobj:	pointer to a registered shared memory mobj
@@ -18,11 +18,21 @@
 #include <types_ext.h>
 #include <util.h>
 
+/*
+ * struct pgt - translation table for a user TA context
+ * @tbl:		the translation table
+ * @vabase:		virtual address mapped by the first entry of @tbl
+ * @ctx:		context owning the table, NULL if unused
+ * @populated:		all unpaged regions of @ctx within the range of @tbl
+ *			that are marked as mapped have valid entries in @tbl
+ * @num_used_entries:	number of entries used by the pager
+ */
 struct pgt {
 	void *tbl;
-#if defined(CFG_PAGED_USER_TA)
 	vaddr_t vabase;
 	struct tee_ta_ctx *ctx;
+	bool populated;
+#if defined(CFG_PAGED_USER_TA)
 	size_t num_used_entries;
 #endif
 #if defined(CFG_WITH_PAGER)
@@ -44,6 +54,18 @@ struct pgt {
 
 SLIST_HEAD(pgt_cache, pgt);
 
+/*
+ * struct pgt_cache_stats - statistics of the translation table cache
+ * @hits:	tables found in the cache with the content of a previous use
+ * @misses:	tables that had to be taken from the free list or recycled
+ * @evictions:	cached tables recycled for another context or address
+ */
+struct pgt_cache_stats {
+	uint32_t hits;
+	uint32_t misses;
+	uint32_t evictions;
+};
+
 static inline bool pgt_check_avail(size_t num_tbls)
 {
 	return num_tbls <= PGT_CACHE_SIZE;
@@ -53,26 +75,33 @@ void pgt_alloc(struct pgt_cache *pgt_cache, void *owning_ctx,
 	       vaddr_t begin, vaddr_t last);
 void pgt_free(struct pgt_cache *pgt_cache, bool save_ctx);
 
-#ifdef CFG_PAGED_USER_TA
 void pgt_flush_ctx_range(struct pgt_cache *pgt_cache, void *ctx,
 			 vaddr_t begin, vaddr_t last);
-#else
-static inline void pgt_flush_ctx_range(struct pgt_cache *pgt_cache __unused,
-				       void *ctx __unused,
-				       vaddr_t begin __unused,
-				       vaddr_t last __unused)
-{
-}
-#endif
+
+/*
+ * pgt_clear_ctx_range() - Clears the entries of a range of an unpaged
+ * region in all tables of a context
+ * @pgt_cache:	tables of the current context or NULL if @ctx isn't current
+ * @ctx:	the context
+ * @begin:	first address of the range
+ * @last:	last address of the range
+ *
+ * Used when an unpaged region is removed or changed, the tables keep their
+ * content while cached so stale entries have to be cleared.
+ */
+void pgt_clear_ctx_range(struct pgt_cache *pgt_cache, void *ctx,
+			 vaddr_t begin, vaddr_t last);
+
+void pgt_get_cache_stats(struct pgt_cache_stats *stats, bool reset);
 
 void pgt_transfer(struct pgt_cache *pgt_cache, void *old_ctx, vaddr_t old_va,
 		  void *new_ctx, vaddr_t new_va, size_t size);
 
 void pgt_init(void);
 
-#if defined(CFG_PAGED_USER_TA)
 void pgt_flush_ctx(struct tee_ta_ctx *ctx);
 
+#if defined(CFG_PAGED_USER_TA)
 static inline void pgt_inc_used_entries(struct pgt *pgt)
 {
 	pgt->num_used_entries++;
@@ -89,10 +118,6 @@ static inline void pgt_set_used_entries(struct pgt *pgt, size_t val)
 }
 
 #else
-static inline void pgt_flush_ctx(struct tee_ta_ctx *ctx __unused)
-{
-}
-
 static inline void pgt_inc_used_entries(struct pgt *pgt __unused)
 {
 }
@@ -133,6 +133,34 @@ static inline bool tee_pager_set_uta_area_attr(struct user_ta_ctx *utc __unused,
 }
 #endif
 
+/*
+ * tee_pager_set_uta_area_init() - Set initial content of a user ta area
+ * @utc:	user ta context of the area
+ * @base:	base of the initialized range, need not be page aligned
+ * @size:	size of the initialized range
+ * @init:	content of the range, must remain available as long as
+ *		the area exists
+ *
+ * Pages covering the range are populated from @init instead of being
+ * zero initialized the first time they're accessed, bytes outside the
+ * range are still zero. Must be called before any page covering the
+ * range has been accessed. Only one range per area is supported.
+ *
+ * Return true on success or false if the range can't be assigned
+ */
+#ifdef CFG_PAGED_USER_TA
+bool tee_pager_set_uta_area_init(struct user_ta_ctx *utc, vaddr_t base,
+				 size_t size, const void *init);
+#else
+static inline bool tee_pager_set_uta_area_init(struct user_ta_ctx *utc __unused,
+					       vaddr_t base __unused,
+					       size_t size __unused,
+					       const void *init __unused)
+{
+	return false;
+}
+#endif
+
 void tee_pager_transfer_uta_region(struct user_ta_ctx *src_utc,
 				   vaddr_t src_base,
 				   struct user_ta_ctx *dst_utc,
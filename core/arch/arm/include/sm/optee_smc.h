@@ -256,7 +256,9 @@
  * Normal return register usage:
  * a0	OPTEE_SMC_RETURN_OK
  * a1	bitfield of secure world capabilities OPTEE_SMC_SEC_CAP_*
- * a2-7	Preserved
+ * a2	The highest asynchronous notification value if
+ *	OPTEE_SMC_SEC_CAP_ASYNC_NOTIF is set, else preserved
+ * a3-7	Preserved
  *
  * Error return register usage:
  * a0	OPTEE_SMC_RETURN_ENOTAVAIL, can't use the capabilities from normal world
@@ -275,6 +277,14 @@
  * secure world accepts command buffers located in any parts of non-secure RAM
  */
 #define OPTEE_SMC_SEC_CAP_DYNAMIC_SHM		(1 << 2)
+/* Secure world supports OPTEE_MSG_CMD_INVOKE_BATCH */
+#define OPTEE_SMC_SEC_CAP_INVOKE_BATCH		(1 << 3)
+/* Secure world supports OPTEE_SMC_CALL_PTA_FAST */
+#define OPTEE_SMC_SEC_CAP_PTA_FAST_CALL		(1 << 4)
+/* Secure world supports asynchronous notifications to normal world */
+#define OPTEE_SMC_SEC_CAP_ASYNC_NOTIF		(1 << 5)
+/* Secure world accepts OPTEE_MSG_NONCONTIG_RUN_MASK in page lists */
+#define OPTEE_SMC_SEC_CAP_NONCONTIG_RUNS	(1 << 6)
 
 #define OPTEE_SMC_FUNCID_EXCHANGE_CAPABILITIES	9
 #define OPTEE_SMC_EXCHANGE_CAPABILITIES \
@@ -422,6 +432,119 @@
 #define OPTEE_SMC_VM_DESTROYED \
 	OPTEE_SMC_FAST_CALL_VAL(OPTEE_SMC_FUNCID_VM_DESTROYED)
 
+/*
+ * Get a handle to invoke a pseudo TA with OPTEE_SMC_CALL_PTA_FAST
+ *
+ * Only pseudo TAs providing a fast invoke entry point can be invoked
+ * with a fast call. The handle stays valid as long as secure world is
+ * running.
+ *
+ * Call register usage:
+ * a0	SMC Function ID, OPTEE_SMC_GET_PTA_FAST_HANDLE
+ * a1-4	UUID of the pseudo TA in the same way as OPTEE_MSG_OS_OPTEE_UUID_*
+ * a5-6	Not used
+ * a7	Hypervisor Client ID register
+ *
+ * Normal return register usage:
+ * a0	OPTEE_SMC_RETURN_OK
+ * a1	Handle of the pseudo TA
+ * a2-7	Preserved
+ *
+ * Not available register usage:
+ * a0	OPTEE_SMC_RETURN_ENOTAVAIL, no such pseudo TA or the pseudo TA
+ *	can't be invoked with a fast call
+ * a1-7	Preserved
+ */
+#define OPTEE_SMC_FUNCID_GET_PTA_FAST_HANDLE	15
+#define OPTEE_SMC_GET_PTA_FAST_HANDLE \
+	OPTEE_SMC_FAST_CALL_VAL(OPTEE_SMC_FUNCID_GET_PTA_FAST_HANDLE)
+
+/*
+ * Invoke a command in a pseudo TA with a fast call
+ *
+ * The command is invoked without a session and without a thread, only
+ * two value parameters are passed, both as TEE_PARAM_TYPE_VALUE_INOUT.
+ * The pseudo TA returns TEE_ERROR_NOT_SUPPORTED for commands that can't
+ * be served this way, those have to be invoked with
+ * OPTEE_MSG_CMD_INVOKE_COMMAND as usual.
+ *
+ * Call register usage:
+ * a0	SMC Function ID, OPTEE_SMC_CALL_PTA_FAST
+ * a1	Handle from OPTEE_SMC_GET_PTA_FAST_HANDLE
+ * a2	Command ID
+ * a3-4	Value a and b of the first parameter
+ * a5-6	Value a and b of the second parameter
+ * a7	Hypervisor Client ID register
+ *
+ * Normal return register usage:
+ * a0	OPTEE_SMC_RETURN_OK
+ * a1	TEE_Result returned by the pseudo TA, TEE_ERROR_BAD_PARAMETERS if
+ *	the handle is invalid
+ * a2-3	Value a and b of the first parameter
+ * a4-5	Value a and b of the second parameter
+ * a6-7	Preserved
+ */
+#define OPTEE_SMC_FUNCID_CALL_PTA_FAST	16
+#define OPTEE_SMC_CALL_PTA_FAST \
+	OPTEE_SMC_FAST_CALL_VAL(OPTEE_SMC_FUNCID_CALL_PTA_FAST)
+
+/*
+ * Retrieve a value of asynchronous notifications from secure world
+ *
+ * Secure world raises the notification interrupt in normal world when a
+ * value becomes pending, normal world is expected to retrieve values with
+ * this call until OPTEE_SMC_ASYNC_NOTIF_PENDING is cleared. Values below
+ * 32 tell that the wait queue key with the same value is to be woken up
+ * as with OPTEE_RPC_WAIT_QUEUE_WAKEUP, the other values are allocated by
+ * secure world services, for instance Trusted Applications, which tell
+ * their normal world clients about the value by other means.
+ *
+ * Call register usage:
+ * a0	SMC Function ID, OPTEE_SMC_GET_ASYNC_NOTIF_VALUE
+ * a1-6	Not used
+ * a7	Hypervisor Client ID register
+ *
+ * Normal return register usage:
+ * a0	OPTEE_SMC_RETURN_OK
+ * a1	value
+ * a2	Bit[0]: OPTEE_SMC_ASYNC_NOTIF_VALID if a1 holds a value
+ *	Bit[1]: OPTEE_SMC_ASYNC_NOTIF_PENDING if more values are pending
+ * a3-7	Preserved
+ *
+ * Not supported return register usage:
+ * a0	OPTEE_SMC_RETURN_UNKNOWN_FUNCTION
+ * a1-7	Preserved
+ */
+#define OPTEE_SMC_ASYNC_NOTIF_VALID		(1 << 0)
+#define OPTEE_SMC_ASYNC_NOTIF_PENDING		(1 << 1)
+#define OPTEE_SMC_FUNCID_GET_ASYNC_NOTIF_VALUE	17
+#define OPTEE_SMC_GET_ASYNC_NOTIF_VALUE \
+	OPTEE_SMC_FAST_CALL_VAL(OPTEE_SMC_FUNCID_GET_ASYNC_NOTIF_VALUE)
+
+/*
+ * Enable asynchronous notifications from secure world
+ *
+ * Tells secure world that normal world has installed a handler for the
+ * notification interrupt. Until then secure world only records pending
+ * values and uses RPC to wake up wait queue keys.
+ *
+ * Call register usage:
+ * a0	SMC Function ID, OPTEE_SMC_ENABLE_ASYNC_NOTIF
+ * a1-6	Not used
+ * a7	Hypervisor Client ID register
+ *
+ * Normal return register usage:
+ * a0	OPTEE_SMC_RETURN_OK
+ * a1-7	Preserved
+ *
+ * Not supported return register usage:
+ * a0	OPTEE_SMC_RETURN_UNKNOWN_FUNCTION
+ * a1-7	Preserved
+ */
+#define OPTEE_SMC_FUNCID_ENABLE_ASYNC_NOTIF	18
+#define OPTEE_SMC_ENABLE_ASYNC_NOTIF \
+	OPTEE_SMC_FAST_CALL_VAL(OPTEE_SMC_FUNCID_ENABLE_ASYNC_NOTIF)
+
 /*
  * Resume from RPC (for example after processing a foreign interrupt)
  *
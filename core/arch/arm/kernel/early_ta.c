@@ -18,8 +18,15 @@ struct user_ta_store_handle {
 	const struct early_ta *early_ta;
 	size_t offs;
 	z_stream strm;
+	uint8_t *discard_buf;
 };
 
+/*
+ * Large enough for inflate() to use inflate_fast() when skipping data,
+ * it needs at least 258 bytes of output space.
+ */
+#define DISCARD_BUF_SIZE	4096
+
 #define for_each_early_ta(_ta) \
 	for (_ta = &__rodata_early_ta_start; _ta < &__rodata_early_ta_end; \
 	     _ta = (const struct early_ta *)				   \
@@ -126,30 +133,38 @@ static TEE_Result read_compressed(struct user_ta_store_handle *h, void *data,
 {
 	z_stream *strm = &h->strm;
 	size_t total = 0;
-	uint8_t *tmpbuf = NULL;
-	TEE_Result ret;
 	size_t out;
-	int st;
+	int flush;
+	int st = Z_OK;
 
-	if (data) {
-		strm->next_out = data;
-		strm->avail_out = len;
-	} else {
+	if (h->offs + len > h->early_ta->uncompressed_size)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (!data && !h->discard_buf) {
 		/*
-		 * inflate() does not support a NULL strm->next_out. So, to
-		 * discard data, we have to allocate a temporary buffer. 1K
-		 * seems reasonable.
+		 * inflate() does not support a NULL strm->next_out, so data
+		 * to be discarded is inflated into a buffer kept until the
+		 * handle is closed.
 		 */
-		strm->avail_out = MIN(len, 1024U);
-		tmpbuf = malloc(strm->avail_out);
-		if (!tmpbuf) {
+		h->discard_buf = malloc(DISCARD_BUF_SIZE);
+		if (!h->discard_buf) {
 			EMSG("Out of memory");
 			return TEE_ERROR_OUT_OF_MEMORY;
 		}
-		strm->next_out = tmpbuf;
 	}
+
+	/*
+	 * When the last read completes the stream inflate() doesn't have to
+	 * update its sliding window with the output.
+	 */
+	if (h->offs + len == h->early_ta->uncompressed_size)
+		flush = Z_FINISH;
+	else
+		flush = Z_NO_FLUSH;
+
 	/*
-	 * Loop until we get as many bytes as requested, or an error occurs.
+	 * Data is inflated straight into the destination in as few calls as
+	 * possible, large output buffers let inflate() use inflate_fast().
 	 * inflate() returns:
 	 * - Z_OK when progress was made, but neither the end of the input
 	 *   stream nor the end of the output buffer were met.
@@ -158,31 +173,30 @@ static TEE_Result read_compressed(struct user_ta_store_handle *h, void *data,
 	 *   buffer is full (not a "hard" error, decompression can proceeed
 	 *   later).
 	 */
-	do {
+	while (total < len) {
+		if (data) {
+			strm->next_out = (uint8_t *)data + total;
+			strm->avail_out = len - total;
+		} else {
+			strm->next_out = h->discard_buf;
+			strm->avail_out = MIN(len - total,
+					      (size_t)DISCARD_BUF_SIZE);
+		}
 		out = strm->total_out;
-		st = inflate(strm, Z_SYNC_FLUSH);
+		st = inflate(strm, flush);
 		out = strm->total_out - out;
 		total += out;
 		FMSG("%zu bytes", out);
-		if (!data) {
-			/*
-			 * Reset the pointer to throw away what we've just read
-			 * and read again as much as possible.
-			 */
-			strm->next_out = tmpbuf;
-			strm->avail_out = MIN(len - total, 1024U);
-		}
-	} while ((st == Z_OK || st == Z_BUF_ERROR) && (total != len));
-	if (st != Z_OK && st != Z_STREAM_END) {
+		if (st != Z_OK && (st != Z_BUF_ERROR || !out))
+			break;
+	}
+	if (total != len) {
 		EMSG("Decompression error (%d)", st);
-		ret = TEE_ERROR_GENERIC;
-		goto out;
+		return TEE_ERROR_GENERIC;
 	}
-	ret = TEE_SUCCESS;
-out:
-	free(tmpbuf);
+	h->offs += len;
 
-	return ret;
+	return TEE_SUCCESS;
 }
 
 static TEE_Result early_ta_read(struct user_ta_store_handle *h, void *data,
@@ -198,6 +212,7 @@ static void early_ta_close(struct user_ta_store_handle *h)
 {
 	if (h->early_ta->uncompressed_size)
 		inflateEnd(&h->strm);
+	free(h->discard_buf);
 	free(h);
 }
 
@@ -7,6 +7,7 @@
 #include <tee_api_defines.h>
 #include <kernel/tee_misc.h>
 #include <kernel/user_ta.h>
+#include <mm/tee_pager.h>
 #include <stdlib.h>
 #include <string.h>
 #include <util.h>
@@ -544,6 +545,47 @@ static TEE_Result e64_process_rel(struct elf_load_state *state __unused,
 }
 #endif /*ARM64*/
 
+void elf_load_set_image(struct elf_load_state *state, const void *image,
+			struct user_ta_ctx *utc)
+{
+	state->image = image;
+	state->utc = utc;
+}
+
+#ifdef CFG_PAGED_USER_TA
+/*
+ * Read-only segments are left to the pager to populate from the verified
+ * image when first accessed. Writable segments are copied as usual since
+ * they're likely to be modified by relocations anyway.
+ */
+static bool load_seg_on_demand(struct elf_load_state *state,
+			       struct elf_phdr *phdr, uint8_t *dst,
+			       size_t offs)
+{
+	size_t end;
+
+	if (!state->image || (phdr->p_flags & PF_W) || offs > phdr->p_filesz)
+		return false;
+	if (ADD_OVERFLOW(phdr->p_offset, phdr->p_filesz, &end) ||
+	    end > state->data_len ||
+	    ADD_OVERFLOW(phdr->p_vaddr, phdr->p_filesz, &end) ||
+	    end > state->vasize)
+		return false;
+
+	return tee_pager_set_uta_area_init(state->utc,
+					   (vaddr_t)dst + phdr->p_vaddr + offs,
+					   phdr->p_filesz - offs,
+					   state->image + phdr->p_offset + offs);
+}
+#else
+static bool load_seg_on_demand(struct elf_load_state *state __unused,
+			       struct elf_phdr *phdr __unused,
+			       uint8_t *dst __unused, size_t offs __unused)
+{
+	return false;
+}
+#endif
+
 TEE_Result elf_load_body(struct elf_load_state *state, vaddr_t vabase)
 {
 	TEE_Result res;
@@ -553,10 +595,35 @@ TEE_Result elf_load_body(struct elf_load_state *state, vaddr_t vabase)
 	struct elf_ehdr ehdr;
 	size_t offs = 0;
 	size_t e_p_hdr_sz;
+	size_t hdr_sz;
+	uint32_t on_demand = 0;
+	const size_t max_on_demand = sizeof(on_demand) * 8;
 
 	copy_ehdr(&ehdr, state);
 	e_p_hdr_sz = ehdr.e_phoff + ehdr.e_phnum * ehdr.e_phentsize;
 
+	/*
+	 * Segments populated on demand must be registered before anything
+	 * is written to the pages they may share with other segments.
+	 */
+	offs = state->ta_head_size;
+	hdr_sz = e_p_hdr_sz;
+	for (n = 0; n < ehdr.e_phnum && n < max_on_demand; n++) {
+		struct elf_phdr phdr;
+
+		copy_phdr(&phdr, state, n);
+		if (phdr.p_type != PT_LOAD)
+			continue;
+		if (phdr.p_offset < hdr_sz) {
+			offs += hdr_sz;
+			hdr_sz = 0;
+		}
+		if (load_seg_on_demand(state, &phdr, dst, offs))
+			on_demand |= BIT(n);
+		offs = 0;
+	}
+	offs = 0;
+
 	/*
 	 * Copy the segments
 	 */
@@ -590,6 +657,10 @@ TEE_Result elf_load_body(struct elf_load_state *state, vaddr_t vabase)
 			offs += e_p_hdr_sz;
 			e_p_hdr_sz = 0;
 		}
+		if (n < max_on_demand && (on_demand & BIT(n))) {
+			offs = 0;
+			continue;
+		}
 		res = copy_to(state, dst, state->vasize,
 			      phdr.p_vaddr + offs,
 			      phdr.p_offset + offs,
@@ -10,6 +10,7 @@
 #include <tee_api_types.h>
 
 struct elf_load_state;
+struct user_ta_ctx;
 struct user_ta_elf_head;
 
 struct user_ta_store_handle;
@@ -47,6 +48,23 @@ struct user_ta_store_ops {
 	 * Close a TA handle. Do nothing if @h == NULL.
 	 */
 	void (*close)(struct user_ta_store_handle *h);
+	/*
+	 * Optional. Return a tag identifying the content of the TA binary,
+	 * such as the digest in the signed header, authenticated by open().
+	 * @tag_len is updated with the size of the tag, if @tag is too
+	 * small TEE_ERROR_SHORT_BUFFER is returned.
+	 */
+	TEE_Result (*get_tag)(const struct user_ta_store_handle *h,
+			      uint8_t *tag, size_t *tag_len);
+	/*
+	 * Optional. Return the complete TA binary, as delivered by read(),
+	 * verified and residing in secure memory. The binary remains
+	 * available after the handle is closed, until it's released with
+	 * put_image() using @cookie.
+	 */
+	TEE_Result (*get_image)(struct user_ta_store_handle *h,
+				const void **image, void **cookie);
+	void (*put_image)(void *cookie);
 };
 
 TEE_Result elf_load_init(const struct user_ta_store_ops *ta_store,
@@ -57,6 +75,8 @@ TEE_Result elf_load_init(const struct user_ta_store_ops *ta_store,
 			 struct elf_load_state **state);
 TEE_Result elf_load_head(struct elf_load_state *state, size_t head_size,
 			void **head, size_t *vasize, bool *is_32bit);
+void elf_load_set_image(struct elf_load_state *state, const void *image,
+			struct user_ta_ctx *utc);
 TEE_Result elf_load_body(struct elf_load_state *state, vaddr_t vabase);
 TEE_Result elf_load_get_next_segment(struct elf_load_state *state, size_t *idx,
 			vaddr_t *vaddr, size_t *size, uint32_t *flags,
@@ -8,17 +8,146 @@
 #include <types_ext.h>
 #include <tee_api_types.h>
 #include <tee_api_defines.h>
+#include <trace.h>
 #include <util.h>
 #include "elf_common.h"
 #include "elf_load_dyn.h"
 #include "elf_load_private.h"
 
+static size_t num_syms(struct elf_load_state *state)
+{
+	DO_ACTION(state, return state->dynsym_size / sizeof(Elf32_Sym),
+			 return state->dynsym_size / sizeof(Elf64_Sym));
+}
+
+static bool sym_matches(struct elf_load_state *state, size_t idx,
+			const char *name, struct elf_sym *sym)
+{
+	if (!copy_sym(sym, idx, state) || sym->st_shndx == SHN_UNDEF)
+		return false;
+	if (sym->st_name >= state->dynstr_size)
+		return false;
+	return !strncmp(name, &state->dynstr[sym->st_name],
+			state->dynstr_size - sym->st_name);
+}
+
+static uint32_t elf_hash(const char *name)
+{
+	const unsigned char *p = (const unsigned char *)name;
+	uint32_t h = 0;
+	uint32_t g;
+
+	while (*p) {
+		h = (h << 4) + *p++;
+		g = h & 0xf0000000;
+		if (g)
+			h ^= g >> 24;
+		h &= ~g;
+	}
+
+	return h;
+}
+
+static uint32_t gnu_hash(const char *name)
+{
+	const unsigned char *p = (const unsigned char *)name;
+	uint32_t h = 5381;
+
+	while (*p)
+		h = h * 33 + *p++;
+
+	return h;
+}
+
+/* Reads word @idx of the hash table, 0 if outside the table */
+static uint32_t hash_word(struct elf_load_state *state, size_t idx)
+{
+	const uint32_t *lower = state->hash;
+	const uint32_t *upper = state->hash +
+				state->hash_size / sizeof(uint32_t);
+	const uint32_t *item = state->hash + idx;
+
+	if (idx >= state->hash_size / sizeof(uint32_t))
+		return 0;
+	return load_no_speculate_fail(item, lower, upper, 0);
+}
+
+/* .hash: nbucket, nchain, bucket[nbucket], chain[nchain] */
+static TEE_Result lookup_hash(struct elf_load_state *state, const char *name,
+			      struct elf_sym *sym)
+{
+	uint32_t nbucket = hash_word(state, 0);
+	uint32_t nchain = hash_word(state, 1);
+	size_t chain = 2 + nbucket;
+	uint32_t idx = hash_word(state, 2 + elf_hash(name) % nbucket);
+	uint32_t n;
+
+	/* Bounded by nchain in case the chain loops */
+	for (n = 0; idx != STN_UNDEF && idx < nchain && n < nchain; n++) {
+		if (sym_matches(state, idx, name, sym))
+			return TEE_SUCCESS;
+		idx = hash_word(state, chain + idx);
+	}
+
+	return TEE_ERROR_ITEM_NOT_FOUND;
+}
+
+/*
+ * .gnu.hash: nbuckets, symoffset, bloom_size, bloom_shift,
+ * bloom[bloom_size] (of the ELF class word size), buckets[nbuckets],
+ * chain[] where chain[n] holds the hash of symbol symoffset + n, with
+ * the least significant bit set on the last symbol of a chain. The bloom
+ * filter isn't used.
+ */
+static TEE_Result lookup_gnu_hash(struct elf_load_state *state,
+				  const char *name, struct elf_sym *sym)
+{
+	uint32_t nbuckets = hash_word(state, 0);
+	uint32_t symoffset = hash_word(state, 1);
+	size_t bloom_words = hash_word(state, 2);
+	size_t nchain = num_syms(state) - symoffset;
+	uint32_t h = gnu_hash(name);
+	size_t buckets;
+	size_t chain;
+	uint32_t h2;
+	size_t idx;
+
+	DO_ACTION(state, bloom_words *= 1, bloom_words *= 2);
+	buckets = 4 + bloom_words;
+	chain = buckets + nbuckets;
+
+	idx = hash_word(state, buckets + h % nbuckets);
+	if (idx < symoffset)
+		return TEE_ERROR_ITEM_NOT_FOUND;
+
+	for (; idx - symoffset < nchain; idx++) {
+		h2 = hash_word(state, chain + idx - symoffset);
+		if ((h | 1) == (h2 | 1) && sym_matches(state, idx, name, sym))
+			return TEE_SUCCESS;
+		if (h2 & 1)
+			break;
+	}
+
+	return TEE_ERROR_ITEM_NOT_FOUND;
+}
+
 TEE_Result elf_resolve_symbol(struct elf_load_state *state,
 			      const char *name, uintptr_t *val)
 {
 	struct elf_sym sym;
+	TEE_Result res;
 	size_t n;
 
+	if (state->hash) {
+		if (state->gnu_hash)
+			res = lookup_gnu_hash(state, name, &sym);
+		else
+			res = lookup_hash(state, name, &sym);
+		if (!res)
+			*val = sym.st_value;
+		return res;
+	}
+
 	for (n = 0; copy_sym(&sym, n, state); n++) {
 		if (sym.st_shndx == SHN_UNDEF)
 			continue;
@@ -129,6 +258,90 @@ TEE_Result e64_process_dyn_rela(struct elf_load_state *state, Elf64_Rela *rel,
 }
 #endif
 
+/* Returns the number of bytes of the hash table at @addr, 0 if invalid */
+static size_t hash_table_size(struct elf_load_state *state, vaddr_t vabase,
+			      vaddr_t addr, bool is_gnu)
+{
+	const uint32_t *hash = (const uint32_t *)(vabase + addr);
+	size_t nsyms = num_syms(state);
+	size_t words = 0;
+	size_t bloom_words;
+	vaddr_t max;
+	size_t sz;
+
+	if ((addr & (sizeof(uint32_t) - 1)) || addr >= state->vasize ||
+	    state->vasize - addr < 4 * sizeof(uint32_t))
+		return 0;
+
+	if (is_gnu) {
+		/* nbuckets and symoffset */
+		if (!hash[0] || hash[1] > nsyms)
+			return 0;
+		bloom_words = hash[2];
+		DO_ACTION(state, bloom_words *= 1, bloom_words *= 2);
+		/* Header, bloom filter, buckets and chain */
+		if (ADD_OVERFLOW(4, bloom_words, &words) ||
+		    ADD_OVERFLOW(words, hash[0], &words) ||
+		    ADD_OVERFLOW(words, nsyms - hash[1], &words))
+			return 0;
+	} else {
+		/* nbucket and nchain */
+		if (!hash[0] || hash[1] > nsyms)
+			return 0;
+		if (ADD_OVERFLOW(2, hash[0], &words) ||
+		    ADD_OVERFLOW(words, hash[1], &words))
+			return 0;
+	}
+
+	if (MUL_OVERFLOW(words, sizeof(uint32_t), &sz) ||
+	    ADD_OVERFLOW(addr, sz, &max) || max > state->vasize)
+		return 0;
+
+	return sz;
+}
+
+/*
+ * Finds the .gnu.hash or .hash section to avoid scanning all symbols on
+ * each lookup. If there's no usable hash table symbols are looked up
+ * with a linear search instead.
+ */
+static void read_hash_table(struct elf_load_state *state, vaddr_t vabase)
+{
+	vaddr_t gnu_hash_addr = 0;
+	vaddr_t hash_addr = 0;
+	struct elf_dyn dyn;
+	size_t n;
+
+	for (n = 0; copy_dyn(&dyn, n, state); n++) {
+		if (dyn.d_tag == DT_GNU_HASH)
+			gnu_hash_addr = dyn.d_un.d_ptr;
+		else if (dyn.d_tag == DT_HASH)
+			hash_addr = dyn.d_un.d_ptr;
+	}
+
+	if (gnu_hash_addr) {
+		state->hash_size = hash_table_size(state, vabase,
+						   gnu_hash_addr, true);
+		if (state->hash_size) {
+			state->hash = (const uint32_t *)(vabase +
+							 gnu_hash_addr);
+			state->gnu_hash = true;
+			return;
+		}
+	}
+
+	if (hash_addr) {
+		state->hash_size = hash_table_size(state, vabase, hash_addr,
+						   false);
+		if (state->hash_size) {
+			state->hash = (const uint32_t *)(vabase + hash_addr);
+			return;
+		}
+	}
+
+	DMSG("No usable symbol hash table");
+}
+
 /* Check the dynamic segment and save info for later */
 static TEE_Result read_dyn_segment(struct elf_load_state *state,
 				   vaddr_t vabase)
@@ -185,6 +398,8 @@ static TEE_Result read_dyn_segment(struct elf_load_state *state,
 	state->dynsym = (void *)(vabase + dynsym);
 	state->dynsym_size = dynsym_size;
 
+	read_hash_table(state, vabase);
+
 	return TEE_SUCCESS;
 }
 
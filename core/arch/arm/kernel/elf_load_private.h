@@ -25,6 +25,10 @@ struct elf_load_state {
 
 	size_t next_offs;
 
+	/* Verified binary for segments populated on demand, if any */
+	const uint8_t *image;
+	struct user_ta_ctx *utc;
+
 	/* TA header info (is_main == true only) */
 	void *ta_head;
 	size_t ta_head_size;
@@ -47,6 +51,11 @@ struct elf_load_state {
 	void *dynsym;
 	size_t dynsym_size;
 
+	/* .gnu.hash or .hash section used to look up symbols, if any */
+	const uint32_t *hash;
+	size_t hash_size;
+	bool gnu_hash;
+
 	TEE_Result (*resolve_sym)(struct user_ta_elf_head *elfs,
 				  const char *name, uintptr_t *val);
 };
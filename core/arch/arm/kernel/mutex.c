@@ -7,6 +7,7 @@
 #include <kernel/panic.h>
 #include <kernel/spinlock.h>
 #include <kernel/thread.h>
+#include <string.h>
 #include <trace.h>
 
 #include "mutex_lockdep.h"
@@ -16,8 +17,97 @@ void mutex_init(struct mutex *m)
 	*m = (struct mutex)MUTEX_INITIALIZER;
 }
 
+#ifdef CFG_WITH_STATS
+static struct mutex_stats mutex_stats;
+static unsigned int mutex_stats_lock = SPINLOCK_UNLOCK;
+
+static void stats_contended(bool spun)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&mutex_stats_lock);
+
+	mutex_stats.contended++;
+	if (spun)
+		mutex_stats.spun++;
+
+	cpu_spin_unlock_xrestore(&mutex_stats_lock, exceptions);
+}
+
+static void stats_sleep(struct mutex *m)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&mutex_stats_lock);
+	size_t min_n = 0;
+	size_t n;
+
+	mutex_stats.sleeps++;
+
+	for (n = 0; n < MUTEX_STATS_NUM_TOP; n++) {
+		if (mutex_stats.top[n].va == (vaddr_t)m)
+			break;
+		if (mutex_stats.top[n].sleeps < mutex_stats.top[min_n].sleeps)
+			min_n = n;
+	}
+	if (n == MUTEX_STATS_NUM_TOP) {
+		n = min_n;
+		mutex_stats.top[n].va = (vaddr_t)m;
+		mutex_stats.top[n].sleeps = 0;
+	}
+	mutex_stats.top[n].sleeps++;
+
+	cpu_spin_unlock_xrestore(&mutex_stats_lock, exceptions);
+}
+
+void mutex_get_stats(struct mutex_stats *stats, bool reset)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&mutex_stats_lock);
+
+	*stats = mutex_stats;
+	if (reset)
+		memset(&mutex_stats, 0, sizeof(mutex_stats));
+
+	cpu_spin_unlock_xrestore(&mutex_stats_lock, exceptions);
+}
+#else
+static void stats_contended(bool spun __unused)
+{
+}
+
+static void stats_sleep(struct mutex *m __unused)
+{
+}
+#endif /*CFG_WITH_STATS*/
+
+/*
+ * Spins while the mutex is write locked by a thread executing on another
+ * CPU. Such a thread is likely to unlock the mutex sooner than sleeping
+ * and being woken up in normal world would take.
+ *
+ * Returns true if the mutex was spun on at all, false if spinning was
+ * pointless from the start.
+ */
+static bool spin_on_owner(struct mutex *m __maybe_unused)
+{
+#if CFG_MUTEX_SPIN_COUNT
+	volatile short *state = &m->state;
+	volatile short *owner_id = &m->owner_id;
+	unsigned int n;
+
+	for (n = 0; n < CFG_MUTEX_SPIN_COUNT; n++)
+		if (*state != -1 || !thread_is_active(*owner_id))
+			break;
+
+	return n;
+#else
+	return false;
+#endif
+}
+
 static void __mutex_lock(struct mutex *m, const char *fname, int lineno)
 {
+	bool contended = false;
+	bool spin_ran = false;
+	bool waited = false;
+	bool spun = false;
+
 	assert_have_no_spinlock();
 	assert(thread_get_id_may_fail() != -1);
 	assert(thread_is_in_normal_mode());
@@ -41,25 +131,49 @@ static void __mutex_lock(struct mutex *m, const char *fname, int lineno)
 
 		old_itr_status = cpu_spin_lock_xsave(&m->spin_lock);
 
+		if (waited) {
+			m->write_waiters--;
+			waited = false;
+		}
+
 		can_lock = !m->state;
 		if (!can_lock) {
-			wq_wait_init(&m->wq, &wqe, false /* wait_read */);
 			owner = m->owner_id;
 			assert(owner != thread_get_id_may_fail());
+			if (spun) {
+				wq_wait_init(&m->wq, &wqe,
+					     false /* wait_read */);
+				m->write_waiters++;
+			}
 		} else {
 			m->state = -1; /* write locked */
+			m->owner_id = thread_get_id();
 		}
 
 		cpu_spin_unlock_xrestore(&m->spin_lock, old_itr_status);
 
-		if (!can_lock) {
-			/*
-			 * Someone else is holding the lock, wait in normal
-			 * world for the lock to become available.
-			 */
-			wq_wait_final(&m->wq, &wqe, m, owner, fname, lineno);
-		} else
+		if (can_lock) {
+			if (contended)
+				stats_contended(spin_ran);
 			return;
+		}
+
+		contended = true;
+		if (!spun) {
+			spin_ran = spin_on_owner(m);
+			spun = true;
+			continue;
+		}
+
+		/*
+		 * Someone else is still holding the lock, wait in normal
+		 * world for the lock to become available.
+		 */
+		stats_sleep(m);
+		wq_wait_final(&m->wq, &wqe, m, owner, fname, lineno);
+		waited = true;
+		spin_ran = false;
+		spun = false;
 	}
 }
 
@@ -78,6 +192,7 @@ static void __mutex_unlock(struct mutex *m, const char *fname, int lineno)
 		panic();
 
 	m->state = 0;
+	m->owner_id = MUTEX_OWNER_ID_NONE;
 
 	cpu_spin_unlock_xrestore(&m->spin_lock, old_itr_status);
 
@@ -96,8 +211,10 @@ static bool __mutex_trylock(struct mutex *m, const char *fname __unused,
 	old_itr_status = cpu_spin_lock_xsave(&m->spin_lock);
 
 	can_lock_write = !m->state;
-	if (can_lock_write)
+	if (can_lock_write) {
 		m->state = -1;
+		m->owner_id = thread_get_id();
+	}
 
 	cpu_spin_unlock_xrestore(&m->spin_lock, old_itr_status);
 
@@ -128,6 +245,11 @@ static void __mutex_read_unlock(struct mutex *m, const char *fname, int lineno)
 
 static void __mutex_read_lock(struct mutex *m, const char *fname, int lineno)
 {
+	bool contended = false;
+	bool spin_ran = false;
+	bool waited = false;
+	bool spun = false;
+
 	assert_have_no_spinlock();
 	assert(thread_get_id_may_fail() != -1);
 	assert(thread_is_in_normal_mode());
@@ -149,25 +271,47 @@ static void __mutex_read_lock(struct mutex *m, const char *fname, int lineno)
 
 		old_itr_status = cpu_spin_lock_xsave(&m->spin_lock);
 
-		can_lock = m->state != -1;
+		/*
+		 * Sleeping writers have precedence over new readers, or a
+		 * steady flow of readers would starve them. A reader which
+		 * has been woken up doesn't wait again for the writers
+		 * queued after it.
+		 */
+		can_lock = m->state != -1 && (waited || !m->write_waiters);
 		if (!can_lock) {
-			wq_wait_init(&m->wq, &wqe, true /* wait_read */);
 			owner = m->owner_id;
 			assert(owner != thread_get_id_may_fail());
+			if (spun)
+				wq_wait_init(&m->wq, &wqe,
+					     true /* wait_read */);
 		} else {
 			m->state++; /* read_locked */
 		}
 
 		cpu_spin_unlock_xrestore(&m->spin_lock, old_itr_status);
 
-		if (!can_lock) {
-			/*
-			 * Someone else is holding the lock, wait in normal
-			 * world for the lock to become available.
-			 */
-			wq_wait_final(&m->wq, &wqe, m, owner, fname, lineno);
-		} else
+		if (can_lock) {
+			if (contended)
+				stats_contended(spin_ran);
 			return;
+		}
+
+		contended = true;
+		if (!spun) {
+			spin_ran = spin_on_owner(m);
+			spun = true;
+			continue;
+		}
+
+		/*
+		 * Someone else is still holding the lock, wait in normal
+		 * world for the lock to become available.
+		 */
+		stats_sleep(m);
+		wq_wait_final(&m->wq, &wqe, m, owner, fname, lineno);
+		waited = true;
+		spin_ran = false;
+		spun = false;
 	}
 }
 
@@ -183,7 +327,7 @@ static bool __mutex_read_trylock(struct mutex *m, const char *fname __unused,
 
 	old_itr_status = cpu_spin_lock_xsave(&m->spin_lock);
 
-	can_lock = m->state != -1;
+	can_lock = m->state != -1 && !m->write_waiters;
 	if (can_lock)
 		m->state++;
 
@@ -349,6 +493,7 @@ static void __condvar_wait(struct condvar *cv, struct mutex *m,
 	} else {
 		/* Only one lock (read or write), unlock the mutex */
 		m->state = 0;
+		m->owner_id = MUTEX_OWNER_ID_NONE;
 	}
 	new_state = m->state;
 
@@ -302,9 +302,54 @@ TEE_Result tee_ta_init_pseudo_ta_session(const TEE_UUID *uuid,
 	stc->pseudo_ta = ta;
 	ctx->uuid = ta->uuid;
 	ctx->ops = &pseudo_ta_ops;
-	TAILQ_INSERT_TAIL(&tee_ctxes, ctx, link);
+	tee_ta_register_ctx(ctx);
 
 	DMSG("%s : %pUl", stc->pseudo_ta->name, (void *)&ctx->uuid);
 
 	return TEE_SUCCESS;
 }
+
+/*
+ * The array of pseudo TAs is fixed at link time, the index of a pseudo TA
+ * in the array is used as handle.
+ */
+TEE_Result pseudo_ta_get_fast_handle(const TEE_UUID *uuid, uint32_t *handle)
+{
+	const struct pseudo_ta_head *start =
+		SCATTERED_ARRAY_BEGIN(pseudo_tas, struct pseudo_ta_head);
+	const struct pseudo_ta_head *ta;
+
+	SCATTERED_ARRAY_FOREACH(ta, pseudo_tas, struct pseudo_ta_head) {
+		if (memcmp(&ta->uuid, uuid, sizeof(TEE_UUID)))
+			continue;
+		if (!ta->fast_invoke_command_entry_point)
+			return TEE_ERROR_NOT_SUPPORTED;
+		*handle = ta - start;
+		return TEE_SUCCESS;
+	}
+
+	return TEE_ERROR_ITEM_NOT_FOUND;
+}
+
+TEE_Result pseudo_ta_fast_invoke(uint32_t handle, uint32_t cmd,
+				 TEE_Param params[TEE_NUM_PARAMS])
+{
+	const uint32_t ptypes = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INOUT,
+						TEE_PARAM_TYPE_VALUE_INOUT,
+						TEE_PARAM_TYPE_NONE,
+						TEE_PARAM_TYPE_NONE);
+	const struct pseudo_ta_head *start =
+		SCATTERED_ARRAY_BEGIN(pseudo_tas, struct pseudo_ta_head);
+	const struct pseudo_ta_head *end =
+		SCATTERED_ARRAY_END(pseudo_tas, struct pseudo_ta_head);
+	const struct pseudo_ta_head *ta;
+
+	if (handle >= (size_t)(end - start))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	ta = start + handle;
+	if (!ta->fast_invoke_command_entry_point)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	return ta->fast_invoke_command_entry_point(cmd, ptypes, params);
+}
@@ -3,6 +3,7 @@
  * Copyright (c) 2017, Linaro Limited
  */
 #include <assert.h>
+#include <bench.h>
 #include <crypto/crypto.h>
 #include <initcall.h>
 #include <kernel/thread.h>
@@ -14,6 +15,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <tee_api_types.h>
+#include <tee/tee_cryp_utl.h>
 #include <tee/uuid.h>
 #include <utee_defines.h>
 
@@ -90,6 +92,7 @@ static TEE_Result ree_fs_ta_open(const TEE_UUID *uuid,
 	struct shdr *ta = NULL;
 	size_t ta_size = 0;
 	TEE_Result res;
+	uint64_t start;
 	size_t offs;
 
 	handle = calloc(1, sizeof(*handle));
@@ -97,7 +100,9 @@ static TEE_Result ree_fs_ta_open(const TEE_UUID *uuid,
 		return TEE_ERROR_OUT_OF_MEMORY;
 
 	/* Request TA from tee-supplicant */
+	start = bm_ta_load_start();
 	res = rpc_load(uuid, &ta, &ta_size, &mobj);
+	bm_ta_load_add(BM_TA_LOAD_RPC, start);
 	if (res != TEE_SUCCESS)
 		goto error;
 
@@ -109,7 +114,9 @@ static TEE_Result ree_fs_ta_open(const TEE_UUID *uuid,
 	}
 
 	/* Validate header signature */
+	start = bm_ta_load_start();
 	res = shdr_verify_signature(shdr);
+	bm_ta_load_add(BM_TA_LOAD_VERIFY, start);
 	if (res != TEE_SUCCESS)
 		goto error_free_payload;
 	if (shdr->img_type != SHDR_TA && shdr->img_type != SHDR_BOOTSTRAP_TA) {
@@ -198,6 +205,21 @@ static TEE_Result ree_fs_ta_get_size(const struct user_ta_store_handle *h,
 	return TEE_SUCCESS;
 }
 
+static TEE_Result ree_fs_ta_get_tag(const struct user_ta_store_handle *h,
+				    uint8_t *tag, size_t *tag_len)
+{
+	struct ree_fs_ta_handle *handle = (struct ree_fs_ta_handle *)h;
+
+	if (*tag_len < handle->shdr->hash_size) {
+		*tag_len = handle->shdr->hash_size;
+		return TEE_ERROR_SHORT_BUFFER;
+	}
+	*tag_len = handle->shdr->hash_size;
+	memcpy(tag, SHDR_GET_HASH(handle->shdr), handle->shdr->hash_size);
+
+	return TEE_SUCCESS;
+}
+
 static TEE_Result check_digest(struct ree_fs_ta_handle *h)
 {
 	void *digest = NULL;
@@ -225,18 +247,23 @@ static TEE_Result ree_fs_ta_read(struct user_ta_store_handle *h, void *data,
 	struct ree_fs_ta_handle *handle = (struct ree_fs_ta_handle *)h;
 
 	uint8_t *src = (uint8_t *)handle->nw_ta + handle->offs;
-	uint8_t *dst = src;
+	uint64_t start = bm_ta_load_start();
 	TEE_Result res;
 
 	if (handle->offs + len > handle->nw_ta_size)
 		return TEE_ERROR_BAD_PARAMETERS;
 	if (data) {
-		dst = data; /* Hash secure buffer (shm might be modified) */
-		memcpy(dst, src, len);
+		/* Hash secure buffer (shm might be modified) */
+		res = tee_hash_update_copy(handle->hash_ctx, handle->hash_algo,
+					   data, src, len);
+	} else {
+		res = crypto_hash_update(handle->hash_ctx, handle->hash_algo,
+					 src, len);
+	}
+	if (res != TEE_SUCCESS) {
+		res = TEE_ERROR_SECURITY;
+		goto out;
 	}
-	res = crypto_hash_update(handle->hash_ctx, handle->hash_algo, dst, len);
-	if (res != TEE_SUCCESS)
-		return TEE_ERROR_SECURITY;
 	handle->offs += len;
 	if (handle->offs == handle->nw_ta_size) {
 		/*
@@ -245,6 +272,8 @@ static TEE_Result ree_fs_ta_read(struct user_ta_store_handle *h, void *data,
 		 */
 		res = check_digest(handle);
 	}
+out:
+	bm_ta_load_add(BM_TA_LOAD_HASH, start);
 	return res;
 }
 
@@ -265,6 +294,7 @@ TEE_TA_REGISTER_TA_STORE(9) = {
 	.description = "REE",
 	.open = ree_fs_ta_open,
 	.get_size = ree_fs_ta_get_size,
+	.get_tag = ree_fs_ta_get_tag,
 	.read = ree_fs_ta_read,
 	.close = ree_fs_ta_close,
 };
@@ -285,6 +315,8 @@ struct buf_ree_fs_ta_handle {
 	tee_mm_entry_t *mm;
 	uint8_t *buf;
 	size_t offs;
+	uint8_t tag[TEE_MAX_HASH_SIZE];
+	size_t tag_len;
 };
 
 static TEE_Result buf_ta_open(const TEE_UUID *uuid,
@@ -300,6 +332,10 @@ static TEE_Result buf_ta_open(const TEE_UUID *uuid,
 	if (res)
 		goto err2;
 	res = ree_fs_ta_get_size(handle->h, &handle->ta_size);
+	if (res)
+		goto err;
+	handle->tag_len = sizeof(handle->tag);
+	res = ree_fs_ta_get_tag(handle->h, handle->tag, &handle->tag_len);
 	if (res)
 		goto err;
 	handle->mm = tee_mm_alloc(&tee_mm_sec_ddr, handle->ta_size);
@@ -336,6 +372,21 @@ static TEE_Result buf_ta_get_size(const struct user_ta_store_handle *h,
 	return TEE_SUCCESS;
 }
 
+static TEE_Result buf_ta_get_tag(const struct user_ta_store_handle *h,
+				 uint8_t *tag, size_t *tag_len)
+{
+	struct buf_ree_fs_ta_handle *handle = (struct buf_ree_fs_ta_handle *)h;
+
+	if (*tag_len < handle->tag_len) {
+		*tag_len = handle->tag_len;
+		return TEE_ERROR_SHORT_BUFFER;
+	}
+	*tag_len = handle->tag_len;
+	memcpy(tag, handle->tag, handle->tag_len);
+
+	return TEE_SUCCESS;
+}
+
 static TEE_Result buf_ta_read(struct user_ta_store_handle *h, void *data,
 			      size_t len)
 {
@@ -364,6 +415,7 @@ TEE_TA_REGISTER_TA_STORE(9) = {
 	.description = "REE [buffered]",
 	.open = buf_ta_open,
 	.get_size = buf_ta_get_size,
+	.get_tag = buf_ta_get_tag,
 	.read = buf_ta_read,
 	.close = buf_ta_close,
 };
@@ -6,6 +6,7 @@
 #include <tee/tadb.h>
 #include <kernel/user_ta.h>
 #include <initcall.h>
+#include <string.h>
 #include "elf_load.h"
 
 static TEE_Result secstor_ta_open(const TEE_UUID *uuid,
@@ -49,6 +50,23 @@ static TEE_Result secstor_ta_get_size(const struct user_ta_store_handle *h,
 	return TEE_SUCCESS;
 }
 
+static TEE_Result secstor_ta_get_tag(const struct user_ta_store_handle *h,
+				     uint8_t *tag, size_t *tag_len)
+{
+	struct tee_tadb_ta_read *ta = (struct tee_tadb_ta_read *)h;
+	size_t l = 0;
+	const uint8_t *t = tee_tadb_ta_get_tag(ta, &l);
+
+	if (*tag_len < l) {
+		*tag_len = l;
+		return TEE_ERROR_SHORT_BUFFER;
+	}
+	memcpy(tag, t, l);
+	*tag_len = l;
+
+	return TEE_SUCCESS;
+}
+
 static TEE_Result secstor_ta_read(struct user_ta_store_handle *h, void *data,
 				  size_t len)
 {
@@ -75,6 +93,7 @@ TEE_TA_REGISTER_TA_STORE(4) = {
 	.description = "Secure Storage TA",
 	.open = secstor_ta_open,
 	.get_size = secstor_ta_get_size,
+	.get_tag = secstor_ta_get_tag,
 	.read = secstor_ta_read,
 	.close = secstor_ta_close,
 };
@@ -0,0 +1,539 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2018, Linaro Limited
+ */
+
+#include <assert.h>
+#include <kernel/mutex.h>
+#include <kernel/user_ta.h>
+#include <mm/core_memprot.h>
+#include <mm/tee_mm.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/queue.h>
+#include <trace.h>
+#include <utee_defines.h>
+#include <util.h>
+
+#include "elf_load.h"
+
+/*
+ * This is a caching layer in front of the TA stores with a lower priority
+ * (higher value) than this one, that is the Secure Storage and REE FS TA
+ * stores.
+ *
+ * When a TA isn't found in the cache it's loaded from the store as usual,
+ * while reading the TA a copy is saved in the "Secure DDR" pool. Once the
+ * last byte has been read successfully the store has verified the binary,
+ * and the copy is added to the cache together with the tag reported by
+ * the store, the digest from the signed header for instance.
+ *
+ * Next time the TA is loaded it's read directly from the cache, without
+ * calling into the store at all. That is, no RPC to tee-supplicant and no
+ * signature check.
+ *
+ * Cached images are kept up to date by invalidating them where TAs are
+ * installed or removed, see ta_image_cache_invalidate(). An invalidation
+ * also bumps ta_images_generation, an image which was being populated at
+ * that time is never added to the cache since it may be the old version.
+ * A cached image is replaced when another version of the same TA, with
+ * another tag, is added.
+ *
+ * TAs in the REE FS are installed and removed by the normal world without
+ * OP-TEE being involved, a TA replaced there is picked up once the cached
+ * image has been evicted. This doesn't give the normal world anything it
+ * couldn't do anyway, it can put back any older signed version of a TA in
+ * the REE FS.
+ *
+ * The cache is bounded by CFG_TA_IMAGE_CACHE_SIZE, the least recently
+ * used images which aren't being read are evicted as needed.
+ *
+ * Images can also be preloaded with ta_image_cache_preload(), those are
+ * pinned and never evicted until each preload has been matched by a
+ * ta_image_cache_release(). At most TA_IMAGE_CACHE_MAX_PINNED bytes can be
+ * pinned so there's always room left for caching other TAs.
+ */
+
+#define TA_IMAGE_CACHE_MAX_PINNED	(CFG_TA_IMAGE_CACHE_SIZE / 2)
+
+struct ta_image {
+	TEE_UUID uuid;
+	uint8_t tag[TEE_MAX_HASH_SIZE];
+	size_t tag_len;
+	tee_mm_entry_t *mm;
+	uint8_t *buf;
+	size_t size;
+	unsigned int num_readers;
+	unsigned int num_hits;
+	unsigned int pin_count;
+	unsigned int generation;
+	bool cached;
+	TAILQ_ENTRY(ta_image) link;
+};
+
+struct ta_cache_handle {
+	struct ta_image *img;
+	/* Store and handle used when the TA isn't read from the cache */
+	const struct user_ta_store_ops *op;
+	struct user_ta_store_handle *h;
+	size_t size;
+	size_t offs;
+	uint8_t tag[TEE_MAX_HASH_SIZE];
+	size_t tag_len;
+};
+
+/* Most recently used image first */
+static TAILQ_HEAD(ta_image_head, ta_image) ta_images =
+	TAILQ_HEAD_INITIALIZER(ta_images);
+/* Size of cached images and images being populated */
+static size_t ta_images_size;
+/* Size of cached images which are pinned */
+static size_t ta_images_pinned_size;
+/* Incremented each time an image is invalidated */
+static unsigned int ta_images_generation;
+static struct mutex ta_cache_mu = MUTEX_INITIALIZER;
+
+static TEE_Result ta_cache_open(const TEE_UUID *uuid,
+				struct user_ta_store_handle **h);
+
+/* There's at most one cached image per UUID, see add_image() */
+static struct ta_image *find_image(const TEE_UUID *uuid)
+{
+	struct ta_image *img;
+
+	TAILQ_FOREACH(img, &ta_images, link)
+		if (!memcmp(&img->uuid, uuid, sizeof(*uuid)))
+			return img;
+
+	return NULL;
+}
+
+static bool image_matches(struct ta_image *img, const uint8_t *tag,
+			  size_t tag_len)
+{
+	return img->tag_len == tag_len && !memcmp(img->tag, tag, tag_len);
+}
+
+static void free_image(struct ta_image *img)
+{
+	assert(!img->pin_count);
+	ta_images_size -= img->size;
+	tee_mm_free(img->mm);
+	free(img);
+}
+
+static void evict_images(size_t size)
+{
+	struct ta_image *img = TAILQ_LAST(&ta_images, ta_image_head);
+	struct ta_image *prev_img;
+
+	while (img && ta_images_size + size > CFG_TA_IMAGE_CACHE_SIZE) {
+		prev_img = TAILQ_PREV(img, ta_image_head, link);
+		if (!img->num_readers && !img->pin_count) {
+			DMSG("Evicting %pUl", (void *)&img->uuid);
+			TAILQ_REMOVE(&ta_images, img, link);
+			free_image(img);
+		}
+		img = prev_img;
+	}
+}
+
+/*
+ * Returns a new image to be populated, or NULL if the image can't be
+ * cached. Failing to cache the TA isn't an error, the TA is just loaded
+ * without saving a copy.
+ */
+static struct ta_image *alloc_image(const TEE_UUID *uuid,
+				    const uint8_t *tag, size_t tag_len,
+				    size_t size)
+{
+	struct ta_image *img = NULL;
+
+	if (size > CFG_TA_IMAGE_CACHE_SIZE)
+		return NULL;
+
+	mutex_lock(&ta_cache_mu);
+
+	evict_images(size);
+	if (ta_images_size + size > CFG_TA_IMAGE_CACHE_SIZE)
+		goto out;
+
+	img = calloc(1, sizeof(*img));
+	if (!img)
+		goto out;
+
+	img->mm = tee_mm_alloc(&tee_mm_sec_ddr, size);
+	if (!img->mm)
+		goto err;
+	img->buf = phys_to_virt(tee_mm_get_smem(img->mm), MEM_AREA_TA_RAM);
+	if (!img->buf)
+		goto err;
+	img->uuid = *uuid;
+	memcpy(img->tag, tag, tag_len);
+	img->tag_len = tag_len;
+	img->size = size;
+	img->num_readers = 1;
+	img->generation = ta_images_generation;
+	ta_images_size += size;
+	goto out;
+err:
+	tee_mm_free(img->mm);
+	free(img);
+	img = NULL;
+out:
+	mutex_unlock(&ta_cache_mu);
+	return img;
+}
+
+/* The pins of the image are dropped too, subsequent releases will fail */
+static void uncache_image(struct ta_image *img)
+{
+	if (img->pin_count) {
+		ta_images_pinned_size -= img->size;
+		img->pin_count = 0;
+	}
+	TAILQ_REMOVE(&ta_images, img, link);
+	img->cached = false;
+	/* Otherwise freed when the last reader closes its handle */
+	if (!img->num_readers)
+		free_image(img);
+}
+
+static void add_image(struct ta_image *img)
+{
+	struct ta_image *old_img;
+
+	mutex_lock(&ta_cache_mu);
+
+	/* A TA was invalidated while reading, this may be a stale version */
+	if (img->generation != ta_images_generation)
+		goto out;
+
+	/*
+	 * If another thread has cached the same TA concurrently this image
+	 * is freed when the handle is closed. An image of another version
+	 * of the TA is replaced.
+	 */
+	old_img = find_image(&img->uuid);
+	if (old_img && !image_matches(old_img, img->tag, img->tag_len)) {
+		uncache_image(old_img);
+		old_img = NULL;
+	}
+	if (!old_img) {
+		TAILQ_INSERT_HEAD(&ta_images, img, link);
+		img->cached = true;
+	}
+out:
+	mutex_unlock(&ta_cache_mu);
+}
+
+static void put_image(struct ta_image *img)
+{
+	mutex_lock(&ta_cache_mu);
+
+	assert(img->num_readers);
+	img->num_readers--;
+	/* Incomplete, unverified or invalidated image */
+	if (!img->num_readers && !img->cached)
+		free_image(img);
+
+	mutex_unlock(&ta_cache_mu);
+}
+
+static TEE_Result open_from_store(const TEE_UUID *uuid,
+				  struct ta_cache_handle *handle)
+{
+	const struct user_ta_store_ops *op = NULL;
+	TEE_Result res = TEE_ERROR_ITEM_NOT_FOUND;
+	bool after_cache = false;
+
+	/* Only the stores with a lower priority than this one are wrapped */
+	SCATTERED_ARRAY_FOREACH(op, ta_stores, struct user_ta_store_ops) {
+		if (!after_cache) {
+			after_cache = (op->open == ta_cache_open);
+			continue;
+		}
+
+		res = op->open(uuid, &handle->h);
+		if (res)
+			continue;
+		res = op->get_size(handle->h, &handle->size);
+		if (!res && op->get_tag) {
+			handle->tag_len = sizeof(handle->tag);
+			res = op->get_tag(handle->h, handle->tag,
+					  &handle->tag_len);
+		}
+		if (res) {
+			op->close(handle->h);
+			handle->h = NULL;
+			continue;
+		}
+
+		handle->op = op;
+		return TEE_SUCCESS;
+	}
+
+	return res;
+}
+
+static TEE_Result ta_cache_open(const TEE_UUID *uuid,
+				struct user_ta_store_handle **h)
+{
+	struct ta_cache_handle *handle;
+	struct ta_image *img = NULL;
+	TEE_Result res;
+
+	handle = calloc(1, sizeof(*handle));
+	if (!handle)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	mutex_lock(&ta_cache_mu);
+	img = find_image(uuid);
+	if (img) {
+		img->num_readers++;
+		img->num_hits++;
+		TAILQ_REMOVE(&ta_images, img, link);
+		TAILQ_INSERT_HEAD(&ta_images, img, link);
+	}
+	mutex_unlock(&ta_cache_mu);
+
+	if (img) {
+		handle->img = img;
+		handle->size = img->size;
+		goto out;
+	}
+
+	res = open_from_store(uuid, handle);
+	if (res) {
+		free(handle);
+		return res;
+	}
+
+	/* Without a tag the TA can't be told apart from other versions */
+	if (handle->tag_len)
+		handle->img = alloc_image(uuid, handle->tag, handle->tag_len,
+					  handle->size);
+out:
+	*h = (struct user_ta_store_handle *)handle;
+	return TEE_SUCCESS;
+}
+
+static TEE_Result ta_cache_get_size(const struct user_ta_store_handle *h,
+				    size_t *size)
+{
+	struct ta_cache_handle *handle = (struct ta_cache_handle *)h;
+
+	*size = handle->size;
+	return TEE_SUCCESS;
+}
+
+static TEE_Result read_from_store(struct ta_cache_handle *handle, void *data,
+				  size_t len)
+{
+	uint8_t *dst = NULL;
+	TEE_Result res;
+
+	if (!handle->img)
+		return handle->op->read(handle->h, data, len);
+
+	/* Read into the image, verification is done on the secure copy */
+	dst = handle->img->buf + handle->offs;
+	res = handle->op->read(handle->h, dst, len);
+	if (res)
+		return res;
+	if (data)
+		memcpy(data, dst, len);
+
+	/* The last read has verified the image, it's OK to cache it now */
+	if (handle->offs + len == handle->size)
+		add_image(handle->img);
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result ta_cache_read(struct user_ta_store_handle *h, void *data,
+				size_t len)
+{
+	struct ta_cache_handle *handle = (struct ta_cache_handle *)h;
+	TEE_Result res;
+
+	if (handle->offs + len > handle->size)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (handle->h) {
+		res = read_from_store(handle, data, len);
+		if (res)
+			return res;
+	} else if (data) {
+		memcpy(data, handle->img->buf + handle->offs, len);
+	}
+
+	handle->offs += len;
+	return TEE_SUCCESS;
+}
+
+static void ta_cache_close(struct user_ta_store_handle *h)
+{
+	struct ta_cache_handle *handle = (struct ta_cache_handle *)h;
+
+	if (!handle)
+		return;
+
+	if (handle->h)
+		handle->op->close(handle->h);
+
+	if (handle->img)
+		put_image(handle->img);
+
+	free(handle);
+}
+
+static TEE_Result ta_cache_get_image(struct user_ta_store_handle *h,
+				     const void **image, void **cookie)
+{
+	struct ta_cache_handle *handle = (struct ta_cache_handle *)h;
+	struct ta_image *img = handle->img;
+
+	/* Only images read from the cache are known to be verified */
+	if (!img || handle->h)
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	mutex_lock(&ta_cache_mu);
+	img->num_readers++;
+	mutex_unlock(&ta_cache_mu);
+
+	*image = img->buf;
+	*cookie = img;
+	return TEE_SUCCESS;
+}
+
+static void ta_cache_put_image(void *cookie)
+{
+	put_image(cookie);
+}
+
+void ta_image_cache_invalidate(const TEE_UUID *uuid)
+{
+	struct ta_image *img;
+
+	mutex_lock(&ta_cache_mu);
+
+	ta_images_generation++;
+	img = find_image(uuid);
+	if (img)
+		uncache_image(img);
+
+	mutex_unlock(&ta_cache_mu);
+}
+
+static TEE_Result pin_image(const TEE_UUID *uuid)
+{
+	TEE_Result res = TEE_ERROR_ITEM_NOT_FOUND;
+	struct ta_image *img;
+
+	mutex_lock(&ta_cache_mu);
+
+	img = find_image(uuid);
+	if (!img)
+		goto out;
+
+	if (!img->pin_count) {
+		if (ta_images_pinned_size + img->size >
+		    TA_IMAGE_CACHE_MAX_PINNED) {
+			res = TEE_ERROR_OUT_OF_MEMORY;
+			goto out;
+		}
+		ta_images_pinned_size += img->size;
+	}
+	img->pin_count++;
+	res = TEE_SUCCESS;
+out:
+	mutex_unlock(&ta_cache_mu);
+	return res;
+}
+
+TEE_Result ta_image_cache_preload(const TEE_UUID *uuid)
+{
+	struct user_ta_store_handle *h = NULL;
+	struct ta_cache_handle *handle;
+	TEE_Result res;
+
+	res = ta_cache_open(uuid, &h);
+	if (res)
+		return res;
+	handle = (struct ta_cache_handle *)h;
+
+	if (!handle->img) {
+		/* Too large to fit in the cache */
+		res = TEE_ERROR_OUT_OF_MEMORY;
+		goto out;
+	}
+
+	/* Reading the entire TA verifies it and adds it to the cache */
+	if (handle->h) {
+		res = ta_cache_read(h, NULL, handle->size);
+		if (res)
+			goto out;
+	}
+
+	res = pin_image(uuid);
+out:
+	ta_cache_close(h);
+	return res;
+}
+
+TEE_Result ta_image_cache_release(const TEE_UUID *uuid)
+{
+	TEE_Result res = TEE_ERROR_ITEM_NOT_FOUND;
+	struct ta_image *img;
+
+	mutex_lock(&ta_cache_mu);
+
+	img = find_image(uuid);
+	if (img && img->pin_count) {
+		img->pin_count--;
+		if (!img->pin_count)
+			ta_images_pinned_size -= img->size;
+		res = TEE_SUCCESS;
+	}
+
+	mutex_unlock(&ta_cache_mu);
+	return res;
+}
+
+TEE_Result ta_image_cache_get_info(const TEE_UUID *uuid,
+				   unsigned int *pin_count,
+				   unsigned int *num_hits)
+{
+	TEE_Result res = TEE_ERROR_ITEM_NOT_FOUND;
+	struct ta_image *img;
+
+	mutex_lock(&ta_cache_mu);
+
+	img = find_image(uuid);
+	if (img) {
+		*pin_count = img->pin_count;
+		*num_hits = img->num_hits;
+		res = TEE_SUCCESS;
+	}
+
+	mutex_unlock(&ta_cache_mu);
+	return res;
+}
+
+void ta_image_cache_flush(void)
+{
+	mutex_lock(&ta_cache_mu);
+	evict_images(CFG_TA_IMAGE_CACHE_SIZE);
+	mutex_unlock(&ta_cache_mu);
+}
+
+TEE_TA_REGISTER_TA_STORE(3) = {
+	.description = "TA image cache",
+	.open = ta_cache_open,
+	.get_size = ta_cache_get_size,
+	.read = ta_cache_read,
+	.close = ta_cache_close,
+	.get_image = ta_cache_get_image,
+	.put_image = ta_cache_put_image,
+};
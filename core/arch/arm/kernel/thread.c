@@ -859,6 +859,15 @@ int thread_get_id(void)
 	return ct;
 }
 
+bool thread_is_active(int thread_id)
+{
+	if (thread_id < 0 || thread_id >= CFG_NUM_THREADS)
+		return false;
+
+	return *(volatile enum thread_state *)&threads[thread_id].state ==
+	       THREAD_STATE_ACTIVE;
+}
+
 static void init_handlers(const struct thread_handlers *handlers)
 {
 	thread_std_smc_handler_ptr = handlers->std_smc;
@@ -5,10 +5,12 @@
  */
 
 #include <assert.h>
+#include <bench.h>
 #include <compiler.h>
 #include <ctype.h>
 #include <initcall.h>
 #include <keep.h>
+#include <kernel/mutex.h>
 #include <kernel/panic.h>
 #include <kernel/tee_misc.h>
 #include <kernel/tee_ta_manager.h>
@@ -41,29 +43,107 @@
 #include "elf_load.h"
 #include "elf_load_dyn.h"
 
+#ifdef CFG_PAGED_USER_TA
+#define IS_PAGED_USER_TA	true
+#else
+#define IS_PAGED_USER_TA	false
+#endif
+
+/*
+ * Read-only segment shared by all contexts which have loaded the same ELF
+ * with identical content for the segment.
+ */
+struct shared_seg {
+	TEE_UUID uuid;
+	vaddr_t offs;
+	struct mobj *mobj;
+	unsigned int refcount;
+	SLIST_ENTRY(shared_seg) link;
+};
+
+static SLIST_HEAD(, shared_seg) shared_segs =
+	SLIST_HEAD_INITIALIZER(shared_segs);
+static struct mutex shared_segs_mu = MUTEX_INITIALIZER;
+
 /* ELF file used by a TA (main executable or dynamic library) */
 struct user_ta_elf {
 	TEE_UUID uuid;
 	struct elf_load_state *elf_state;
-	struct mobj *mobj_code;
+	size_t vasize;
 	vaddr_t load_addr;
 	vaddr_t exidx_start; /* 32-bit ELF only */
 	size_t exidx_size;
 	struct load_seg *segs;
 	size_t num_segs;
+	/* Verified binary kept for segments populated on demand */
+	const struct user_ta_store_ops *image_store;
+	void *image_cookie;
 
 	TAILQ_ENTRY(user_ta_elf) link;
 };
 
+struct load_seg {
+	vaddr_t offs;
+	uint32_t flags;
+	vaddr_t oend;
+	vaddr_t va;
+	size_t size;
+	struct mobj *mobj;
+	struct shared_seg *shared;
+};
+
+static void release_ta_memory_by_mobj(struct mobj *mobj)
+{
+	void *va;
+
+	if (!mobj)
+		return;
+
+	va = mobj_get_va(mobj, 0);
+	if (!va)
+		return;
+
+	memset(va, 0, mobj->size);
+	cache_op_inner(DCACHE_AREA_CLEAN, va, mobj->size);
+}
+
+static void put_shared_seg(struct shared_seg *ss)
+{
+	mutex_lock(&shared_segs_mu);
+
+	assert(ss->refcount);
+	ss->refcount--;
+	if (!ss->refcount)
+		SLIST_REMOVE(&shared_segs, ss, shared_seg, link);
+	else
+		ss = NULL;
+
+	mutex_unlock(&shared_segs_mu);
+
+	if (ss) {
+		release_ta_memory_by_mobj(ss->mobj);
+		mobj_free(ss->mobj);
+		free(ss);
+	}
+}
+
 static void free_elfs(struct user_ta_elf_head *elfs)
 {
 	struct user_ta_elf *elf;
 	struct user_ta_elf *next;
+	size_t n;
 
 	TAILQ_FOREACH_SAFE(elf, elfs, link, next) {
 		TAILQ_REMOVE(elfs, elf, link);
-		mobj_free(elf->mobj_code);
+		for (n = 0; n < elf->num_segs; n++) {
+			if (elf->segs[n].shared)
+				put_shared_seg(elf->segs[n].shared);
+			else
+				mobj_free(elf->segs[n].mobj);
+		}
 		free(elf->segs);
+		if (elf->image_cookie)
+			elf->image_store->put_image(elf->image_cookie);
 		free(elf);
 	}
 }
@@ -111,14 +191,6 @@ static uint32_t elf_flags_to_mattr(uint32_t flags)
 	return mattr;
 }
 
-struct load_seg {
-	vaddr_t offs;
-	uint32_t flags;
-	vaddr_t oend;
-	vaddr_t va;
-	size_t size;
-};
-
 static TEE_Result get_elf_segments(struct user_ta_elf *elf,
 				   struct load_seg **segs_ret,
 				   size_t *num_segs_ret)
@@ -324,6 +396,8 @@ static TEE_Result user_ta_enter(TEE_ErrorOrigin *err,
 	s = tee_ta_pop_current_session();
 	assert(s == session);
 cleanup_return:
+	/* Kept parameter mappings may be dropped from now on */
+	tee_mmu_end_param(utc);
 
 	/*
 	 * Clear the cancel state now that the user TA has returned. The next
@@ -434,28 +508,16 @@ static void user_ta_dump_state(struct tee_ta_ctx *ctx)
 }
 KEEP_PAGER(user_ta_dump_state);
 
-static void release_ta_memory_by_mobj(struct mobj *mobj)
-{
-	void *va;
-
-	if (!mobj)
-		return;
-
-	va = mobj_get_va(mobj, 0);
-	if (!va)
-		return;
-
-	memset(va, 0, mobj->size);
-	cache_op_inner(DCACHE_AREA_CLEAN, va, mobj->size);
-}
-
 static void free_utc(struct user_ta_ctx *utc)
 {
 	struct user_ta_elf *elf;
+	size_t n;
 
 	tee_pager_rem_uta_areas(utc);
 	TAILQ_FOREACH(elf, &utc->elfs, link)
-		release_ta_memory_by_mobj(elf->mobj_code);
+		for (n = 0; n < elf->num_segs; n++)
+			if (!elf->segs[n].shared)
+				release_ta_memory_by_mobj(elf->segs[n].mobj);
 	release_ta_memory_by_mobj(utc->mobj_stack);
 	release_ta_memory_by_mobj(utc->mobj_exidx);
 
@@ -705,6 +767,7 @@ static TEE_Result load_elf_from_store(const TEE_UUID *uuid,
 	TEE_Result res;
 	size_t vasize;
 	void *p;
+	uint64_t start;
 	size_t n;
 	size_t num_segs = 0;
 	struct load_seg *segs = NULL;
@@ -728,19 +791,26 @@ static TEE_Result load_elf_from_store(const TEE_UUID *uuid,
 		goto out;
 	elf->elf_state = elf_state;
 
+	if (IS_PAGED_USER_TA && ta_store->get_image && !elf->image_cookie) {
+		const void *image = NULL;
+
+		/*
+		 * With a verified copy of the binary in secure memory
+		 * read-only segments are populated when first accessed.
+		 */
+		if (!ta_store->get_image(handle, &image, &elf->image_cookie)) {
+			elf->image_store = ta_store;
+			elf_load_set_image(elf_state, image, utc);
+		}
+	}
+
 	res = elf_load_head(elf_state,
 			    elf == exe ? sizeof(struct ta_head) : 0,
 			    &p, &vasize, &utc->is_32bit);
 	if (res)
 		goto out;
 	ta_head = p;
-
-
-	elf->mobj_code = alloc_ta_mem(vasize);
-	if (!elf->mobj_code) {
-		res = TEE_ERROR_OUT_OF_MEMORY;
-		goto out;
-	}
+	elf->vasize = vasize;
 
 	if (elf == exe) {
 		/* Ensure proper alignment of stack */
@@ -779,21 +849,34 @@ static TEE_Result load_elf_from_store(const TEE_UUID *uuid,
 	res = get_elf_segments(elf, &segs, &num_segs);
 	if (res != TEE_SUCCESS)
 		goto out;
+	/* Owned by the ELF from now on, the mobjs are freed with the ELF */
+	elf->segs = segs;
+	elf->num_segs = num_segs;
 
 	if (prev) {
-		elf->load_addr = prev->load_addr + prev->mobj_code->size;
+		elf->load_addr = prev->load_addr + prev->vasize;
 		elf->load_addr = ROUNDUP(elf->load_addr,
 					 CORE_MMU_USER_CODE_SIZE);
 	}
 
+	/*
+	 * Each segment has its own mobj to allow read-only segments to be
+	 * shared with other contexts once loaded, see share_ro_segs().
+	 */
+	start = bm_ta_load_start();
 	for (n = 0; n < num_segs; n++) {
 		uint32_t prot = elf_flags_to_mattr(segs[n].flags) |
 				TEE_MATTR_PRW;
 
 		segs[n].va = elf->load_addr - segs[0].offs + segs[n].offs;
 		segs[n].size = segs[n].oend - segs[n].offs;
+		segs[n].mobj = alloc_ta_mem(segs[n].size);
+		if (!segs[n].mobj) {
+			res = TEE_ERROR_OUT_OF_MEMORY;
+			goto out;
+		}
 		res = vm_map(utc, &segs[n].va, segs[n].size, prot,
-			     elf->mobj_code, segs[n].offs);
+			     segs[n].mobj, 0);
 		if (res)
 			goto out;
 		if (!n) {
@@ -803,6 +886,7 @@ static TEE_Result load_elf_from_store(const TEE_UUID *uuid,
 	}
 
 	tee_mmu_set_ctx(&utc->ctx);
+	bm_ta_load_add(BM_TA_LOAD_MAP, start);
 
 	res = elf_load_body(elf_state, elf->load_addr);
 	if (res)
@@ -811,12 +895,6 @@ static TEE_Result load_elf_from_store(const TEE_UUID *uuid,
 	/* Find any external dependency (dynamically linked libraries) */
 	res = add_deps(utc, elf_state, elf->load_addr);
 out:
-	if (res) {
-		free(segs);
-	} else {
-		elf->segs = segs;
-		elf->num_segs = num_segs;
-	}
 	ta_store->close(handle);
 	/* utc is cleaned by caller on error */
 	return res;
@@ -871,6 +949,77 @@ static TEE_Result set_seg_prot(struct user_ta_ctx *utc,
 	return res;
 }
 
+static struct shared_seg *find_shared_seg(struct user_ta_elf *elf,
+					  struct load_seg *seg)
+{
+	void *va = mobj_get_va(seg->mobj, 0);
+	struct shared_seg *ss;
+
+	SLIST_FOREACH(ss, &shared_segs, link)
+		if (!memcmp(&ss->uuid, &elf->uuid, sizeof(elf->uuid)) &&
+		    ss->offs == seg->offs && ss->mobj->size == seg->size &&
+		    !memcmp(mobj_get_va(ss->mobj, 0), va, seg->size))
+			return ss;
+
+	return NULL;
+}
+
+/*
+ * Replaces the private copy of each read-only segment with a segment
+ * loaded by another context if the content is identical, or else makes
+ * the private copy available to other contexts. Segments modified by
+ * relocations depending on the load address are only shared with
+ * contexts which loaded the ELF at the same address.
+ */
+static TEE_Result share_ro_segs(struct user_ta_ctx *utc,
+				struct user_ta_elf *elf)
+{
+	struct shared_seg *ss;
+	struct load_seg *seg;
+	TEE_Result res;
+	size_t n;
+
+	for (n = 0; n < elf->num_segs; n++) {
+		seg = elf->segs + n;
+		if ((seg->flags & PF_W) || mobj_is_paged(seg->mobj) ||
+		    !mobj_get_va(seg->mobj, 0))
+			continue;
+
+		mutex_lock(&shared_segs_mu);
+		ss = find_shared_seg(elf, seg);
+		if (ss) {
+			ss->refcount++;
+		} else {
+			ss = calloc(1, sizeof(*ss));
+			if (ss) {
+				ss->uuid = elf->uuid;
+				ss->offs = seg->offs;
+				ss->mobj = seg->mobj;
+				ss->refcount = 1;
+				SLIST_INSERT_HEAD(&shared_segs, ss, link);
+			}
+		}
+		mutex_unlock(&shared_segs_mu);
+
+		if (!ss)
+			return TEE_ERROR_OUT_OF_MEMORY;
+
+		if (ss->mobj != seg->mobj) {
+			res = vm_set_mobj(utc, seg->va, seg->size, ss->mobj, 0);
+			if (res) {
+				put_shared_seg(ss);
+				return res;
+			}
+			release_ta_memory_by_mobj(seg->mobj);
+			mobj_free(seg->mobj);
+			seg->mobj = ss->mobj;
+		}
+		seg->shared = ss;
+	}
+
+	return TEE_SUCCESS;
+}
+
 #ifdef CFG_UNWIND
 
 /*
@@ -915,7 +1064,7 @@ static TEE_Result set_exidx(struct user_ta_ctx *utc)
 	utc->mobj_exidx = alloc_ta_mem(exidx_sz);
 	if (!utc->mobj_exidx)
 		return TEE_ERROR_OUT_OF_MEMORY;
-	exidx = ROUNDUP(last_elf->load_addr + last_elf->mobj_code->size,
+	exidx = ROUNDUP(last_elf->load_addr + last_elf->vasize,
 			CORE_MMU_USER_CODE_SIZE);
 	res = vm_map(utc, &exidx, exidx_sz, TEE_MATTR_UR | TEE_MATTR_PRW,
 		     utc->mobj_exidx, 0);
@@ -978,6 +1127,8 @@ TEE_Result tee_ta_init_user_ta_session(const TEE_UUID *uuid,
 	struct ta_head *ta_head;
 	struct user_ta_elf *exe;
 	struct user_ta_elf *elf;
+	uint64_t load_start = bm_ta_load_start();
+	uint64_t start;
 
 	/* Register context */
 	utc = calloc(1, sizeof(struct user_ta_ctx));
@@ -1021,10 +1172,16 @@ TEE_Result tee_ta_init_user_ta_session(const TEE_UUID *uuid,
 	 */
 	TAILQ_FOREACH(elf, &utc->elfs, link) {
 		DMSG("Processing relocations in %pUl", (void *)&elf->uuid);
+		start = bm_ta_load_start();
 		res = elf_process_rel(elf->elf_state, elf->load_addr);
+		bm_ta_load_add(BM_TA_LOAD_RELOCATE, start);
 		if (res)
 			goto err;
+		start = bm_ta_load_start();
 		res = set_seg_prot(utc, elf);
+		if (!res)
+			res = share_ro_segs(utc, elf);
+		bm_ta_load_add(BM_TA_LOAD_MAP, start);
 		if (res)
 			goto err;
 	}
@@ -1053,11 +1210,12 @@ TEE_Result tee_ta_init_user_ta_session(const TEE_UUID *uuid,
 	utc->entry_func = ta_head->entry.ptr64;
 	utc->ctx.ref_count = 1;
 	condvar_init(&utc->ctx.busy_cv);
-	TAILQ_INSERT_TAIL(&tee_ctxes, &utc->ctx, link);
+	tee_ta_register_ctx(&utc->ctx);
 	s->ctx = &utc->ctx;
 
 	free_elf_states(utc);
 	tee_mmu_set_ctx(NULL);
+	bm_ta_load_add(BM_TA_LOAD_TOTAL, load_start);
 	return TEE_SUCCESS;
 
 err:
@@ -3,6 +3,7 @@
  * Copyright (c) 2015-2016, Linaro Limited
  */
 #include <compiler.h>
+#include <kernel/notif.h>
 #include <kernel/spinlock.h>
 #include <kernel/thread.h>
 #include <kernel/wait_queue.h>
@@ -38,6 +39,10 @@ void __weak __wq_rpc(uint32_t func, int id, const void *sync_obj __maybe_unused,
 	else
 		DMSG("%s thread %u %p %d", cmd_str, id, sync_obj, owner);
 
+	/* Normal world doesn't need a thread to be woken up this way */
+	if (func == OPTEE_RPC_WAIT_QUEUE_WAKEUP && notif_wq_wakeup(id))
+		return;
+
 	struct thread_param params = THREAD_PARAM_VALUE(IN, func, id, 0);
 
 	ret = thread_rpc_cmd(OPTEE_RPC_CMD_WAIT_QUEUE, 1, &params);
@@ -1334,9 +1334,16 @@ static void set_region(struct core_mmu_table_info *tbl_info,
 	}
 }
 
+/*
+ * Entries are only written if the table doesn't already have them from a
+ * previous time the context was mapped, that is when the table isn't
+ * populated or the region hasn't been mapped since it was added or
+ * changed. *pgt_populated tracks the table of pg_info.
+ */
 static void set_pg_region(struct core_mmu_table_info *dir_info,
 			struct vm_region *region, struct pgt **pgt,
-			struct core_mmu_table_info *pg_info)
+			struct core_mmu_table_info *pg_info,
+			bool *pgt_populated)
 {
 	struct tee_mmap_region r = {
 		.va = region->va,
@@ -1362,9 +1369,8 @@ static void set_pg_region(struct core_mmu_table_info *dir_info,
 			idx = core_mmu_va2idx(dir_info, r.va);
 			pg_info->table = (*pgt)->tbl;
 			pg_info->va_base = core_mmu_idx2va(dir_info, idx);
-#ifdef CFG_PAGED_USER_TA
 			assert((*pgt)->vabase == pg_info->va_base);
-#endif
+			*pgt_populated = (*pgt)->populated;
 			*pgt = SLIST_NEXT(*pgt, link);
 
 			core_mmu_set_entry(dir_info, idx,
@@ -1375,7 +1381,8 @@ static void set_pg_region(struct core_mmu_table_info *dir_info,
 		r.size = MIN(CORE_MMU_PGDIR_SIZE - (r.va - pg_info->va_base),
 			     end - r.va);
 
-		if (!mobj_is_paged(region->mobj)) {
+		if (!mobj_is_paged(region->mobj) &&
+		    !(*pgt_populated && region->mapped)) {
 			size_t granule = BIT(pg_info->shift);
 			size_t offset = r.va - region->va + region->offset;
 
@@ -1471,9 +1478,16 @@ void core_mmu_map_region(struct mmu_partition *prtn, struct tee_mmap_region *mm)
 	}
 }
 
-TEE_Result core_mmu_map_pages(vaddr_t vstart, paddr_t *pages, size_t num_pages,
-			      enum teecore_memtypes memtype)
+/*
+ * Maps @num_pages small pages at @vstart, either the pages listed in
+ * @pages or, if @pages is NULL, the physically contiguous range starting
+ * at @pstart. A contiguous range is mapped with pgdir level block entries
+ * where virtual and physical addresses are suitably aligned.
+ */
+static TEE_Result map_pages(vaddr_t vstart, paddr_t *pages, paddr_t pstart,
+			    size_t num_pages, enum teecore_memtypes memtype)
 {
+	const size_t pgdir_pages = CORE_MMU_PGDIR_SIZE / SMALL_PAGE_SIZE;
 	TEE_Result ret;
 	struct core_mmu_table_info tbl_info;
 	struct tee_mmap_region *mm;
@@ -1481,6 +1495,7 @@ TEE_Result core_mmu_map_pages(vaddr_t vstart, paddr_t *pages, size_t num_pages,
 	uint32_t old_attr;
 	uint32_t exceptions;
 	vaddr_t vaddr = vstart;
+	paddr_t pa;
 	size_t i;
 	bool secure;
 
@@ -1488,7 +1503,7 @@ TEE_Result core_mmu_map_pages(vaddr_t vstart, paddr_t *pages, size_t num_pages,
 
 	secure = core_mmu_type_to_attr(memtype) & TEE_MATTR_SECURE;
 
-	if (vaddr & SMALL_PAGE_MASK)
+	if ((vaddr | pstart) & SMALL_PAGE_MASK)
 		return TEE_ERROR_BAD_PARAMETERS;
 
 	exceptions = mmu_lock();
@@ -1500,8 +1515,14 @@ TEE_Result core_mmu_map_pages(vaddr_t vstart, paddr_t *pages, size_t num_pages,
 	if (!core_mmu_is_dynamic_vaspace(mm))
 		panic("Trying to map into static region");
 
-	for (i = 0; i < num_pages; i++) {
-		if (pages[i] & SMALL_PAGE_MASK) {
+	i = 0;
+	while (i < num_pages) {
+		if (pages)
+			pa = pages[i];
+		else
+			pa = pstart + i * SMALL_PAGE_SIZE;
+
+		if (pa & SMALL_PAGE_MASK) {
 			ret = TEE_ERROR_BAD_PARAMETERS;
 			goto err;
 		}
@@ -1515,6 +1536,17 @@ TEE_Result core_mmu_map_pages(vaddr_t vstart, paddr_t *pages, size_t num_pages,
 			if (tbl_info.shift == SMALL_PAGE_SHIFT)
 				break;
 
+			/*
+			 * An unused pgdir entry covering a whole aligned
+			 * block of a contiguous range is mapped as a block.
+			 */
+			core_mmu_get_entry(&tbl_info, idx, NULL, &old_attr);
+			if (!pages && !old_attr &&
+			    tbl_info.shift == CORE_MMU_PGDIR_SHIFT &&
+			    !((vaddr | pa) & CORE_MMU_PGDIR_MASK) &&
+			    num_pages - i >= pgdir_pages)
+				break;
+
 			/* This is supertable. Need to divide it. */
 			if (!core_mmu_entry_to_finer_grained(&tbl_info, idx,
 							     secure))
@@ -1525,9 +1557,10 @@ TEE_Result core_mmu_map_pages(vaddr_t vstart, paddr_t *pages, size_t num_pages,
 		if (old_attr)
 			panic("Page is already mapped");
 
-		core_mmu_set_entry(&tbl_info, idx, pages[i],
+		core_mmu_set_entry(&tbl_info, idx, pa,
 				   core_mmu_type_to_attr(memtype));
-		vaddr += SMALL_PAGE_SIZE;
+		vaddr += BIT(tbl_info.shift);
+		i += BIT(tbl_info.shift) / SMALL_PAGE_SIZE;
 	}
 
 	/*
@@ -1548,6 +1581,19 @@ err:
 	return ret;
 }
 
+TEE_Result core_mmu_map_pages(vaddr_t vstart, paddr_t *pages, size_t num_pages,
+			      enum teecore_memtypes memtype)
+{
+	return map_pages(vstart, pages, 0, num_pages, memtype);
+}
+
+TEE_Result core_mmu_map_contiguous(vaddr_t vstart, paddr_t pstart,
+				   size_t num_pages,
+				   enum teecore_memtypes memtype)
+{
+	return map_pages(vstart, NULL, pstart, num_pages, memtype);
+}
+
 void core_mmu_unmap_pages(vaddr_t vstart, size_t num_pages)
 {
 	struct core_mmu_table_info tbl_info;
@@ -1565,15 +1611,22 @@ void core_mmu_unmap_pages(vaddr_t vstart, size_t num_pages)
 	if (!core_mmu_is_dynamic_vaspace(mm))
 		panic("Trying to unmap static region");
 
-	for (i = 0; i < num_pages; i++, vstart += SMALL_PAGE_SIZE) {
+	i = 0;
+	while (i < num_pages) {
 		if (!core_mmu_find_table(NULL, vstart, UINT_MAX, &tbl_info))
 			panic("Can't find pagetable");
 
-		if (tbl_info.shift != SMALL_PAGE_SHIFT)
+		/* Block entries are only used for whole aligned blocks */
+		if (tbl_info.shift != SMALL_PAGE_SHIFT &&
+		    (tbl_info.shift != CORE_MMU_PGDIR_SHIFT ||
+		     (vstart & CORE_MMU_PGDIR_MASK) ||
+		     num_pages - i < CORE_MMU_PGDIR_SIZE / SMALL_PAGE_SIZE))
 			panic("Invalid pagetable level");
 
 		idx = core_mmu_va2idx(&tbl_info, vstart);
 		core_mmu_set_entry(&tbl_info, idx, 0, 0);
+		vstart += BIT(tbl_info.shift);
+		i += BIT(tbl_info.shift) / SMALL_PAGE_SIZE;
 	}
 	tlbi_all();
 
@@ -1585,6 +1638,7 @@ void core_mmu_populate_user_map(struct core_mmu_table_info *dir_info,
 {
 	struct core_mmu_table_info pg_info;
 	struct pgt_cache *pgt_cache = &thread_get_tsd()->pgt_cache;
+	bool pgt_populated = false;
 	struct pgt *pgt;
 	struct vm_region *r;
 	struct vm_region *r_last;
@@ -1608,7 +1662,17 @@ void core_mmu_populate_user_map(struct core_mmu_table_info *dir_info,
 		mobj_update_mapping(r->mobj, utc, r->va);
 
 	TAILQ_FOREACH(r, &utc->vm_info->regions, link)
-		set_pg_region(dir_info, r, &pgt, &pg_info);
+		set_pg_region(dir_info, r, &pgt, &pg_info, &pgt_populated);
+
+	/*
+	 * The tables are kept with their content in the cache of
+	 * translation tables when the context is unmapped, next time only
+	 * added or changed regions need to be written.
+	 */
+	SLIST_FOREACH(pgt, pgt_cache, link)
+		pgt->populated = true;
+	TAILQ_FOREACH(r, &utc->vm_info->regions, link)
+		r->mapped = true;
 }
 
 bool core_mmu_add_mapping(enum teecore_memtypes type, paddr_t addr, size_t len)
@@ -304,24 +304,32 @@ struct mobj *mobj_mm_alloc(struct mobj *mobj_parent, size_t size,
  * mobj_reg_shm implementation. Describes shared memory provided by normal world
  */
 
+/* Physically contiguous pages starting at page @first_page of the buffer */
+struct reg_shm_run {
+	paddr_t pa;
+	size_t first_page;
+};
+
 struct mobj_reg_shm {
 	struct mobj mobj;
 	SLIST_ENTRY(mobj_reg_shm) next;
 	uint64_t cookie;
 	tee_mm_entry_t *mm;
+	vaddr_t va;
 	paddr_t page_offset;
 	struct refcount refcount;
 	struct refcount mapcount;
-	int num_pages;
+	size_t num_pages;
 	bool guarded;
-	paddr_t pages[];
+	size_t num_runs;
+	struct reg_shm_run runs[];
 };
 
-static size_t mobj_reg_shm_size(size_t nr_pages)
+static size_t mobj_reg_shm_size(size_t nr_runs)
 {
 	size_t s = 0;
 
-	if (MUL_OVERFLOW(sizeof(paddr_t), nr_pages, &s))
+	if (MUL_OVERFLOW(sizeof(struct reg_shm_run), nr_runs, &s))
 		return 0;
 	if (ADD_OVERFLOW(sizeof(struct mobj_reg_shm), s, &s))
 		return 0;
@@ -336,6 +344,37 @@ static unsigned int reg_shm_map_lock = SPINLOCK_UNLOCK;
 
 static struct mobj_reg_shm *to_mobj_reg_shm(struct mobj *mobj);
 
+static size_t reg_shm_run_num_pages(struct mobj_reg_shm *r, size_t n)
+{
+	if (n + 1 < r->num_runs)
+		return r->runs[n + 1].first_page - r->runs[n].first_page;
+	return r->num_pages - r->runs[n].first_page;
+}
+
+static paddr_t reg_shm_page_pa(struct mobj_reg_shm *r, size_t page)
+{
+	size_t lo = 0;
+	size_t hi = r->num_runs;
+	size_t mid = 0;
+
+	/* Without any contiguous pages there's one run per page */
+	if (r->num_runs == r->num_pages)
+		return r->runs[page].pa;
+
+	/* Find the last run starting at or before @page */
+	while (hi - lo > 1) {
+		mid = (lo + hi) / 2;
+		if (r->runs[mid].first_page <= page)
+			lo = mid;
+		else
+			hi = mid;
+	}
+
+	return r->runs[lo].pa +
+	       (page - r->runs[lo].first_page) * SMALL_PAGE_SIZE;
+}
+KEEP_PAGER(reg_shm_page_pa);
+
 static TEE_Result mobj_reg_shm_get_pa(struct mobj *mobj, size_t offst,
 				      size_t granule, paddr_t *pa)
 {
@@ -352,11 +391,13 @@ static TEE_Result mobj_reg_shm_get_pa(struct mobj *mobj, size_t offst,
 
 	switch (granule) {
 	case 0:
-		p = mobj_reg_shm->pages[full_offset / SMALL_PAGE_SIZE] +
+		p = reg_shm_page_pa(mobj_reg_shm,
+				    full_offset / SMALL_PAGE_SIZE) +
 			(full_offset & SMALL_PAGE_MASK);
 		break;
 	case SMALL_PAGE_SIZE:
-		p = mobj_reg_shm->pages[full_offset / SMALL_PAGE_SIZE];
+		p = reg_shm_page_pa(mobj_reg_shm,
+				    full_offset / SMALL_PAGE_SIZE);
 		break;
 	default:
 		return TEE_ERROR_GENERIC;
@@ -382,8 +423,7 @@ static void *mobj_reg_shm_get_va(struct mobj *mobj, size_t offst)
 	if (!mrs->mm)
 		return NULL;
 
-	return (void *)(vaddr_t)(tee_mm_get_smem(mrs->mm) + offst +
-				 mrs->page_offset);
+	return (void *)(mrs->va + offst + mrs->page_offset);
 }
 
 static void reg_shm_unmap_helper(struct mobj_reg_shm *r)
@@ -391,8 +431,7 @@ static void reg_shm_unmap_helper(struct mobj_reg_shm *r)
 	uint32_t exceptions = cpu_spin_lock_xsave(&reg_shm_map_lock);
 
 	if (r->mm) {
-		core_mmu_unmap_pages(tee_mm_get_smem(r->mm),
-				     r->mobj.size / SMALL_PAGE_SIZE);
+		core_mmu_unmap_pages(r->va, r->num_pages);
 		tee_mm_free(r->mm);
 		r->mm = NULL;
 	}
@@ -462,55 +501,147 @@ static struct mobj_reg_shm *to_mobj_reg_shm_may_fail(struct mobj *mobj)
 	return container_of(mobj, struct mobj_reg_shm, mobj);
 }
 
+static struct mobj_reg_shm *reg_shm_alloc(size_t max_runs,
+					   paddr_t page_offset,
+					   uint64_t cookie)
+{
+	struct mobj_reg_shm *r = NULL;
+	size_t s = mobj_reg_shm_size(max_runs);
+
+	if (!s)
+		return NULL;
+	r = calloc(1, s);
+	if (!r)
+		return NULL;
+
+	r->mobj.ops = &mobj_reg_shm_ops;
+	r->mobj.phys_granule = SMALL_PAGE_SIZE;
+	r->cookie = cookie;
+	r->guarded = true;
+	r->page_offset = page_offset;
+	refcount_set(&r->refcount, 1);
+
+	return r;
+}
+
+/*
+ * Appends @num_pages physically contiguous pages starting at @pa, merged
+ * into the last run if it ends where this one starts.
+ */
+static bool reg_shm_add_pages(struct mobj_reg_shm *r, paddr_t pa,
+			      size_t num_pages)
+{
+	struct reg_shm_run *last = NULL;
+
+	/* Insure loaded references match format and security constraints */
+	if (!num_pages || (pa & SMALL_PAGE_MASK) ||
+	    num_pages > SIZE_MAX / SMALL_PAGE_SIZE - r->num_pages)
+		return false;
+
+	/* Only Non-secure memory can be mapped there */
+	if (!core_pbuf_is(CORE_MEM_NON_SEC, pa, num_pages * SMALL_PAGE_SIZE))
+		return false;
+
+	if (r->num_runs) {
+		last = r->runs + r->num_runs - 1;
+		if (last->pa + (r->num_pages - last->first_page) *
+			       SMALL_PAGE_SIZE == pa) {
+			r->num_pages += num_pages;
+			return true;
+		}
+	}
+
+	r->runs[r->num_runs].pa = pa;
+	r->runs[r->num_runs].first_page = r->num_pages;
+	r->num_runs++;
+	r->num_pages += num_pages;
+
+	return true;
+}
+
+static struct mobj *reg_shm_publish(struct mobj_reg_shm *r)
+{
+	uint32_t exceptions;
+
+	r->mobj.size = r->num_pages * SMALL_PAGE_SIZE;
+
+	exceptions = cpu_spin_lock_xsave(&reg_shm_slist_lock);
+	SLIST_INSERT_HEAD(&reg_shm_list, r, next);
+	cpu_spin_unlock_xrestore(&reg_shm_slist_lock, exceptions);
+
+	return &r->mobj;
+}
+
 struct mobj *mobj_reg_shm_alloc(paddr_t *pages, size_t num_pages,
 				paddr_t page_offset, uint64_t cookie)
 {
 	struct mobj_reg_shm *mobj_reg_shm;
+	size_t num_runs = 1;
 	size_t i;
-	uint32_t exceptions;
-	size_t s;
 
 	if (!num_pages)
 		return NULL;
 
-	s = mobj_reg_shm_size(num_pages);
-	if (!s)
-		return NULL;
-	mobj_reg_shm = calloc(1, s);
+	for (i = 1; i < num_pages; i++)
+		if (pages[i] != pages[i - 1] + SMALL_PAGE_SIZE)
+			num_runs++;
+
+	mobj_reg_shm = reg_shm_alloc(num_runs, page_offset, cookie);
 	if (!mobj_reg_shm)
 		return NULL;
 
-	mobj_reg_shm->mobj.ops = &mobj_reg_shm_ops;
-	mobj_reg_shm->mobj.size =  num_pages * SMALL_PAGE_SIZE;
-	mobj_reg_shm->mobj.phys_granule = SMALL_PAGE_SIZE;
-	mobj_reg_shm->cookie = cookie;
-	mobj_reg_shm->guarded = true;
-	mobj_reg_shm->num_pages = num_pages;
-	mobj_reg_shm->page_offset = page_offset;
-	memcpy(mobj_reg_shm->pages, pages, sizeof(*pages) * num_pages);
-	refcount_set(&mobj_reg_shm->refcount, 1);
-
-	/* Insure loaded references match format and security constraints */
-	for (i = 0; i < num_pages; i++) {
-		if (mobj_reg_shm->pages[i] & SMALL_PAGE_MASK)
+	for (i = 0; i < num_pages; i++)
+		if (!reg_shm_add_pages(mobj_reg_shm, pages[i], 1))
 			goto err;
 
-		/* Only Non-secure memory can be mapped there */
-		if (!core_pbuf_is(CORE_MEM_NON_SEC, mobj_reg_shm->pages[i],
-					SMALL_PAGE_SIZE))
-			goto err;
-	}
+	return reg_shm_publish(mobj_reg_shm);
+err:
+	free(mobj_reg_shm);
+	return NULL;
+}
 
-	exceptions = cpu_spin_lock_xsave(&reg_shm_slist_lock);
-	SLIST_INSERT_HEAD(&reg_shm_list, mobj_reg_shm, next);
-	cpu_spin_unlock_xrestore(&reg_shm_slist_lock, exceptions);
+struct mobj *mobj_reg_shm_alloc_runs(const struct mobj_reg_shm_run *runs,
+				     size_t num_runs, paddr_t page_offset,
+				     uint64_t cookie)
+{
+	struct mobj_reg_shm *mobj_reg_shm;
+	size_t i;
+
+	if (!num_runs)
+		return NULL;
+
+	mobj_reg_shm = reg_shm_alloc(num_runs, page_offset, cookie);
+	if (!mobj_reg_shm)
+		return NULL;
+
+	for (i = 0; i < num_runs; i++)
+		if (!reg_shm_add_pages(mobj_reg_shm, runs[i].pa,
+				       runs[i].num_pages))
+			goto err;
 
-	return &mobj_reg_shm->mobj;
+	return reg_shm_publish(mobj_reg_shm);
 err:
 	free(mobj_reg_shm);
 	return NULL;
 }
 
+struct mobj *mobj_reg_shm_get(struct mobj *mobj)
+{
+	struct mobj_reg_shm *r = to_mobj_reg_shm_may_fail(mobj);
+	uint32_t exceptions = 0;
+
+	if (!r)
+		return NULL;
+
+	exceptions = cpu_spin_lock_xsave(&reg_shm_slist_lock);
+	/* The caller holds a reference so the counter can't be 0 */
+	if (!refcount_inc(&r->refcount))
+		panic();
+	cpu_spin_unlock_xrestore(&reg_shm_slist_lock, exceptions);
+
+	return mobj;
+}
+
 void mobj_reg_shm_unguard(struct mobj *mobj)
 {
 	uint32_t exceptions = cpu_spin_lock_xsave(&reg_shm_slist_lock);
@@ -600,10 +731,27 @@ out:
 	return res;
 }
 
+/*
+ * User TAs keep parameter mappings of registered shared memory between
+ * invocations, each holding a reference. Those have to be dropped before
+ * the MOBJ can be released.
+ */
+static void release_param_maps(uint64_t cookie)
+{
+	struct mobj *mobj = mobj_reg_shm_get_by_cookie(cookie);
+
+	if (mobj) {
+		tee_mmu_release_shm_param_maps(mobj);
+		mobj_reg_shm_put(mobj);
+	}
+}
+
 TEE_Result mobj_reg_shm_release_by_cookie(uint64_t cookie)
 {
-	TEE_Result res = try_release_reg_shm(cookie);
+	TEE_Result res = TEE_SUCCESS;
 
+	release_param_maps(cookie);
+	res = try_release_reg_shm(cookie);
 	if (res != TEE_ERROR_BUSY)
 		return res;
 
@@ -612,6 +760,15 @@ TEE_Result mobj_reg_shm_release_by_cookie(uint64_t cookie)
 	assert(shm_release_waiters);
 
 	while (true) {
+		/*
+		 * A mapping kept by an invocation in progress can only be
+		 * dropped once the invocation has ended, which also puts
+		 * the reference of the invocation and wakes us up.
+		 */
+		mutex_unlock(&shm_mu);
+		release_param_maps(cookie);
+		mutex_lock(&shm_mu);
+
 		res = try_release_reg_shm(cookie);
 		if (res != TEE_ERROR_BUSY)
 			break;
@@ -625,6 +782,77 @@ TEE_Result mobj_reg_shm_release_by_cookie(uint64_t cookie)
 	return res;
 }
 
+/*
+ * Finds the first pgdir sized block of physical memory in the buffer which
+ * can be mapped with a block entry, @offs is updated with the offset of
+ * the block into the buffer.
+ */
+static bool reg_shm_find_block(struct mobj_reg_shm *r, size_t *offs)
+{
+	paddr_t end = 0;
+	paddr_t pa = 0;
+	size_t n = 0;
+
+	for (n = 0; n < r->num_runs; n++) {
+		pa = ROUNDUP(r->runs[n].pa, CORE_MMU_PGDIR_SIZE);
+		end = r->runs[n].pa +
+		      reg_shm_run_num_pages(r, n) * SMALL_PAGE_SIZE;
+		if (pa >= r->runs[n].pa && end >= pa &&
+		    end - pa >= CORE_MMU_PGDIR_SIZE) {
+			*offs = r->runs[n].first_page * SMALL_PAGE_SIZE +
+				pa - r->runs[n].pa;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static TEE_Result reg_shm_map(struct mobj_reg_shm *r)
+{
+	size_t size = r->num_pages * SMALL_PAGE_SIZE;
+	size_t block_offs = 0;
+	TEE_Result res = TEE_SUCCESS;
+	size_t n = 0;
+
+	/*
+	 * If there's physical memory which can be mapped with a block
+	 * entry, reserve enough virtual address space to align the
+	 * mapping to the pgdir size, falling back to small pages only if
+	 * that's not available.
+	 */
+	if (reg_shm_find_block(r, &block_offs))
+		r->mm = tee_mm_alloc(&tee_mm_shm, size + CORE_MMU_PGDIR_SIZE -
+						  SMALL_PAGE_SIZE);
+	if (r->mm) {
+		r->va = ROUNDUP(tee_mm_get_smem(r->mm) + block_offs,
+				CORE_MMU_PGDIR_SIZE) - block_offs;
+	} else {
+		r->mm = tee_mm_alloc(&tee_mm_shm, size);
+		if (!r->mm)
+			return TEE_ERROR_OUT_OF_MEMORY;
+		r->va = tee_mm_get_smem(r->mm);
+	}
+
+	for (n = 0; n < r->num_runs; n++) {
+		res = core_mmu_map_contiguous(r->va + r->runs[n].first_page *
+							SMALL_PAGE_SIZE,
+					      r->runs[n].pa,
+					      reg_shm_run_num_pages(r, n),
+					      MEM_AREA_NSEC_SHM);
+		if (res) {
+			if (r->runs[n].first_page)
+				core_mmu_unmap_pages(r->va,
+						     r->runs[n].first_page);
+			tee_mm_free(r->mm);
+			r->mm = NULL;
+			return res;
+		}
+	}
+
+	return TEE_SUCCESS;
+}
+
 TEE_Result mobj_reg_shm_inc_map(struct mobj *mobj)
 {
 	TEE_Result res = TEE_SUCCESS;
@@ -641,19 +869,9 @@ TEE_Result mobj_reg_shm_inc_map(struct mobj *mobj)
 	if (refcount_val(&r->mapcount))
 		goto out;
 
-	r->mm = tee_mm_alloc(&tee_mm_shm, SMALL_PAGE_SIZE * r->num_pages);
-	if (!r->mm) {
-		res = TEE_ERROR_OUT_OF_MEMORY;
+	res = reg_shm_map(r);
+	if (res)
 		goto out;
-	}
-
-	res = core_mmu_map_pages(tee_mm_get_smem(r->mm), r->pages,
-				 r->num_pages, MEM_AREA_NSEC_SHM);
-	if (res) {
-		tee_mm_free(r->mm);
-		r->mm = NULL;
-		goto out;
-	}
 
 	refcount_set(&r->mapcount, 1);
 out:
@@ -675,8 +893,7 @@ TEE_Result mobj_reg_shm_dec_map(struct mobj *mobj)
 	uint32_t exceptions = cpu_spin_lock_xsave(&reg_shm_map_lock);
 
 	if (refcount_val(&r->mapcount)) {
-		core_mmu_unmap_pages(tee_mm_get_smem(r->mm),
-				     r->mobj.size / SMALL_PAGE_SIZE);
+		core_mmu_unmap_pages(r->va, r->num_pages);
 		tee_mm_free(r->mm);
 		r->mm = NULL;
 	}
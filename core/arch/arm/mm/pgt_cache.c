@@ -46,15 +46,18 @@ static struct pgt_parent pgt_parents[PGT_CACHE_SIZE / PGT_NUM_PGT_PER_PAGE];
 static struct pgt_cache pgt_free_list = SLIST_HEAD_INITIALIZER(pgt_free_list);
 #endif
 
-#ifdef CFG_PAGED_USER_TA
 /*
- * When a user TA context is temporarily unmapped the used struct pgt's of
- * the context (page tables holding valid physical pages) are saved in this
- * cache in the hope that some of the valid physical pages may still be
- * valid when the context is mapped again.
+ * When a user TA context is temporarily unmapped the struct pgt's of the
+ * context are saved in this cache together with their content. When the
+ * context is mapped again the tables found here can be used as they are
+ * instead of being populated from scratch. With CFG_PAGED_USER_TA this
+ * also keeps the physical pages mapped by the pager.
+ *
+ * The cache is bounded by the pool of page tables, cached tables are
+ * recycled when the free list is empty.
  */
 static struct pgt_cache pgt_cache_list = SLIST_HEAD_INITIALIZER(pgt_cache_list);
-#endif
+static struct pgt_cache_stats pgt_stats;
 
 static struct pgt pgt_entries[PGT_CACHE_SIZE];
 
@@ -168,7 +171,6 @@ static void push_to_free_list(struct pgt *p)
 }
 #endif
 
-#ifdef CFG_PAGED_USER_TA
 static void push_to_cache_list(struct pgt *pgt)
 {
 	SLIST_INSERT_HEAD(&pgt_cache_list, pgt, link);
@@ -205,6 +207,7 @@ static struct pgt *pop_from_cache_list(vaddr_t vabase, void *ctx)
 	return p;
 }
 
+#ifdef CFG_PAGED_USER_TA
 static struct pgt *pop_least_used_from_cache_list(void)
 {
 	struct pgt *pgt;
@@ -239,20 +242,57 @@ out:
 	return pgt;
 }
 
+static void release_pgt_entries(struct pgt *p)
+{
+	tee_pager_pgt_save_and_release_entries(p);
+	assert(!p->num_used_entries);
+}
+#else
+/* Tables are pushed at the head, the last one is the least recently used */
+static struct pgt *pop_least_used_from_cache_list(void)
+{
+	struct pgt *pgt;
+	struct pgt *p_prev = NULL;
+
+	pgt = SLIST_FIRST(&pgt_cache_list);
+	if (!pgt)
+		return NULL;
+
+	while (SLIST_NEXT(pgt, link)) {
+		p_prev = pgt;
+		pgt = SLIST_NEXT(pgt, link);
+	}
+
+	if (p_prev)
+		SLIST_REMOVE_AFTER(p_prev, link);
+	else
+		SLIST_REMOVE_HEAD(&pgt_cache_list, link);
+	return pgt;
+}
+
+static void release_pgt_entries(struct pgt *p __unused)
+{
+}
+#endif
+
+static void flush_pgt_entry(struct pgt *p)
+{
+	release_pgt_entries(p);
+	p->ctx = NULL;
+	p->vabase = 0;
+	p->populated = false;
+}
+
 static void pgt_free_unlocked(struct pgt_cache *pgt_cache, bool save_ctx)
 {
 	while (!SLIST_EMPTY(pgt_cache)) {
 		struct pgt *p = SLIST_FIRST(pgt_cache);
 
 		SLIST_REMOVE_HEAD(pgt_cache, link);
-		if (save_ctx && p->num_used_entries) {
+		if (save_ctx) {
 			push_to_cache_list(p);
 		} else {
-			tee_pager_pgt_save_and_release_entries(p);
-			assert(!p->num_used_entries);
-			p->ctx = NULL;
-			p->vabase = 0;
-
+			flush_pgt_entry(p);
 			push_to_free_list(p);
 		}
 	}
@@ -262,19 +302,24 @@ static struct pgt *pop_from_some_list(vaddr_t vabase, void *ctx)
 {
 	struct pgt *p = pop_from_cache_list(vabase, ctx);
 
-	if (p)
+	if (p) {
+		pgt_stats.hits++;
 		return p;
+	}
+
+	pgt_stats.misses++;
 	p = pop_from_free_list();
 	if (!p) {
 		p = pop_least_used_from_cache_list();
 		if (!p)
 			return NULL;
-		tee_pager_pgt_save_and_release_entries(p);
+		pgt_stats.evictions++;
+		release_pgt_entries(p);
 		memset(p->tbl, 0, PGT_SIZE);
 	}
-	assert(!p->num_used_entries);
 	p->ctx = ctx;
 	p->vabase = vabase;
+	p->populated = false;
 	return p;
 }
 
@@ -292,10 +337,7 @@ void pgt_flush_ctx(struct tee_ta_ctx *ctx)
 		if (p->ctx != ctx)
 			break;
 		SLIST_REMOVE_HEAD(&pgt_cache_list, link);
-		tee_pager_pgt_save_and_release_entries(p);
-		assert(!p->num_used_entries);
-		p->ctx = NULL;
-		p->vabase = 0;
+		flush_pgt_entry(p);
 		push_to_free_list(p);
 	}
 
@@ -306,10 +348,7 @@ void pgt_flush_ctx(struct tee_ta_ctx *ctx)
 			break;
 		if (p->ctx == ctx) {
 			SLIST_REMOVE_AFTER(pp, link);
-			tee_pager_pgt_save_and_release_entries(p);
-			assert(!p->num_used_entries);
-			p->ctx = NULL;
-			p->vabase = 0;
+			flush_pgt_entry(p);
 			push_to_free_list(p);
 		} else {
 			pp = p;
@@ -317,17 +356,10 @@ void pgt_flush_ctx(struct tee_ta_ctx *ctx)
 	}
 
 out:
+	condvar_broadcast(&pgt_cv);
 	mutex_unlock(&pgt_mu);
 }
 
-static void flush_pgt_entry(struct pgt *p)
-{
-	tee_pager_pgt_save_and_release_entries(p);
-	assert(!p->num_used_entries);
-	p->ctx = NULL;
-	p->vabase = 0;
-}
-
 static bool pgt_entry_matches(struct pgt *p, void *ctx, vaddr_t begin,
 			      vaddr_t last)
 {
@@ -393,13 +425,49 @@ void pgt_flush_ctx_range(struct pgt_cache *pgt_cache, void *ctx,
 {
 	mutex_lock(&pgt_mu);
 
-	flush_ctx_range_from_list(pgt_cache, ctx, begin, last);
+	if (pgt_cache)
+		flush_ctx_range_from_list(pgt_cache, ctx, begin, last);
 	flush_ctx_range_from_list(&pgt_cache_list, ctx, begin, last);
 
 	condvar_broadcast(&pgt_cv);
 	mutex_unlock(&pgt_mu);
 }
 
+static void clear_ctx_range_in_list(struct pgt_cache *pgt_cache, void *ctx,
+				    vaddr_t begin, vaddr_t last)
+{
+	const size_t entry_size = PGT_SIZE /
+				  (CORE_MMU_PGDIR_SIZE / SMALL_PAGE_SIZE);
+	struct pgt *p;
+	vaddr_t b;
+	vaddr_t e;
+
+	SLIST_FOREACH(p, pgt_cache, link) {
+		if (p->ctx != ctx)
+			continue;
+		b = MAX(begin, p->vabase);
+		e = MIN(last, p->vabase + CORE_MMU_PGDIR_SIZE - 1);
+		if (b > e)
+			continue;
+		memset((uint8_t *)p->tbl +
+		       ((b - p->vabase) >> SMALL_PAGE_SHIFT) * entry_size, 0,
+		       (((e - b) >> SMALL_PAGE_SHIFT) + 1) * entry_size);
+	}
+}
+
+void pgt_clear_ctx_range(struct pgt_cache *pgt_cache, void *ctx,
+			 vaddr_t begin, vaddr_t last)
+{
+	mutex_lock(&pgt_mu);
+
+	if (pgt_cache)
+		clear_ctx_range_in_list(pgt_cache, ctx, begin, last);
+	clear_ctx_range_in_list(&pgt_cache_list, ctx, begin, last);
+
+	mutex_unlock(&pgt_mu);
+}
+
+#ifdef CFG_PAGED_USER_TA
 static void transfer_tables(struct pgt_cache *pgt_cache, void *old_ctx,
 			    vaddr_t old_va, void *new_ctx, vaddr_t new_va,
 			    size_t size)
@@ -467,25 +535,7 @@ void pgt_transfer(struct pgt_cache *pgt_cache, void *old_ctx, vaddr_t old_va,
 				new_va, size);
 }
 
-#else /*!CFG_PAGED_USER_TA*/
-
-static void pgt_free_unlocked(struct pgt_cache *pgt_cache,
-			      bool save_ctx __unused)
-{
-	while (!SLIST_EMPTY(pgt_cache)) {
-		struct pgt *p = SLIST_FIRST(pgt_cache);
-
-		SLIST_REMOVE_HEAD(pgt_cache, link);
-		push_to_free_list(p);
-	}
-}
-
-static struct pgt *pop_from_some_list(vaddr_t vabase __unused,
-				      void *ctx __unused)
-{
-	return pop_from_free_list();
-}
-#endif /*!CFG_PAGED_USER_TA*/
+#endif /*CFG_PAGED_USER_TA*/
 
 static bool pgt_alloc_unlocked(struct pgt_cache *pgt_cache, void *ctx,
 			       vaddr_t begin, vaddr_t last)
@@ -544,3 +594,14 @@ void pgt_free(struct pgt_cache *pgt_cache, bool save_ctx)
 	condvar_broadcast(&pgt_cv);
 	mutex_unlock(&pgt_mu);
 }
+
+void pgt_get_cache_stats(struct pgt_cache_stats *stats, bool reset)
+{
+	mutex_lock(&pgt_mu);
+
+	*stats = pgt_stats;
+	if (reset)
+		memset(&pgt_stats, 0, sizeof(pgt_stats));
+
+	mutex_unlock(&pgt_mu);
+}
@@ -6,6 +6,7 @@
 
 #include <arm.h>
 #include <assert.h>
+#include <kernel/mutex.h>
 #include <kernel/panic.h>
 #include <kernel/spinlock.h>
 #include <kernel/virtualization.h>
@@ -294,6 +295,33 @@ err_free_reg:
 	return res;
 }
 
+/*
+ * Translation tables are kept populated while the context is unmapped,
+ * entries of an unpaged region which has been written must be cleared
+ * before the virtual range can be reused.
+ */
+static void clear_region_map(struct user_ta_ctx *utc, struct vm_region *reg)
+{
+	struct thread_specific_data *tsd = thread_get_tsd();
+	struct pgt_cache *pgt_cache = NULL;
+
+	if (!reg->mapped)
+		return;
+	/*
+	 * The mobj of a parameter region may have been freed already,
+	 * parameters are never paged anyway.
+	 */
+	if (!(reg->attr & TEE_MATTR_EPHEMERAL) && mobj_is_paged(reg->mobj))
+		return;
+
+	if (&utc->ctx == tsd->ctx)
+		pgt_cache = &tsd->pgt_cache;
+
+	pgt_clear_ctx_range(pgt_cache, &utc->ctx, reg->va,
+			    reg->va + reg->size - 1);
+	reg->mapped = false;
+}
+
 TEE_Result vm_set_prot(struct user_ta_ctx *utc, vaddr_t va, size_t len,
 		       uint32_t prot)
 {
@@ -318,8 +346,36 @@ TEE_Result vm_set_prot(struct user_ta_ctx *utc, vaddr_t va, size_t len,
 				cache_op_inner(ICACHE_AREA_INVALIDATE,
 					       (void *)va, len);
 			}
+			/* Entries are rewritten next time the ctx is mapped */
+			clear_region_map(utc, r);
 			r->attr &= ~TEE_MATTR_PROT_MASK;
 			r->attr |= prot & TEE_MATTR_PROT_MASK;
+			if (thread_get_tsd()->ctx == &utc->ctx)
+				tee_mmu_set_ctx(&utc->ctx);
+			return TEE_SUCCESS;
+		}
+	}
+
+	return TEE_ERROR_ITEM_NOT_FOUND;
+}
+
+TEE_Result vm_set_mobj(struct user_ta_ctx *utc, vaddr_t va, size_t len,
+		       struct mobj *mobj, size_t offs)
+{
+	struct vm_region *r;
+
+	TAILQ_FOREACH(r, &utc->vm_info->regions, link) {
+		if (core_is_buffer_intersect(r->va, r->size, va, len)) {
+			if (r->va != va || r->size != len ||
+			    mobj_is_paged(r->mobj) || mobj_is_paged(mobj) ||
+			    offs + len > ROUNDUP(mobj->size, SMALL_PAGE_SIZE))
+				return TEE_ERROR_BAD_PARAMETERS;
+
+			clear_region_map(utc, r);
+			r->mobj = mobj;
+			r->offset = offs;
+			if (thread_get_tsd()->ctx == &utc->ctx)
+				tee_mmu_set_ctx(&utc->ctx);
 			return TEE_SUCCESS;
 		}
 	}
@@ -376,20 +432,171 @@ TEE_Result vm_info_init(struct user_ta_ctx *utc)
 	return res;
 }
 
-static void umap_remove_region(struct vm_info *vmi, struct vm_region *reg)
+/*
+ * Parameter regions of registered shared memory are kept mapped between
+ * invocations, see clear_param_map(). Such a region holds a reference to
+ * its MOBJ which is tracked here together with the context. The entry is
+ * busy while the region is used by an invocation, when idle the
+ * translation entries can only be in the tables saved in the cache.
+ * When normal world unregisters the shared memory the entries of idle
+ * regions are cleared and the reference is dropped, the region itself is
+ * removed the next time parameters are mapped in the context.
+ */
+struct param_map {
+	struct user_ta_ctx *utc;
+	struct vm_region *reg;
+	struct mobj *mobj;	/* NULL once the reference is dropped */
+	bool busy;
+	SLIST_ENTRY(param_map) link;
+};
+
+static SLIST_HEAD(param_map_head, param_map) param_maps =
+	SLIST_HEAD_INITIALIZER(param_map_head);
+static struct mutex param_map_mu = MUTEX_INITIALIZER;
+
+static struct param_map *find_param_map(struct vm_region *reg)
+{
+	struct param_map *pm = NULL;
+
+	SLIST_FOREACH(pm, &param_maps, link)
+		if (pm->reg == reg)
+			return pm;
+
+	return NULL;
+}
+
+static void add_param_map(struct user_ta_ctx *utc, vaddr_t va)
 {
-	TAILQ_REMOVE(&vmi->regions, reg, link);
+	struct param_map *pm = NULL;
+	struct vm_region *reg = NULL;
+
+	TAILQ_FOREACH(reg, &utc->vm_info->regions, link)
+		if (reg->va == va)
+			break;
+	assert(reg);
+
+	pm = calloc(1, sizeof(*pm));
+	if (!pm)
+		return;	/* Just not kept for the next invoke */
+	pm->mobj = mobj_reg_shm_get(reg->mobj);
+	if (!pm->mobj) {
+		free(pm);
+		return;
+	}
+	pm->utc = utc;
+	pm->reg = reg;
+	pm->busy = true;
+	SLIST_INSERT_HEAD(&param_maps, pm, link);
+}
+
+static void del_param_map(struct vm_region *reg)
+{
+	struct param_map *pm = find_param_map(reg);
+
+	if (!pm)
+		return;
+	if (pm->mobj)
+		mobj_reg_shm_put(pm->mobj);
+	SLIST_REMOVE(&param_maps, pm, param_map, link);
+	free(pm);
+}
+
+/* param_map_mu must be held when removing a parameter region */
+static void umap_remove_region(struct user_ta_ctx *utc, struct vm_region *reg)
+{
+	clear_region_map(utc, reg);
+	if (reg->attr & TEE_MATTR_EPHEMERAL)
+		del_param_map(reg);
+	TAILQ_REMOVE(&utc->vm_info->regions, reg, link);
 	free(reg);
 }
 
-static void clear_param_map(struct user_ta_ctx *utc)
+/*
+ * Returns true if @r maps exactly the parameter described by @mem.
+ *
+ * The mobj pointer alone doesn't identify a buffer, the mobj of the
+ * previous invoke may have been freed and a new one allocated at the same
+ * address. Only regions still holding a reference to their registered
+ * shared memory are recognized.
+ */
+static bool param_region_matches(struct vm_region *r, struct param_mem *mem)
+{
+	struct param_map *pm = find_param_map(r);
+
+	if (!pm || !pm->mobj || pm->mobj != mem->mobj)
+		return false;
+	if (mem->read_only == !!(r->attr & TEE_MATTR_UW))
+		return false;
+	if (r->offset != mem->offs ||
+	    r->size != ROUNDUP(mem->size, SMALL_PAGE_SIZE))
+		return false;
+
+	pm->busy = true;
+	return true;
+}
+
+/*
+ * Removes all the param regions except those matching an entry in @mem,
+ * those are left mapped and are flagged in @keep. Streaming clients
+ * passing the same registered shared memory in each invoke can this way
+ * reuse the mapping of the previous invoke instead of having the
+ * translation tables and TLB updated twice per invoke.
+ */
+static void clear_param_map(struct user_ta_ctx *utc, struct param_mem *mem,
+			    size_t num_mem, bool *keep)
 {
 	struct vm_region *next_r;
 	struct vm_region *r;
+	size_t n;
 
-	TAILQ_FOREACH_SAFE(r, &utc->vm_info->regions, link, next_r)
-		if (r->attr & TEE_MATTR_EPHEMERAL)
-			umap_remove_region(utc->vm_info, r);
+	TAILQ_FOREACH_SAFE(r, &utc->vm_info->regions, link, next_r) {
+		if (!(r->attr & TEE_MATTR_EPHEMERAL))
+			continue;
+		for (n = 0; n < num_mem; n++) {
+			if (!keep[n] && param_region_matches(r, mem + n)) {
+				keep[n] = true;
+				break;
+			}
+		}
+		if (n == num_mem)
+			umap_remove_region(utc, r);
+	}
+}
+
+void tee_mmu_end_param(struct user_ta_ctx *utc)
+{
+	struct param_map *pm = NULL;
+
+	mutex_lock(&param_map_mu);
+	SLIST_FOREACH(pm, &param_maps, link)
+		if (pm->utc == utc)
+			pm->busy = false;
+	mutex_unlock(&param_map_mu);
+}
+
+void tee_mmu_release_shm_param_maps(struct mobj *mobj)
+{
+	struct param_map *pm = NULL;
+	struct vm_region *reg = NULL;
+
+	mutex_lock(&param_map_mu);
+	SLIST_FOREACH(pm, &param_maps, link) {
+		if (pm->mobj != mobj || pm->busy)
+			continue;
+		/*
+		 * The context isn't active so its tables are all in the
+		 * cache. With the entries cleared the region is treated as
+		 * unmapped until it's removed.
+		 */
+		reg = pm->reg;
+		pgt_clear_ctx_range(NULL, &pm->utc->ctx, reg->va,
+				    reg->va + reg->size - 1);
+		reg->mapped = false;
+		/* The caller holds a reference too, this can't free it */
+		mobj_reg_shm_put(pm->mobj);
+		pm->mobj = NULL;
+	}
+	mutex_unlock(&param_map_mu);
 }
 
 static TEE_Result param_mem_to_user_va(struct user_ta_ctx *utc,
@@ -405,6 +612,8 @@ static TEE_Result param_mem_to_user_va(struct user_ta_ctx *utc,
 			continue;
 		if (mem->mobj != region->mobj)
 			continue;
+		if (mem->read_only == !!(region->attr & TEE_MATTR_UW))
+			continue;
 		if (mem->offs < region->offset)
 			continue;
 		if (mem->offs >= (region->offset + region->size))
@@ -440,6 +649,10 @@ static int cmp_param_mem(const void *a0, const void *a1)
 	if (ret)
 		return ret;
 
+	ret = CMP_TRILEAN(m0->read_only, m1->read_only);
+	if (ret)
+		return ret;
+
 	ret = CMP_TRILEAN(m0->offs, m1->offs);
 	if (ret)
 		return ret;
@@ -454,6 +667,7 @@ TEE_Result tee_mmu_map_param(struct user_ta_ctx *utc,
 	size_t n;
 	size_t m;
 	struct param_mem mem[TEE_NUM_PARAMS];
+	bool keep[TEE_NUM_PARAMS] = { false };
 
 	memset(mem, 0, sizeof(mem));
 	for (n = 0; n < TEE_NUM_PARAMS; n++) {
@@ -472,12 +686,13 @@ TEE_Result tee_mmu_map_param(struct user_ta_ctx *utc,
 		mem[n].size = ROUNDUP(phys_offs + param->u[n].mem.offs -
 				      mem[n].offs + param->u[n].mem.size,
 				      CORE_MMU_USER_PARAM_SIZE);
+		mem[n].read_only = param->u[n].mem.read_only;
 	}
 
 	/*
 	 * Sort arguments so size = 0 is last, secure mobjs first, then by
-	 * mobj pointer value since those entries can't be merged either,
-	 * finally by offset.
+	 * mobj pointer value and read-only flag since those entries can't
+	 * be merged either, finally by offset.
 	 *
 	 * This should result in a list where all mergeable entries are
 	 * next to each other and unused/invalid entries are at the end.
@@ -486,6 +701,7 @@ TEE_Result tee_mmu_map_param(struct user_ta_ctx *utc,
 
 	for (n = 1, m = 0; n < TEE_NUM_PARAMS && mem[n].size; n++) {
 		if (mem[n].mobj == mem[m].mobj &&
+		    mem[n].read_only == mem[m].read_only &&
 		    (mem[n].offs == (mem[m].offs + mem[m].size) ||
 		     core_is_buffer_intersect(mem[m].offs, mem[m].size,
 					      mem[n].offs, mem[n].size))) {
@@ -504,19 +720,34 @@ TEE_Result tee_mmu_map_param(struct user_ta_ctx *utc,
 	if (mem[0].size)
 		m++;
 
-	/* Clear all the param entries as they can hold old information */
-	clear_param_map(utc);
+	/*
+	 * Clear the param entries as they can hold old information, except
+	 * those mapping the same buffers as this time.
+	 */
+	mutex_lock(&param_map_mu);
+	clear_param_map(utc, mem, m, keep);
 
 	for (n = 0; n < m; n++) {
 		vaddr_t va = 0;
-		const uint32_t prot = TEE_MATTR_PRW | TEE_MATTR_URW |
-				      TEE_MATTR_EPHEMERAL;
+		uint32_t prot = TEE_MATTR_PRW | TEE_MATTR_URW |
+				TEE_MATTR_EPHEMERAL;
+
+		if (keep[n])
+			continue;
+
+		if (mem[n].read_only)
+			prot = TEE_MATTR_PR | TEE_MATTR_UR |
+			       TEE_MATTR_EPHEMERAL;
 
 		res = vm_map(utc, &va, mem[n].size, prot, mem[n].mobj,
 			     mem[n].offs);
 		if (res)
-			return res;
+			break;
+		add_param_map(utc, va);
 	}
+	mutex_unlock(&param_map_mu);
+	if (res)
+		return res;
 
 	for (n = 0; n < TEE_NUM_PARAMS; n++) {
 		uint32_t param_type = TEE_PARAM_TYPE_GET(param->types, n);
@@ -562,7 +793,7 @@ TEE_Result tee_mmu_add_rwmem(struct user_ta_ctx *utc, struct mobj *mobj,
 
 	res = alloc_pgt(utc);
 	if (res)
-		umap_remove_region(utc->vm_info, reg);
+		umap_remove_region(utc, reg);
 	else
 		*va = reg->va;
 
@@ -576,7 +807,7 @@ void tee_mmu_rem_rwmem(struct user_ta_ctx *utc, struct mobj *mobj, vaddr_t va)
 	TAILQ_FOREACH(reg, &utc->vm_info->regions, link) {
 		if (reg->mobj == mobj && reg->va == va) {
 			free_pgt(utc, reg->va, reg->size);
-			umap_remove_region(utc->vm_info, reg);
+			umap_remove_region(utc, reg);
 			return;
 		}
 	}
@@ -591,9 +822,12 @@ void vm_info_final(struct user_ta_ctx *utc)
 	tlbi_asid(utc->vm_info->asid);
 
 	asid_free(utc->vm_info->asid);
+	/* Release cached translation tables before the regions */
+	pgt_flush_ctx(&utc->ctx);
+	mutex_lock(&param_map_mu);
 	while (!TAILQ_EMPTY(&utc->vm_info->regions))
-		umap_remove_region(utc->vm_info,
-				   TAILQ_FIRST(&utc->vm_info->regions));
+		umap_remove_region(utc, TAILQ_FIRST(&utc->vm_info->regions));
+	mutex_unlock(&param_map_mu);
 	free(utc->vm_info);
 	utc->vm_info = NULL;
 }
@@ -59,6 +59,10 @@ struct tee_pager_area {
 	vaddr_t base;
 	size_t size;
 	struct pgt *pgt;
+	/* Initial content of [init_va, init_end) for AREA_TYPE_RW */
+	const uint8_t *init;
+	vaddr_t init_va;
+	vaddr_t init_end;
 	TAILQ_ENTRY(tee_pager_area) link;
 };
 
@@ -649,6 +653,19 @@ static void encrypt_page(struct pager_rw_pstate *rwp, void *src, void *dst)
 		panic("gcm failed");
 }
 
+/* Populates a page which hasn't been saved yet */
+static void init_page(struct tee_pager_area *area, vaddr_t page_va,
+		      void *va_alias)
+{
+	vaddr_t b = MAX(page_va, area->init_va);
+	vaddr_t e = MIN(page_va + SMALL_PAGE_SIZE, area->init_end);
+
+	memset(va_alias, 0, SMALL_PAGE_SIZE);
+	if (area->init && b < e)
+		memcpy((uint8_t *)va_alias + (b - page_va),
+		       area->init + (b - area->init_va), e - b);
+}
+
 static void tee_pager_load_page(struct tee_pager_area *area, vaddr_t page_va,
 			void *va_alias)
 {
@@ -694,7 +711,7 @@ static void tee_pager_load_page(struct tee_pager_area *area, vaddr_t page_va,
 		FMSG("Restore %p %#" PRIxVA " iv %#" PRIx64,
 			va_alias, page_va, area->u.rwp[idx].iv);
 		if (!area->u.rwp[idx].iv)
-			memset(va_alias, 0, SMALL_PAGE_SIZE);
+			init_page(area, page_va, va_alias);
 		else if (!decrypt_page(&area->u.rwp[idx], stored_page,
 				       va_alias)) {
 			EMSG("PH 0x%" PRIxVA " failed", page_va);
@@ -1074,6 +1091,39 @@ out:
 	return ret;
 }
 KEEP_PAGER(tee_pager_set_uta_area_attr);
+
+bool tee_pager_set_uta_area_init(struct user_ta_ctx *utc, vaddr_t base,
+				 size_t size, const void *init)
+{
+	struct tee_pager_area *area;
+	uint32_t exceptions;
+	vaddr_t end;
+	vaddr_t va;
+	bool ret = false;
+
+	if (!size || ADD_OVERFLOW(base, size, &end))
+		return false;
+
+	exceptions = pager_lock_check_stack(8);
+
+	/* Check that the range is covered by areas without content */
+	for (va = base; va < end; va = area->base + area->size) {
+		area = find_area(utc->areas, va);
+		if (!area || area->type != AREA_TYPE_RW || area->init)
+			goto out;
+	}
+
+	for (va = base; va < end; va = area->base + area->size) {
+		area = find_area(utc->areas, va);
+		area->init = (const uint8_t *)init + (va - base);
+		area->init_va = va;
+		area->init_end = MIN(end, area->base + area->size);
+	}
+	ret = true;
+out:
+	pager_unlock(exceptions);
+	return ret;
+}
 #endif /*CFG_PAGED_USER_TA*/
 
 static bool tee_pager_unhide_page(vaddr_t page_va)
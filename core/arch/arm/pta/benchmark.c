@@ -7,6 +7,7 @@
 #include <kernel/misc.h>
 #include <kernel/mutex.h>
 #include <kernel/pseudo_ta.h>
+#include <kernel/spinlock.h>
 #include <malloc.h>
 #include <mm/core_memprot.h>
 #include <mm/mobj.h>
@@ -29,6 +30,10 @@ static size_t bench_ts_size;
 static struct mutex bench_reg_mu = MUTEX_INITIALIZER;
 static struct mobj *bench_mobj;
 
+static unsigned int ta_load_lock = SPINLOCK_UNLOCK;
+static uint64_t ta_load_ticks[BM_TA_LOAD_NUM_PHASES];
+static uint32_t ta_load_count;
+
 static TEE_Result rpc_reg_global_buf(uint64_t type, paddr_t phta, size_t size)
 {
 	struct thread_param tpm = THREAD_PARAM_VALUE(IN, type, phta, size);
@@ -159,6 +164,45 @@ static TEE_Result unregister_benchmark(uint32_t type,
 	return res;
 }
 
+static uint32_t ticks_to_us(uint64_t ticks)
+{
+	return (ticks * 1000000) / read_cntfrq();
+}
+
+static TEE_Result get_ta_load_stats(uint32_t type,
+				    TEE_Param p[TEE_NUM_PARAMS])
+{
+	uint64_t ticks[BM_TA_LOAD_NUM_PHASES];
+	uint32_t exceptions;
+	uint32_t count;
+
+	if (type != TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INOUT,
+				    TEE_PARAM_TYPE_VALUE_OUTPUT,
+				    TEE_PARAM_TYPE_VALUE_OUTPUT,
+				    TEE_PARAM_TYPE_VALUE_OUTPUT))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	exceptions = cpu_spin_lock_xsave(&ta_load_lock);
+	memcpy(ticks, ta_load_ticks, sizeof(ticks));
+	count = ta_load_count;
+	if (p[0].value.a) {
+		memset(ta_load_ticks, 0, sizeof(ta_load_ticks));
+		ta_load_count = 0;
+	}
+	cpu_spin_unlock_xrestore(&ta_load_lock, exceptions);
+
+	p[0].value.a = count;
+	p[0].value.b = 0;
+	p[1].value.a = ticks_to_us(ticks[BM_TA_LOAD_RPC]);
+	p[1].value.b = ticks_to_us(ticks[BM_TA_LOAD_VERIFY]);
+	p[2].value.a = ticks_to_us(ticks[BM_TA_LOAD_HASH]);
+	p[2].value.b = ticks_to_us(ticks[BM_TA_LOAD_RELOCATE]);
+	p[3].value.a = ticks_to_us(ticks[BM_TA_LOAD_MAP]);
+	p[3].value.b = ticks_to_us(ticks[BM_TA_LOAD_TOTAL]);
+
+	return TEE_SUCCESS;
+}
+
 static TEE_Result invoke_command(void *session_ctx __unused,
 		uint32_t cmd_id, uint32_t param_types,
 		TEE_Param params[TEE_NUM_PARAMS])
@@ -170,6 +214,8 @@ static TEE_Result invoke_command(void *session_ctx __unused,
 		return get_benchmark_memref(param_types, params);
 	case BENCHMARK_CMD_UNREGISTER:
 		return unregister_benchmark(param_types, params);
+	case BENCHMARK_CMD_GET_TA_LOAD_STATS:
+		return get_ta_load_stats(param_types, params);
 	default:
 		break;
 	}
@@ -212,3 +258,15 @@ void bm_timestamp(void)
 
 	thread_unmask_exceptions(exceptions);
 }
+
+void bm_ta_load_add(enum bm_ta_load_phase phase, uint64_t start)
+{
+	uint64_t ticks = read_cntpct() - start;
+	uint32_t exceptions;
+
+	exceptions = cpu_spin_lock_xsave(&ta_load_lock);
+	ta_load_ticks[phase] += ticks;
+	if (phase == BM_TA_LOAD_TOTAL)
+		ta_load_count++;
+	cpu_spin_unlock_xrestore(&ta_load_lock, exceptions);
+}
@@ -0,0 +1,502 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2018, Linaro Limited
+ */
+
+#include <arm.h>
+#include <crypto/crypto.h>
+#include <crypto/internal_aes-gcm.h>
+#include <malloc.h>
+#include <pta_invoke_tests.h>
+#include <string.h>
+#include <trace.h>
+#include <utee_defines.h>
+#include <util.h>
+
+#include "core_self_tests.h"
+
+#define GCM_PERF_BUF_SIZE	4096
+#define GCM_PERF_TA_CHUNK	256
+
+static const uint8_t gcm_perf_key[16] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+};
+
+static const uint8_t gcm_perf_nonce[12] = {
+	0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad,
+	0xde, 0xca, 0xf8, 0x88,
+};
+
+/*
+ * Known answer tests, test cases 3, 4 and 16 are from "The Galois/Counter
+ * Mode of Operation (GCM)" by McGrew and Viega, as used in the NIST
+ * validation. Their payloads are at most four blocks, so the other cases
+ * reuse the keys, IV and AAD of those with longer payloads to cover the
+ * four block path with remaining full and partial blocks. The IV of all
+ * cases is gcm_perf_nonce.
+ */
+static const uint8_t gcm_kat_key[32] = {
+	0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+	0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,
+	0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+	0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,
+};
+
+static const uint8_t gcm_kat_aad[20] = {
+	0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+	0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+	0xab, 0xad, 0xda, 0xd2,
+};
+
+static const uint8_t gcm_kat_pt[64] = {
+	0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5,
+	0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+	0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda,
+	0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+	0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53,
+	0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+	0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57,
+	0xba, 0x63, 0x7b, 0x39, 0x1a, 0xaf, 0xd2, 0x55,
+};
+
+/* Test cases 3 and 4, AES-128 */
+static const uint8_t gcm_kat_ct128[64] = {
+	0x42, 0x83, 0x1e, 0xc2, 0x21, 0x77, 0x74, 0x24,
+	0x4b, 0x72, 0x21, 0xb7, 0x84, 0xd0, 0xd4, 0x9c,
+	0xe3, 0xaa, 0x21, 0x2f, 0x2c, 0x02, 0xa4, 0xe0,
+	0x35, 0xc1, 0x7e, 0x23, 0x29, 0xac, 0xa1, 0x2e,
+	0x21, 0xd5, 0x14, 0xb2, 0x54, 0x66, 0x93, 0x1c,
+	0x7d, 0x8f, 0x6a, 0x5a, 0xac, 0x84, 0xaa, 0x05,
+	0x1b, 0xa3, 0x0b, 0x39, 0x6a, 0x0a, 0xac, 0x97,
+	0x3d, 0x58, 0xe0, 0x91, 0x47, 0x3f, 0x59, 0x85,
+};
+
+/* Test case 16, AES-256 */
+static const uint8_t gcm_kat_ct256[60] = {
+	0x52, 0x2d, 0xc1, 0xf0, 0x99, 0x56, 0x7d, 0x07,
+	0xf4, 0x7f, 0x37, 0xa3, 0x2a, 0x84, 0x42, 0x7d,
+	0x64, 0x3a, 0x8c, 0xdc, 0xbf, 0xe5, 0xc0, 0xc9,
+	0x75, 0x98, 0xa2, 0xbd, 0x25, 0x55, 0xd1, 0xaa,
+	0x8c, 0xb0, 0x8e, 0x48, 0x59, 0x0d, 0xbb, 0x3d,
+	0xa7, 0xb0, 0x8b, 0x10, 0x56, 0x82, 0x88, 0x38,
+	0xc5, 0xf6, 0x1e, 0x63, 0x93, 0xba, 0x7a, 0x0a,
+	0xbc, 0xc9, 0xf6, 0x62,
+};
+
+/* AES-128 with the payload 0x00, 0x01, 0x02, ... */
+static const uint8_t gcm_kat_ct128_seq[135] = {
+	0x9b, 0xb3, 0x2e, 0xe4, 0xdd, 0xf6, 0x74, 0xc6,
+	0xe6, 0x22, 0x22, 0x79, 0x27, 0x28, 0xfc, 0x09,
+	0x75, 0x1c, 0x9a, 0x6f, 0x2d, 0x23, 0x45, 0x2d,
+	0x03, 0x94, 0x54, 0x05, 0xbf, 0x80, 0x35, 0x43,
+	0x1d, 0xc8, 0x3a, 0x04, 0xe5, 0x2b, 0xbc, 0x68,
+	0x7a, 0x69, 0x4e, 0x55, 0xc9, 0x0f, 0x31, 0x0f,
+	0x9a, 0xf8, 0xd4, 0xff, 0xf4, 0x32, 0x7c, 0xf7,
+	0xbf, 0x02, 0xa1, 0x93, 0x61, 0xad, 0xb5, 0xef,
+	0x9d, 0xe9, 0x25, 0x87, 0x8a, 0xb7, 0xf7, 0xb6,
+	0xf0, 0xe0, 0xb5, 0x02, 0x86, 0x6d, 0xc5, 0x2e,
+	0x46, 0x89, 0xa6, 0xa2, 0x97, 0x9c, 0x71, 0x68,
+	0x7b, 0x8e, 0x02, 0x47, 0x9f, 0x2e, 0xba, 0x3e,
+	0x90, 0x7f, 0x3e, 0xdc, 0xc1, 0x4a, 0x26, 0x95,
+	0x38, 0x65, 0x6d, 0xaf, 0x73, 0x5a, 0x1f, 0x1e,
+	0xb1, 0xcc, 0x86, 0xc6, 0x14, 0x13, 0xf5, 0x07,
+	0xfc, 0xf3, 0xd0, 0x4d, 0x7a, 0x67, 0xe9, 0x27,
+	0x7e, 0x57, 0x7f, 0x32, 0x6c, 0xbe, 0x22,
+};
+
+/* AES-256 with the payload 0x00, 0x01, 0x02, ... */
+static const uint8_t gcm_kat_ct256_seq[199] = {
+	0x8b, 0x1d, 0xf1, 0xd6, 0x65, 0xd7, 0x7d, 0xe5,
+	0x59, 0x2f, 0x34, 0x6d, 0x89, 0x7c, 0x6a, 0xe8,
+	0xf2, 0x8c, 0x37, 0x9c, 0xbe, 0xc4, 0x21, 0x04,
+	0x43, 0xcd, 0x88, 0x9b, 0xb3, 0x79, 0x45, 0xc7,
+	0xb0, 0xad, 0xa0, 0xfe, 0xe8, 0x40, 0x94, 0x49,
+	0xa0, 0x56, 0xaf, 0x1f, 0x33, 0x09, 0x13, 0x32,
+	0x44, 0xad, 0xc1, 0xa5, 0x0d, 0x82, 0xaa, 0x6a,
+	0x3e, 0x93, 0xb7, 0x60, 0xaf, 0x12, 0xf9, 0xc7,
+	0x24, 0xee, 0x39, 0x15, 0xa4, 0xa8, 0x3b, 0x0d,
+	0x00, 0xdc, 0xc4, 0x56, 0xba, 0xb5, 0xae, 0xa0,
+	0x8c, 0xcf, 0xbc, 0xe7, 0xbf, 0x43, 0xff, 0x5e,
+	0x03, 0x2e, 0x47, 0x8d, 0x04, 0x99, 0x47, 0xaa,
+	0x07, 0x9a, 0xf6, 0xeb, 0x7e, 0x11, 0xf5, 0x14,
+	0x3d, 0x36, 0xb7, 0x16, 0x1c, 0x5a, 0xa3, 0xc2,
+	0xf0, 0xff, 0x1b, 0xcc, 0x1a, 0xbe, 0x72, 0xb8,
+	0xd6, 0x4a, 0x51, 0xd4, 0x69, 0xf4, 0x9a, 0x2c,
+	0x3c, 0x18, 0xb3, 0x62, 0x60, 0x61, 0xab, 0xa4,
+	0x02, 0x67, 0x45, 0x35, 0x83, 0xa5, 0xc2, 0xd0,
+	0xda, 0xc0, 0x5b, 0xf1, 0x7b, 0x41, 0x6c, 0xa2,
+	0xcf, 0x8f, 0xea, 0x3a, 0xa5, 0x65, 0x10, 0xe6,
+	0x5c, 0x50, 0xd9, 0x37, 0x3c, 0xa3, 0x3d, 0x90,
+	0xf9, 0xbc, 0x09, 0xdb, 0x6a, 0x51, 0xd3, 0x24,
+	0xfd, 0xee, 0xab, 0xe1, 0x1a, 0xef, 0xcb, 0xa6,
+	0x48, 0x55, 0xa7, 0x1e, 0xc0, 0x40, 0x79, 0x6d,
+	0x18, 0xdd, 0xe7, 0xd7, 0x62, 0xc2, 0xca,
+};
+
+struct gcm_kat {
+	size_t key_len;
+	size_t aad_len;
+	const uint8_t *pt;	/* NULL for the payload 0x00, 0x01, 0x02, ... */
+	const uint8_t *ct;
+	size_t len;
+	uint8_t tag[TEE_AES_BLOCK_SIZE];
+};
+
+static const struct gcm_kat gcm_kats[] = {
+	/* Test case 3: four blocks, no AAD */
+	{ .key_len = 16, .aad_len = 0, .pt = gcm_kat_pt, .ct = gcm_kat_ct128,
+	  .len = 64, .tag = {
+		0x4d, 0x5c, 0x2a, 0xf3, 0x27, 0xcd, 0x64, 0xa6,
+		0x2c, 0xf3, 0x5a, 0xbd, 0x2b, 0xa6, 0xfa, 0xb4,
+	} },
+	/* Test case 4: three blocks and a partial block */
+	{ .key_len = 16, .aad_len = 20, .pt = gcm_kat_pt,
+	  .ct = gcm_kat_ct128, .len = 60, .tag = {
+		0x5b, 0xc9, 0x4f, 0xbc, 0x32, 0x21, 0xa5, 0xdb,
+		0x94, 0xfa, 0xe9, 0x5a, 0xe7, 0x12, 0x1a, 0x47,
+	} },
+	/* Test case 16: AES-256, three blocks and a partial block */
+	{ .key_len = 32, .aad_len = 20, .pt = gcm_kat_pt,
+	  .ct = gcm_kat_ct256, .len = 60, .tag = {
+		0x76, 0xfc, 0x6e, 0xce, 0x0f, 0x4e, 0x17, 0x68,
+		0xcd, 0xdf, 0x88, 0x53, 0xbb, 0x2d, 0x55, 0x1b,
+	} },
+	/* Five blocks */
+	{ .key_len = 16, .aad_len = 20, .ct = gcm_kat_ct128_seq, .len = 80,
+	  .tag = {
+		0xa9, 0xaa, 0x4c, 0x94, 0x45, 0x15, 0x6a, 0xea,
+		0x45, 0xad, 0xda, 0x65, 0xfe, 0x3f, 0x78, 0x85,
+	} },
+	/* Six blocks and a partial block */
+	{ .key_len = 16, .aad_len = 20, .ct = gcm_kat_ct128_seq, .len = 111,
+	  .tag = {
+		0xab, 0x37, 0x90, 0x76, 0x94, 0xe2, 0x19, 0x37,
+		0x7d, 0x9e, 0x71, 0x4b, 0xf8, 0xd2, 0xa9, 0x88,
+	} },
+	/* Eight blocks and a partial block */
+	{ .key_len = 16, .aad_len = 20, .ct = gcm_kat_ct128_seq, .len = 135,
+	  .tag = {
+		0x47, 0x25, 0xa2, 0xfc, 0x10, 0x94, 0xd8, 0xec,
+		0xdd, 0xad, 0x31, 0x5a, 0x04, 0xff, 0xe0, 0x86,
+	} },
+	/* AES-256, twelve blocks and a partial block */
+	{ .key_len = 32, .aad_len = 20, .ct = gcm_kat_ct256_seq, .len = 199,
+	  .tag = {
+		0x0a, 0x82, 0x98, 0x0b, 0x7e, 0x07, 0xda, 0x70,
+		0x32, 0x01, 0x76, 0x1a, 0x6b, 0x91, 0x6e, 0x04,
+	} },
+};
+
+#define GCM_KAT_MAX_LEN		256
+
+/* Alternating update sizes, so updates start on and off block boundaries */
+static const size_t gcm_kat_chunks[] = { 23, 69 };
+
+static TEE_Result gcm_kat_one_shot(const struct gcm_kat *kat,
+				   const uint8_t *pt, uint8_t *buf)
+{
+	struct internal_aes_gcm_key ek;
+	uint8_t tag[TEE_AES_BLOCK_SIZE];
+	size_t tag_len = sizeof(tag);
+	TEE_Result res;
+
+	res = internal_aes_gcm_expand_enc_key(gcm_kat_key, kat->key_len, &ek);
+	if (res)
+		return res;
+
+	res = internal_aes_gcm_enc(&ek, gcm_perf_nonce, sizeof(gcm_perf_nonce),
+				   gcm_kat_aad, kat->aad_len, pt, kat->len,
+				   buf, tag, &tag_len);
+	if (res)
+		return res;
+	if (memcmp(buf, kat->ct, kat->len) ||
+	    memcmp(tag, kat->tag, sizeof(tag))) {
+		EMSG("Encryption of %zu bytes: wrong ciphertext or tag",
+		     kat->len);
+		return TEE_ERROR_GENERIC;
+	}
+
+	res = internal_aes_gcm_dec(&ek, gcm_perf_nonce, sizeof(gcm_perf_nonce),
+				   gcm_kat_aad, kat->aad_len, kat->ct,
+				   kat->len, buf, kat->tag, sizeof(kat->tag));
+	if (res)
+		return res;
+	if (memcmp(buf, pt, kat->len)) {
+		EMSG("Decryption of %zu bytes: wrong plaintext", kat->len);
+		return TEE_ERROR_GENERIC;
+	}
+
+	tag[0] ^= 1;
+	res = internal_aes_gcm_dec(&ek, gcm_perf_nonce, sizeof(gcm_perf_nonce),
+				   gcm_kat_aad, kat->aad_len, kat->ct,
+				   kat->len, buf, tag, sizeof(tag));
+	if (res != TEE_ERROR_MAC_INVALID) {
+		EMSG("Decryption of %zu bytes: bad tag not detected", kat->len);
+		return TEE_ERROR_GENERIC;
+	}
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result gcm_kat_chunked(const struct gcm_kat *kat,
+				  TEE_OperationMode mode, const uint8_t *pt,
+				  uint8_t *buf)
+{
+	const uint8_t *src = (mode == TEE_MODE_ENCRYPT) ? pt : kat->ct;
+	const uint8_t *exp = (mode == TEE_MODE_ENCRYPT) ? kat->ct : pt;
+	struct internal_aes_gcm_ctx ctx;
+	uint8_t tag[TEE_AES_BLOCK_SIZE];
+	size_t tag_len = sizeof(tag);
+	size_t chunk = 0;
+	size_t pos = 0;
+	size_t n = 0;
+	TEE_Result res;
+
+	res = internal_aes_gcm_init(&ctx, mode, gcm_kat_key, kat->key_len,
+				    gcm_perf_nonce, sizeof(gcm_perf_nonce),
+				    sizeof(tag));
+	if (res)
+		return res;
+
+	res = internal_aes_gcm_update_aad(&ctx, gcm_kat_aad, kat->aad_len);
+	if (res)
+		return res;
+
+	while (true) {
+		chunk = gcm_kat_chunks[n % ARRAY_SIZE(gcm_kat_chunks)];
+		if (kat->len - pos <= chunk)
+			break;
+		res = internal_aes_gcm_update_payload(&ctx, mode, src + pos,
+						      chunk, buf + pos);
+		if (res)
+			return res;
+		pos += chunk;
+		n++;
+	}
+
+	if (mode == TEE_MODE_ENCRYPT) {
+		res = internal_aes_gcm_enc_final(&ctx, src + pos,
+						 kat->len - pos, buf + pos,
+						 tag, &tag_len);
+		if (!res && memcmp(tag, kat->tag, sizeof(tag)))
+			res = TEE_ERROR_MAC_INVALID;
+	} else {
+		res = internal_aes_gcm_dec_final(&ctx, src + pos,
+						 kat->len - pos, buf + pos,
+						 kat->tag, sizeof(kat->tag));
+	}
+	if (res)
+		return res;
+
+	if (memcmp(buf, exp, kat->len)) {
+		EMSG("%s of %zu bytes in chunks: wrong output",
+		     mode == TEE_MODE_ENCRYPT ? "Encryption" : "Decryption",
+		     kat->len);
+		return TEE_ERROR_GENERIC;
+	}
+
+	return TEE_SUCCESS;
+}
+
+/*
+ * Checks AES-GCM encryption and decryption against known answers, both
+ * in one go and in updates of odd sizes. With CFG_CRYPTO_WITH_CE on
+ * ARM64 this covers the four blocks at a time path followed by single
+ * blocks and a partial final block.
+ */
+TEE_Result core_aes_gcm_tests(uint32_t nParamTypes,
+			      TEE_Param pParams[TEE_NUM_PARAMS] __unused)
+{
+	TEE_Result res = TEE_SUCCESS;
+	const uint8_t *pt = NULL;
+	uint8_t *seq = NULL;
+	uint8_t *buf = NULL;
+	size_t n = 0;
+
+	if (nParamTypes)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	seq = malloc(GCM_KAT_MAX_LEN);
+	buf = malloc(GCM_KAT_MAX_LEN);
+	if (!seq || !buf) {
+		res = TEE_ERROR_OUT_OF_MEMORY;
+		goto out;
+	}
+
+	for (n = 0; n < GCM_KAT_MAX_LEN; n++)
+		seq[n] = n;
+
+	for (n = 0; n < ARRAY_SIZE(gcm_kats) && !res; n++) {
+		pt = gcm_kats[n].pt;
+		if (!pt)
+			pt = seq;
+
+		res = gcm_kat_one_shot(gcm_kats + n, pt, buf);
+		if (!res)
+			res = gcm_kat_chunked(gcm_kats + n, TEE_MODE_ENCRYPT,
+					      pt, buf);
+		if (!res)
+			res = gcm_kat_chunked(gcm_kats + n, TEE_MODE_DECRYPT,
+					      pt, buf);
+		if (res)
+			EMSG("AES-GCM test vector %zu failed: %#" PRIx32, n,
+			     res);
+	}
+out:
+	free(seq);
+	free(buf);
+	return res;
+}
+
+/* Mimics the pager, which encrypts and decrypts complete pages */
+static TEE_Result gcm_perf_pager(uint8_t *buf, uint8_t *tmp)
+{
+	struct internal_aes_gcm_key ek;
+	uint8_t tag[TEE_AES_BLOCK_SIZE];
+	size_t tag_len = sizeof(tag);
+	TEE_Result res;
+
+	res = internal_aes_gcm_expand_enc_key(gcm_perf_key,
+					      sizeof(gcm_perf_key), &ek);
+	if (res)
+		return res;
+
+	res = internal_aes_gcm_enc(&ek, gcm_perf_nonce, sizeof(gcm_perf_nonce),
+				   NULL, 0, buf, GCM_PERF_BUF_SIZE, tmp, tag,
+				   &tag_len);
+	if (res)
+		return res;
+
+	return internal_aes_gcm_dec(&ek, gcm_perf_nonce, sizeof(gcm_perf_nonce),
+				    NULL, 0, tmp, GCM_PERF_BUF_SIZE, buf, tag,
+				    tag_len);
+}
+
+/*
+ * Mimics the REE FS secure storage which encrypts complete blocks with
+ * some authenticated data in front of the payload.
+ */
+static TEE_Result gcm_perf_authenc(uint8_t *buf, uint8_t *tmp,
+				   size_t chunk_size)
+{
+	const uint32_t algo = TEE_ALG_AES_GCM;
+	uint8_t tag[TEE_AES_BLOCK_SIZE];
+	size_t tag_len = sizeof(tag);
+	uint8_t aad[32] = { 0 };
+	TEE_Result res;
+	void *ctx;
+	size_t dlen;
+	size_t n;
+
+	res = crypto_authenc_alloc_ctx(&ctx, algo);
+	if (res)
+		return res;
+
+	res = crypto_authenc_init(ctx, algo, TEE_MODE_ENCRYPT, gcm_perf_key,
+				  sizeof(gcm_perf_key), gcm_perf_nonce,
+				  sizeof(gcm_perf_nonce), tag_len, sizeof(aad),
+				  GCM_PERF_BUF_SIZE);
+	if (res)
+		goto out;
+
+	res = crypto_authenc_update_aad(ctx, algo, TEE_MODE_ENCRYPT, aad,
+					sizeof(aad));
+	if (res)
+		goto out;
+
+	for (n = 0; n < GCM_PERF_BUF_SIZE - chunk_size; n += chunk_size) {
+		dlen = chunk_size;
+		res = crypto_authenc_update_payload(ctx, algo,
+						    TEE_MODE_ENCRYPT, buf + n,
+						    chunk_size, tmp + n, &dlen);
+		if (res)
+			goto out;
+	}
+
+	dlen = chunk_size;
+	res = crypto_authenc_enc_final(ctx, algo, buf + n, chunk_size, tmp + n,
+				       &dlen, tag, &tag_len);
+out:
+	crypto_authenc_final(ctx, algo);
+	crypto_authenc_free_ctx(ctx, algo);
+	return res;
+}
+
+/*
+ * Reports the cost of AES-GCM as seen by the different users in core:
+ *
+ * [in]  value[0].a	Use case, PTA_INVOKE_TESTS_AES_GCM_PERF_*
+ * [in]  value[0].b	Number of iterations, each iteration processes a
+ *			4 KiB buffer
+ * [out] value[1].a	Nanoseconds per byte * 100
+ * [out] value[1].b	Elapsed time in microseconds
+ *
+ * Timed with the generic timer, the PMU cycle counter isn't necessarily
+ * enabled or accessible.
+ */
+TEE_Result core_aes_gcm_perf_tests(uint32_t nParamTypes,
+				   TEE_Param pParams[TEE_NUM_PARAMS])
+{
+	uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+					  TEE_PARAM_TYPE_VALUE_OUTPUT,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE);
+	TEE_Result res = TEE_SUCCESS;
+	uint64_t num_bytes;
+	uint64_t cnt;
+	uint64_t ns;
+	uint8_t *buf;
+	uint8_t *tmp;
+	uint32_t n;
+
+	if (nParamTypes != exp_pt || !pParams[0].value.b)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	buf = calloc(1, GCM_PERF_BUF_SIZE);
+	tmp = malloc(GCM_PERF_BUF_SIZE);
+	if (!buf || !tmp) {
+		res = TEE_ERROR_OUT_OF_MEMORY;
+		goto out;
+	}
+
+	cnt = read_cntpct();
+
+	for (n = 0; n < pParams[0].value.b && !res; n++) {
+		switch (pParams[0].value.a) {
+		case PTA_INVOKE_TESTS_AES_GCM_PERF_PAGER:
+			res = gcm_perf_pager(buf, tmp);
+			break;
+		case PTA_INVOKE_TESTS_AES_GCM_PERF_SECSTOR:
+			res = gcm_perf_authenc(buf, tmp, GCM_PERF_BUF_SIZE);
+			break;
+		case PTA_INVOKE_TESTS_AES_GCM_PERF_TA:
+			res = gcm_perf_authenc(buf, tmp, GCM_PERF_TA_CHUNK);
+			break;
+		default:
+			res = TEE_ERROR_BAD_PARAMETERS;
+			break;
+		}
+	}
+
+	cnt = read_cntpct() - cnt;
+	if (res)
+		goto out;
+
+	num_bytes = (uint64_t)pParams[0].value.b * GCM_PERF_BUF_SIZE;
+	if (pParams[0].value.a == PTA_INVOKE_TESTS_AES_GCM_PERF_PAGER)
+		num_bytes *= 2;
+
+	ns = (cnt * 1000000000) / read_cntfrq();
+	pParams[1].value.a = (ns * 100) / num_bytes;
+	pParams[1].value.b = ns / 1000;
+
+	IMSG("AES-GCM use case %" PRIu32 ": %" PRIu32 ".%02" PRIu32
+	     " ns/byte, %" PRIu32 " us for %" PRIu64 " bytes",
+	     pParams[0].value.a, pParams[1].value.a / 100,
+	     pParams[1].value.a % 100, pParams[1].value.b, num_bytes);
+out:
+	free(buf);
+	free(tmp);
+	return res;
+}
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2019, Linaro Limited
+ */
+
+#include <arm.h>
+#include <kernel/handle.h>
+#include <malloc.h>
+#include <pta_invoke_tests.h>
+#include <trace.h>
+
+#include "core_self_tests.h"
+
+/*
+ * Releases and allocates handles while value[0].a handles are held,
+ * which is what a long lived session with many objects does. The time
+ * per iteration should not depend on the number of handles held.
+ */
+TEE_Result core_handle_perf_tests(uint32_t nParamTypes,
+				  TEE_Param pParams[TEE_NUM_PARAMS])
+{
+	uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+					  TEE_PARAM_TYPE_VALUE_OUTPUT,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE);
+	struct handle_db db = HANDLE_DB_INITIALIZER;
+	uint32_t num_handles = pParams[0].value.a;
+	TEE_Result res = TEE_SUCCESS;
+	int *handles = NULL;
+	uint64_t cnt;
+	uint32_t n;
+	size_t idx;
+
+	if (nParamTypes != exp_pt || !num_handles || !pParams[0].value.b)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	handles = calloc(num_handles, sizeof(*handles));
+	if (!handles)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	/* The pointers only have to be non-NULL */
+	for (n = 0; n < num_handles; n++) {
+		handles[n] = handle_get(&db, handles + n);
+		if (handles[n] < 0) {
+			res = TEE_ERROR_OUT_OF_MEMORY;
+			goto out;
+		}
+	}
+
+	cnt = read_cntpct();
+
+	for (n = 0; n < pParams[0].value.b; n++) {
+		/* Spread the released entries over the database */
+		idx = (n * 7919) % num_handles;
+		if (handle_put(&db, handles[idx]) != handles + idx) {
+			res = TEE_ERROR_GENERIC;
+			goto out;
+		}
+		handles[idx] = handle_get(&db, handles + idx);
+		if (handles[idx] < 0) {
+			res = TEE_ERROR_OUT_OF_MEMORY;
+			goto out;
+		}
+	}
+
+	cnt = read_cntpct() - cnt;
+
+	pParams[1].value.a = (cnt * 1000000000) / read_cntfrq() /
+			     pParams[0].value.b;
+	pParams[1].value.b = (cnt * 1000000) / read_cntfrq();
+
+	IMSG("handle_db with %" PRIu32 " handles: %" PRIu32
+	     " ns per put and get, %" PRIu32 " us",
+	     num_handles, pParams[1].value.a, pParams[1].value.b);
+out:
+	handle_db_destroy(&db);
+	free(handles);
+	return res;
+}
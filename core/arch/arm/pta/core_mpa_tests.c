@@ -0,0 +1,241 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2019, Linaro Limited
+ */
+
+#include <malloc.h>
+#include <mempool.h>
+#include <mpalib.h>
+#include <pta_invoke_tests.h>
+#include <string.h>
+#include <trace.h>
+#include <util.h>
+
+#include "core_self_tests.h"
+
+#define MPA_TEST_MAX_BITS	4096
+#define MPA_TEST_NUM_VARS	20
+
+#define MPA_TEST_POOL_SIZE \
+	ROUNDUP(mpa_scratch_mem_size_in_U32(MPA_TEST_NUM_VARS, \
+					    MPA_TEST_MAX_BITS * 2) * \
+		sizeof(uint32_t), MEMPOOL_ALIGN)
+
+/*
+ * Sizes of the modulus in bits. With an even number of 32-bit words
+ * mpa_montgomery_mul() uses __mpa_montgomery_mul_a64() on ARM64, 96 and
+ * 160 bits take the generic path.
+ */
+static const size_t mpa_test_bits[] = {
+	64, 96, 128, 160, 192, 1024, 2048, 4096,
+};
+
+enum mpa_test_modulus {
+	/* 2^bits - 1, every word of the modulus is all ones */
+	MPA_TEST_MOD_ONES,
+	/* 2^(bits - 1) + 1, n_inv is all ones */
+	MPA_TEST_MOD_MIN,
+	/* Pseudo random with the most and least significant bits set */
+	MPA_TEST_MOD_RANDOM,
+	MPA_TEST_MOD_COUNT,
+};
+
+static mpa_scratch_mem_base mpa_test_pool;
+
+/* Deterministic so that a failure can be reproduced */
+static uint32_t mpa_test_rand(uint32_t *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return *state;
+}
+
+static void mpa_test_fill(uint8_t *buf, size_t len, uint32_t *state)
+{
+	size_t n;
+
+	for (n = 0; n < len; n++)
+		buf[n] = mpa_test_rand(state);
+}
+
+static TEE_Result mpa_test_init_pool(void)
+{
+	void *data;
+
+	if (mpa_test_pool.pool)
+		return TEE_SUCCESS;
+
+	data = malloc(MPA_TEST_POOL_SIZE);
+	if (!data)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	mpa_test_pool.pool = mempool_alloc_pool(data, MPA_TEST_POOL_SIZE,
+						NULL);
+	if (!mpa_test_pool.pool) {
+		free(data);
+		return TEE_ERROR_OUT_OF_MEMORY;
+	}
+	mpa_test_pool.bn_bits = MPA_TEST_MAX_BITS * 2;
+
+	return TEE_SUCCESS;
+}
+
+static void mpa_test_set_modulus(mpanum n, enum mpa_test_modulus type,
+				 uint8_t *buf, size_t len, uint32_t *state)
+{
+	switch (type) {
+	case MPA_TEST_MOD_ONES:
+		memset(buf, 0xff, len);
+		break;
+	case MPA_TEST_MOD_MIN:
+		memset(buf, 0, len);
+		buf[0] = 0x80;
+		buf[len - 1] = 0x01;
+		break;
+	default:
+		mpa_test_fill(buf, len, state);
+		buf[0] |= 0x80;
+		buf[len - 1] |= 0x01;
+		break;
+	}
+	mpa_set_oct_str(n, buf, len, false);
+}
+
+/*
+ * The Montgomery product t of a and b must be reduced and satisfy
+ * t * R = a * b (mod n), which is checked with the plain modular
+ * multiplication.
+ */
+static bool mpa_test_check_mul(mpanum a, mpanum b, mpanum n, mpanum r_modn,
+			       mpa_word_t n_inv, mpanum t, mpanum x, mpanum y)
+{
+	mpa_montgomery_mul(t, a, b, n, n_inv, &mpa_test_pool);
+	if (mpa_cmp(t, n) >= 0)
+		return false;
+
+	mpa_mul_mod(x, t, r_modn, n, &mpa_test_pool);
+	mpa_mul_mod(y, a, b, n, &mpa_test_pool);
+	return !mpa_cmp(x, y);
+}
+
+static TEE_Result mpa_test_modulus(size_t bits, enum mpa_test_modulus type,
+				   uint8_t *buf, uint32_t *state)
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t len = bits / 8;
+	mpanum n_minus_1 = NULL;
+	mpanum r2_modn = NULL;
+	mpanum r_modn = NULL;
+	mpa_word_t n_inv = 0;
+	mpanum n = NULL;
+	mpanum a = NULL;
+	mpanum b = NULL;
+	mpanum t = NULL;
+	mpanum x = NULL;
+	mpanum y = NULL;
+	const char *what = NULL;
+
+	if (!mpa_alloc_static_temp_var(&n, &mpa_test_pool) ||
+	    !mpa_alloc_static_temp_var(&n_minus_1, &mpa_test_pool) ||
+	    !mpa_alloc_static_temp_var(&r_modn, &mpa_test_pool) ||
+	    !mpa_alloc_static_temp_var(&r2_modn, &mpa_test_pool) ||
+	    !mpa_alloc_static_temp_var(&a, &mpa_test_pool) ||
+	    !mpa_alloc_static_temp_var(&b, &mpa_test_pool) ||
+	    !mpa_alloc_static_temp_var(&t, &mpa_test_pool) ||
+	    !mpa_alloc_static_temp_var(&x, &mpa_test_pool) ||
+	    !mpa_alloc_static_temp_var(&y, &mpa_test_pool)) {
+		res = TEE_ERROR_OUT_OF_MEMORY;
+		goto out;
+	}
+
+	mpa_test_set_modulus(n, type, buf, len, state);
+	if (mpa_compute_fmm_context(n, r_modn, r2_modn, &n_inv,
+				    &mpa_test_pool)) {
+		res = TEE_ERROR_GENERIC;
+		goto out;
+	}
+	mpa_sub_word(n_minus_1, n, 1, &mpa_test_pool);
+
+	/* The largest operands give the largest intermediate carries */
+	what = "(n - 1)^2";
+	if (!mpa_test_check_mul(n_minus_1, n_minus_1, n, r_modn, n_inv, t, x,
+				y))
+		goto err;
+
+	what = "(n - 1) * 1";
+	mpa_set_word(a, 1);
+	if (!mpa_test_check_mul(n_minus_1, a, n, r_modn, n_inv, t, x, y))
+		goto err;
+
+	what = "0 * (n - 1)";
+	mpa_set_word(a, 0);
+	if (!mpa_test_check_mul(a, n_minus_1, n, r_modn, n_inv, t, x, y))
+		goto err;
+
+	/* R mod n times R^2 mod n is R^2 mod n again */
+	what = "R * R^2";
+	if (!mpa_test_check_mul(r_modn, r2_modn, n, r_modn, n_inv, t, x, y))
+		goto err;
+
+	what = "random";
+	mpa_test_fill(buf, len, state);
+	mpa_set_oct_str(a, buf, len, false);
+	mpa_mod(a, a, n, &mpa_test_pool);
+	mpa_test_fill(buf, len, state);
+	mpa_set_oct_str(b, buf, len, false);
+	mpa_mod(b, b, n, &mpa_test_pool);
+	if (!mpa_test_check_mul(a, b, n, r_modn, n_inv, t, x, y))
+		goto err;
+
+	goto out;
+err:
+	EMSG("Montgomery multiplication %s failed, %zu bit modulus type %d",
+	     what, bits, type);
+	res = TEE_ERROR_GENERIC;
+out:
+	mpa_free_static_temp_var(&y, &mpa_test_pool);
+	mpa_free_static_temp_var(&x, &mpa_test_pool);
+	mpa_free_static_temp_var(&t, &mpa_test_pool);
+	mpa_free_static_temp_var(&b, &mpa_test_pool);
+	mpa_free_static_temp_var(&a, &mpa_test_pool);
+	mpa_free_static_temp_var(&r2_modn, &mpa_test_pool);
+	mpa_free_static_temp_var(&r_modn, &mpa_test_pool);
+	mpa_free_static_temp_var(&n_minus_1, &mpa_test_pool);
+	mpa_free_static_temp_var(&n, &mpa_test_pool);
+	return res;
+}
+
+/*
+ * Checks mpa_montgomery_mul() over several operand sizes, both with the
+ * AArch64 assembly and the generic C implementation, including operands
+ * which carry out of the most significant word.
+ */
+TEE_Result core_mpa_tests(uint32_t nParamTypes,
+			  TEE_Param pParams[TEE_NUM_PARAMS] __unused)
+{
+	TEE_Result res = TEE_SUCCESS;
+	uint32_t state = 0x2545f491;
+	uint8_t *buf = NULL;
+	size_t n = 0;
+	int type = 0;
+
+	if (nParamTypes)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	res = mpa_test_init_pool();
+	if (res)
+		return res;
+
+	buf = malloc(MPA_TEST_MAX_BITS / 8);
+	if (!buf)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	for (n = 0; n < ARRAY_SIZE(mpa_test_bits) && !res; n++)
+		for (type = 0; type < MPA_TEST_MOD_COUNT && !res; type++)
+			res = mpa_test_modulus(mpa_test_bits[n], type, buf,
+					       &state);
+
+	free(buf);
+	return res;
+}
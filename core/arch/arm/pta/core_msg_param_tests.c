@@ -0,0 +1,497 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2019, Linaro Limited
+ */
+
+#include <kernel/msg_param.h>
+#include <kernel/panic.h>
+#include <mm/core_memprot.h>
+#include <mm/core_mmu.h>
+#include <mm/mobj.h>
+#include <mm/tee_mm.h>
+#include <optee_msg.h>
+#include <pta_invoke_tests.h>
+#include <stdlib.h>
+#include <string.h>
+#include <trace.h>
+#include <util.h>
+
+#include "core_self_tests.h"
+
+#define BATCH_META	(OPTEE_MSG_ATTR_META | \
+			 OPTEE_MSG_ATTR_TYPE_VALUE_INOUT)
+#define BATCH_MAX_PARAMS	10
+
+/*
+ * Describes a batch as a list of parameters, a parameter with @attr
+ * BATCH_META starts an entry with function @a and @b parameters.
+ */
+struct batch_test_param {
+	uint64_t attr;
+	uint64_t a;
+	uint64_t b;
+};
+
+struct batch_test {
+	const char *name;
+	size_t num_params;
+	struct batch_test_param params[BATCH_MAX_PARAMS];
+	/* Number of entries or -1 if the batch is malformed */
+	int num_entries;
+	/* Index of the meta parameter of each entry */
+	uint32_t idx[BATCH_MAX_PARAMS];
+};
+
+#define VAL_IN		{ .attr = OPTEE_MSG_ATTR_TYPE_VALUE_INPUT }
+#define META(f, n)	{ .attr = BATCH_META, .a = (f), .b = (n) }
+
+static const struct batch_test batch_tests[] = {
+	{
+		.name = "valid",
+		.num_params = 9,
+		.params = { META(1, 2), VAL_IN, VAL_IN, META(2, 0),
+			    META(3, 4), VAL_IN, VAL_IN, VAL_IN, VAL_IN },
+		.num_entries = 3,
+		.idx = { 0, 3, 4 },
+	},
+	{
+		.name = "single entry",
+		.num_params = 1,
+		.params = { META(1, 0) },
+		.num_entries = 1,
+		.idx = { 0 },
+	},
+	{
+		.name = "empty",
+		.num_params = 0,
+		.num_entries = -1,
+	},
+	{
+		.name = "no meta first",
+		.num_params = 2,
+		.params = { VAL_IN, META(1, 0) },
+		.num_entries = -1,
+	},
+	{
+		.name = "meta of wrong type",
+		.num_params = 1,
+		.params = { { .attr = OPTEE_MSG_ATTR_META |
+				      OPTEE_MSG_ATTR_TYPE_VALUE_INPUT } },
+		.num_entries = -1,
+	},
+	{
+		/* The first entry is fine, the last must not be invoked */
+		.name = "last entry past the end",
+		.num_params = 3,
+		.params = { META(1, 1), VAL_IN, META(2, 1) },
+		.num_entries = -1,
+	},
+	{
+		.name = "entry with too many params",
+		.num_params = 6,
+		.params = { META(1, TEE_NUM_PARAMS + 1), VAL_IN, VAL_IN,
+			    VAL_IN, VAL_IN, VAL_IN },
+		.num_entries = -1,
+	},
+	{
+		.name = "entry not starting with meta",
+		.num_params = 4,
+		.params = { META(1, 1), VAL_IN, VAL_IN, META(2, 0) },
+		.num_entries = -1,
+	},
+	{
+		.name = "function out of range",
+		.num_params = 2,
+		.params = { META(1, 0), META(UINT64_C(1) << 32, 0) },
+		.num_entries = -1,
+	},
+	{
+		.name = "huge param count",
+		.num_params = 2,
+		.params = { META(1, UINT64_MAX), VAL_IN },
+		.num_entries = -1,
+	},
+};
+
+static TEE_Result test_batch(const struct batch_test *t)
+{
+	struct msg_param_batch_entry entries[BATCH_MAX_PARAMS] = { };
+	struct optee_msg_param params[BATCH_MAX_PARAMS] = { };
+	size_t num_entries = 0;
+	TEE_Result res = TEE_SUCCESS;
+	size_t n = 0;
+
+	for (n = 0; n < t->num_params; n++) {
+		params[n].attr = t->params[n].attr;
+		params[n].u.value.a = t->params[n].a;
+		params[n].u.value.b = t->params[n].b;
+	}
+
+	res = msg_param_get_batch(params, t->num_params, entries,
+				  &num_entries);
+	if (t->num_entries < 0) {
+		if (res != TEE_ERROR_BAD_PARAMETERS) {
+			EMSG("%s: accepted malformed batch: %#" PRIx32,
+			     t->name, res);
+			return TEE_ERROR_GENERIC;
+		}
+		return TEE_SUCCESS;
+	}
+
+	if (res) {
+		EMSG("%s: %#" PRIx32, t->name, res);
+		return TEE_ERROR_GENERIC;
+	}
+	if (num_entries != (size_t)t->num_entries) {
+		EMSG("%s: %zu entries, expected %d", t->name, num_entries,
+		     t->num_entries);
+		return TEE_ERROR_GENERIC;
+	}
+	for (n = 0; n < num_entries; n++) {
+		const struct batch_test_param *meta = t->params + t->idx[n];
+
+		if (entries[n].idx != t->idx[n] ||
+		    entries[n].func != meta->a ||
+		    entries[n].num_params != meta->b) {
+			EMSG("%s: bad entry %zu", t->name, n);
+			return TEE_ERROR_GENERIC;
+		}
+	}
+
+	return TEE_SUCCESS;
+}
+
+/* Pages of the buffer from normal world used by the page list tests */
+#define LIST_TEST_PAGES		4
+#define LIST_ENTRIES_PER_PAGE	(OPTEE_MSG_NONCONTIG_PAGE_SIZE / \
+				 sizeof(uint64_t) - 1)
+#define BLOCK_PAGES		(CORE_MMU_PGDIR_SIZE / SMALL_PAGE_SIZE)
+
+/*
+ * The buffer from normal world, @pa is the physical address of the first
+ * whole page and @va where it's mapped in the core.
+ */
+struct list_test_buf {
+	paddr_t pa;
+	uint64_t *va;
+};
+
+static uint64_t run_entry(paddr_t pa, size_t num_pages)
+{
+	return pa | (num_pages - 1);
+}
+
+/*
+ * Registers the list of runs at the start of the buffer as a buffer of
+ * @num_pages and checks that the pages are the @num_pages entries in
+ * @expect, or that registration fails if @expect is NULL.
+ */
+static TEE_Result check_list(struct list_test_buf *buf, const char *name,
+			     size_t num_pages, const paddr_t *expect)
+{
+	struct mobj *mobj = NULL;
+	TEE_Result res = TEE_SUCCESS;
+	paddr_t pa = 0;
+	size_t n = 0;
+
+	mobj = msg_param_mobj_from_noncontig(buf->pa,
+					     num_pages * SMALL_PAGE_SIZE, 0,
+					     false);
+	if (!expect) {
+		if (mobj) {
+			EMSG("%s: malformed list registered", name);
+			mobj_free(mobj);
+			return TEE_ERROR_GENERIC;
+		}
+		return TEE_SUCCESS;
+	}
+	if (!mobj) {
+		EMSG("%s: can't register list", name);
+		return TEE_ERROR_GENERIC;
+	}
+
+	if (mobj->size != num_pages * SMALL_PAGE_SIZE) {
+		EMSG("%s: size %zu, expected %zu pages", name, mobj->size,
+		     num_pages);
+		res = TEE_ERROR_GENERIC;
+	}
+	for (n = 0; n < num_pages && !res; n++) {
+		res = mobj_get_pa(mobj, n * SMALL_PAGE_SIZE, 0, &pa);
+		if (!res && pa != expect[n]) {
+			EMSG("%s: page %zu at %#" PRIxPA ", expected %#"
+			     PRIxPA, name, n, pa, expect[n]);
+			res = TEE_ERROR_GENERIC;
+		}
+	}
+
+	mobj_free(mobj);
+	return res;
+}
+
+static TEE_Result test_runs(struct list_test_buf *buf)
+{
+	const paddr_t p0 = buf->pa;
+	const paddr_t p1 = p0 + SMALL_PAGE_SIZE;
+	const paddr_t p2 = p1 + SMALL_PAGE_SIZE;
+	const paddr_t p3 = p2 + SMALL_PAGE_SIZE;
+	const paddr_t split[] = { p2, p3, p0, p1, p2, p3 };
+	const paddr_t merged[] = { p0, p1, p2, p3 };
+	paddr_t *expect = NULL;
+	uint64_t *l = buf->va;
+	TEE_Result res = TEE_SUCCESS;
+	size_t n = 0;
+
+	/* Runs which aren't contiguous with each other */
+	l[0] = run_entry(p2, 2);
+	l[1] = run_entry(p0, 1);
+	l[2] = run_entry(p1, 3);
+	res = check_list(buf, "split runs", ARRAY_SIZE(split), split);
+	if (res)
+		return res;
+
+	/* Adjacent runs, merged into one */
+	l[0] = run_entry(p0, 1);
+	l[1] = run_entry(p1, 2);
+	l[2] = run_entry(p3, 1);
+	res = check_list(buf, "adjacent runs", ARRAY_SIZE(merged), merged);
+	if (res)
+		return res;
+
+	/* Runs covering more pages than the buffer */
+	l[0] = run_entry(p0, 4);
+	res = check_list(buf, "run past the end", 2, NULL);
+	if (res)
+		return res;
+	l[0] = run_entry(p0, 1);
+	l[1] = run_entry(p1, 6);
+	res = check_list(buf, "last run past the end", 4, NULL);
+	if (res)
+		return res;
+
+	/*
+	 * One page per entry, filling the first page of the list, the
+	 * last page is listed in the second page of the list.
+	 */
+	expect = calloc(LIST_ENTRIES_PER_PAGE + 1, sizeof(*expect));
+	if (!expect)
+		return TEE_ERROR_OUT_OF_MEMORY;
+	for (n = 0; n < LIST_ENTRIES_PER_PAGE; n++) {
+		expect[n] = merged[n % ARRAY_SIZE(merged)];
+		l[n] = expect[n];
+	}
+	l[LIST_ENTRIES_PER_PAGE] = p1;
+	l[SMALL_PAGE_SIZE / sizeof(uint64_t)] = run_entry(p3, 1);
+	expect[LIST_ENTRIES_PER_PAGE] = p3;
+	res = check_list(buf, "two page list", LIST_ENTRIES_PER_PAGE + 1,
+			 expect);
+	free(expect);
+
+	return res;
+}
+
+static unsigned int va_level_shift(vaddr_t va)
+{
+	struct core_mmu_table_info tbl_info = { };
+
+	if (!core_mmu_find_table(NULL, va, UINT_MAX, &tbl_info))
+		panic();
+	return tbl_info.shift;
+}
+
+static TEE_Result check_map(const char *name, vaddr_t va, paddr_t pa,
+			    size_t num_pages)
+{
+	size_t n = 0;
+
+	for (n = 0; n < num_pages; n++) {
+		if (virt_to_phys((void *)(va + n * SMALL_PAGE_SIZE)) !=
+		    pa + n * SMALL_PAGE_SIZE) {
+			EMSG("%s: page %zu not mapped as expected", name, n);
+			return TEE_ERROR_GENERIC;
+		}
+	}
+
+	return TEE_SUCCESS;
+}
+
+/*
+ * Maps @blk with a block entry at a free pgdir aligned virtual address,
+ * unmaps it and maps the same range again with small pages.
+ */
+static TEE_Result test_block_map(paddr_t blk)
+{
+	paddr_t pages[4] = { };
+	TEE_Result res = TEE_SUCCESS;
+	tee_mm_entry_t *mm = NULL;
+	bool expect_block = false;
+	vaddr_t va = 0;
+	size_t n = 0;
+
+	mm = tee_mm_alloc(&tee_mm_shm, 2 * CORE_MMU_PGDIR_SIZE);
+	if (!mm)
+		return TEE_ERROR_OUT_OF_MEMORY;
+	va = ROUNDUP(tee_mm_get_smem(mm), CORE_MMU_PGDIR_SIZE);
+
+	/* A pgdir entry split earlier into a table stays a table */
+	expect_block = va_level_shift(va) == CORE_MMU_PGDIR_SHIFT;
+
+	res = core_mmu_map_contiguous(va, blk, BLOCK_PAGES, MEM_AREA_NSEC_SHM);
+	if (res) {
+		EMSG("block map: %#" PRIx32, res);
+		goto out;
+	}
+	if (expect_block && va_level_shift(va) != CORE_MMU_PGDIR_SHIFT) {
+		EMSG("block map: not mapped with a block entry");
+		res = TEE_ERROR_GENERIC;
+	}
+	if (!res)
+		res = check_map("block map", va, blk, BLOCK_PAGES);
+	core_mmu_unmap_pages(va, BLOCK_PAGES);
+	if (res)
+		goto out;
+	if (virt_to_phys((void *)va)) {
+		EMSG("block unmap: still mapped");
+		res = TEE_ERROR_GENERIC;
+		goto out;
+	}
+
+	/* Small pages in reverse order in the range of the block */
+	for (n = 0; n < ARRAY_SIZE(pages); n++)
+		pages[n] = blk + (ARRAY_SIZE(pages) - 1 - n) * SMALL_PAGE_SIZE;
+	res = core_mmu_map_pages(va, pages, ARRAY_SIZE(pages),
+				 MEM_AREA_NSEC_SHM);
+	if (res) {
+		EMSG("small page map after block: %#" PRIx32, res);
+		goto out;
+	}
+	if (va_level_shift(va) != SMALL_PAGE_SHIFT) {
+		EMSG("small page map after block: not mapped with pages");
+		res = TEE_ERROR_GENERIC;
+	}
+	for (n = 0; n < ARRAY_SIZE(pages) && !res; n++)
+		res = check_map("small page map after block",
+				va + n * SMALL_PAGE_SIZE, pages[n], 1);
+	core_mmu_unmap_pages(va, ARRAY_SIZE(pages));
+out:
+	tee_mm_free(mm);
+	return res;
+}
+
+/*
+ * Registers and maps runs of a pgdir aligned block @blk of non-secure
+ * memory, as an exact block and followed by a page which isn't part of
+ * the block.
+ */
+static TEE_Result test_block_runs(struct list_test_buf *buf, paddr_t blk)
+{
+	const size_t num_pages[] = { BLOCK_PAGES, BLOCK_PAGES + 1 };
+	TEE_Result res = TEE_SUCCESS;
+	struct mobj *mobj = NULL;
+	vaddr_t va = 0;
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(num_pages) && !res; n++) {
+		buf->va[0] = run_entry(blk, BLOCK_PAGES);
+		buf->va[1] = run_entry(buf->pa, 1);
+		mobj = msg_param_mobj_from_noncontig(buf->pa,
+						     num_pages[n] *
+						     SMALL_PAGE_SIZE, 0, true);
+		if (!mobj) {
+			EMSG("block run %zu: can't register and map", n);
+			return TEE_ERROR_GENERIC;
+		}
+		va = (vaddr_t)mobj_get_va(mobj, 0);
+		DMSG("block run %zu: mapped at level shift %u", n,
+		     va_level_shift(va));
+		res = check_map("block run", va, blk, BLOCK_PAGES);
+		if (!res && n)
+			res = check_map("page after block run",
+					va + CORE_MMU_PGDIR_SIZE, buf->pa, 1);
+		/* Unmaps the buffer too */
+		mobj_free(mobj);
+	}
+	if (res)
+		return res;
+
+	return test_block_map(blk);
+}
+
+/*
+ * Finds a pgdir aligned block of non-secure memory next to the buffer.
+ * It's only mapped, never accessed.
+ */
+static bool find_nsec_block(paddr_t pa, paddr_t *blk)
+{
+	paddr_t b = ROUNDDOWN(pa, CORE_MMU_PGDIR_SIZE);
+
+	if (core_pbuf_is(CORE_MEM_NON_SEC, b, CORE_MMU_PGDIR_SIZE)) {
+		*blk = b;
+		return true;
+	}
+	b += CORE_MMU_PGDIR_SIZE;
+	if (core_pbuf_is(CORE_MEM_NON_SEC, b, CORE_MMU_PGDIR_SIZE)) {
+		*blk = b;
+		return true;
+	}
+	return false;
+}
+
+static TEE_Result get_list_buf(TEE_Param *param, struct list_test_buf *buf)
+{
+	vaddr_t va = ROUNDUP((vaddr_t)param->memref.buffer, SMALL_PAGE_SIZE);
+	vaddr_t end = (vaddr_t)param->memref.buffer + param->memref.size;
+	size_t n = 0;
+
+	if (!param->memref.buffer || end < va ||
+	    end - va < LIST_TEST_PAGES * SMALL_PAGE_SIZE)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	buf->va = (uint64_t *)va;
+	buf->pa = virt_to_phys(buf->va);
+	for (n = 0; n < LIST_TEST_PAGES; n++) {
+		if (virt_to_phys((void *)(va + n * SMALL_PAGE_SIZE)) !=
+		    buf->pa + n * SMALL_PAGE_SIZE ||
+		    !core_pbuf_is(CORE_MEM_NON_SEC,
+				  buf->pa + n * SMALL_PAGE_SIZE,
+				  SMALL_PAGE_SIZE)) {
+			EMSG("Buffer not contiguous non-secure memory");
+			return TEE_ERROR_BAD_PARAMETERS;
+		}
+	}
+
+	return TEE_SUCCESS;
+}
+
+TEE_Result core_msg_param_tests(uint32_t nParamTypes,
+				TEE_Param pParams[TEE_NUM_PARAMS])
+{
+	const uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_MEMREF_INOUT,
+						TEE_PARAM_TYPE_NONE,
+						TEE_PARAM_TYPE_NONE,
+						TEE_PARAM_TYPE_NONE);
+	struct list_test_buf buf = { };
+	TEE_Result res = TEE_SUCCESS;
+	paddr_t blk = 0;
+	size_t n = 0;
+
+	if (nParamTypes != exp_pt)
+		return TEE_ERROR_BAD_PARAMETERS;
+	res = get_list_buf(pParams, &buf);
+	if (res)
+		return res;
+
+	for (n = 0; n < ARRAY_SIZE(batch_tests) && !res; n++)
+		res = test_batch(batch_tests + n);
+	if (res)
+		return res;
+
+	res = test_runs(&buf);
+	if (res)
+		return res;
+
+	if (!find_nsec_block(buf.pa, &blk)) {
+		IMSG("No non-secure block found, skipping block tests");
+		return TEE_SUCCESS;
+	}
+	return test_block_runs(&buf, blk);
+}
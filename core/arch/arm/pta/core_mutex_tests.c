@@ -3,9 +3,11 @@
  * Copyright (c) 2017, Linaro Limited
  */
 
+#include <arm.h>
 #include <atomic.h>
 #include "core_self_tests.h"
 #include <kernel/mutex.h>
+#include <kernel/tee_ta_manager.h>
 #include <pta_invoke_tests.h>
 #include <trace.h>
 
@@ -19,6 +21,9 @@ static uint64_t val1;
 
 struct mutex test_mutex = MUTEX_INITIALIZER;
 
+static uint64_t stress_count;
+static struct mutex stress_mutex = MUTEX_INITIALIZER;
+
 static TEE_Result mutex_test_writer(TEE_Param params[TEE_NUM_PARAMS])
 {
 	size_t n;
@@ -67,6 +72,172 @@ static TEE_Result mutex_test_reader(TEE_Param params[TEE_NUM_PARAMS])
 	return res;
 }
 
+/*
+ * The writer preference test is invoked from three threads at once, with
+ * the roles below. Each role waits for the previous ones to be in place
+ * before it goes on, giving up after PREF_TIMEOUT_SEC seconds.
+ */
+#define PREF_TIMEOUT_SEC	5
+
+static unsigned int pref_reader1_locked;
+static unsigned int pref_reader2_trying;
+static unsigned int pref_writer_done;
+
+static bool pref_is_reader1_locked(void)
+{
+	return atomic_load_uint(&pref_reader1_locked);
+}
+
+static bool pref_is_writer_waiting(void)
+{
+	return *(volatile short *)&test_mutex.write_waiters;
+}
+
+static bool pref_is_reader2_trying(void)
+{
+	return atomic_load_uint(&pref_reader2_trying);
+}
+
+static bool pref_wait(bool (*cond)(void))
+{
+	uint64_t end = read_cntpct() + read_cntfrq() * PREF_TIMEOUT_SEC;
+
+	while (!cond())
+		if (read_cntpct() > end)
+			return false;
+	return true;
+}
+
+/*
+ * Holds a read lock until a writer and a second reader wait for the
+ * mutex, then gives the second reader value[0].b iterations to go to
+ * sleep before unlocking
+ */
+static TEE_Result mutex_test_pref_reader1(TEE_Param params[TEE_NUM_PARAMS])
+{
+	TEE_Result res = TEE_SUCCESS;
+	volatile size_t n;
+
+	atomic_store_uint(&pref_writer_done, false);
+	atomic_store_uint(&pref_reader2_trying, false);
+
+	mutex_read_lock(&test_mutex);
+	atomic_store_uint(&pref_reader1_locked, true);
+
+	if (!pref_wait(pref_is_writer_waiting) ||
+	    !pref_wait(pref_is_reader2_trying))
+		res = TEE_ERROR_BUSY;
+
+	for (n = 0; n < params[0].value.b; n++)
+		;
+
+	atomic_store_uint(&pref_reader1_locked, false);
+	mutex_read_unlock(&test_mutex);
+
+	return res;
+}
+
+/* Waits for the write lock behind the first reader */
+static TEE_Result mutex_test_pref_writer(void)
+{
+	if (!pref_wait(pref_is_reader1_locked))
+		return TEE_ERROR_BUSY;
+
+	mutex_lock(&test_mutex);
+	atomic_store_uint(&pref_writer_done, true);
+	mutex_unlock(&test_mutex);
+
+	return TEE_SUCCESS;
+}
+
+/*
+ * Asks for a read lock while the writer waits, it must not get it before
+ * the writer is done even though the mutex is only read locked
+ */
+static TEE_Result mutex_test_pref_reader2(void)
+{
+	TEE_Result res = TEE_SUCCESS;
+
+	if (!pref_wait(pref_is_writer_waiting))
+		return TEE_ERROR_BUSY;
+
+	if (mutex_read_trylock(&test_mutex)) {
+		EMSG("Read trylock succeeded with a waiting writer");
+		mutex_read_unlock(&test_mutex);
+		res = TEE_ERROR_BAD_STATE;
+	}
+
+	atomic_store_uint(&pref_reader2_trying, true);
+	mutex_read_lock(&test_mutex);
+	if (!atomic_load_uint(&pref_writer_done)) {
+		EMSG("Reader got the mutex before the waiting writer");
+		res = TEE_ERROR_BAD_STATE;
+	}
+	mutex_read_unlock(&test_mutex);
+
+	return res;
+}
+
+/* Mimics a short critical section such as looking up a session */
+static TEE_Result mutex_test_stress(TEE_Param params[TEE_NUM_PARAMS],
+				    struct mutex *m, uint64_t *counter)
+{
+	uint32_t contended = 0;
+	uint64_t cnt;
+	size_t n;
+
+	cnt = read_cntpct();
+
+	for (n = 0; n < params[0].value.b; n++) {
+		if (!mutex_trylock(m)) {
+			contended++;
+			mutex_lock(m);
+		}
+		(*counter)++;
+		mutex_unlock(m);
+	}
+
+	cnt = read_cntpct() - cnt;
+
+	params[1].value.a = contended;
+	params[1].value.b = (cnt * 1000000) / read_cntfrq();
+
+	return TEE_SUCCESS;
+}
+
+/*
+ * Looks up the session of the caller like each invoke from normal world
+ * does, the lookup is serialized by the session manager lock shared by
+ * all sessions.
+ */
+static TEE_Result mutex_test_stress_session(TEE_Param params[TEE_NUM_PARAMS])
+{
+	struct tee_ta_session *s = NULL;
+	TEE_Result res = TEE_SUCCESS;
+	uint64_t cnt;
+	size_t n;
+
+	res = tee_ta_get_current_session(&s);
+	if (res)
+		return res;
+
+	cnt = read_cntpct();
+
+	for (n = 0; n < params[0].value.b; n++) {
+		if (tee_ta_find_session(s->id, s->open_sessions) != s) {
+			EMSG("Session %" PRIu32 " not found", s->id);
+			return TEE_ERROR_ITEM_NOT_FOUND;
+		}
+	}
+
+	cnt = read_cntpct() - cnt;
+
+	params[1].value.a = 0;
+	params[1].value.b = (cnt * 1000000) / read_cntfrq();
+
+	return TEE_SUCCESS;
+}
+
 TEE_Result core_mutex_tests(uint32_t param_types,
 			    TEE_Param params[TEE_NUM_PARAMS])
 {
@@ -85,6 +256,16 @@ TEE_Result core_mutex_tests(uint32_t param_types,
 		return mutex_test_writer(params);
 	case PTA_MUTEX_TEST_READER:
 		return mutex_test_reader(params);
+	case PTA_MUTEX_TEST_STRESS_SHARED:
+		return mutex_test_stress(params, &stress_mutex, &stress_count);
+	case PTA_MUTEX_TEST_STRESS_SESSION:
+		return mutex_test_stress_session(params);
+	case PTA_MUTEX_TEST_PREF_READER1:
+		return mutex_test_pref_reader1(params);
+	case PTA_MUTEX_TEST_PREF_WRITER:
+		return mutex_test_pref_writer();
+	case PTA_MUTEX_TEST_PREF_READER2:
+		return mutex_test_pref_reader2();
 	default:
 		return TEE_ERROR_BAD_PARAMETERS;
 	}
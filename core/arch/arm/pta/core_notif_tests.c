@@ -0,0 +1,171 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2019, Linaro Limited
+ */
+
+#include <kernel/notif.h>
+#include <kernel/tee_ta_manager.h>
+#include <pta_invoke_tests.h>
+#include <pta_system.h>
+#include <string.h>
+#include <trace.h>
+#include <util.h>
+
+#include "core_self_tests.h"
+
+/* Same as MAX_NOTIF_VALUES in system.c */
+#define NOTIF_TEST_MAX_VALUES	4
+
+static const TEE_Identity notif_test_id = {
+	.login = TEE_LOGIN_TRUSTED_APP,
+	.uuid = PTA_INVOKE_TESTS_UUID,
+};
+
+static TEE_Result notif_test_invoke(struct tee_ta_session *s, uint32_t cmd,
+				    uint32_t *value)
+{
+	struct tee_ta_param param = { };
+	TEE_ErrorOrigin eo = TEE_ORIGIN_TEE;
+	TEE_Result res = TEE_SUCCESS;
+
+	if (cmd == PTA_SYSTEM_NOTIF_ALLOC) {
+		param.types = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_OUTPUT,
+					      TEE_PARAM_TYPE_NONE,
+					      TEE_PARAM_TYPE_NONE,
+					      TEE_PARAM_TYPE_NONE);
+	} else {
+		param.types = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+					      TEE_PARAM_TYPE_NONE,
+					      TEE_PARAM_TYPE_NONE,
+					      TEE_PARAM_TYPE_NONE);
+		param.u[0].val.a = *value;
+	}
+
+	res = tee_ta_invoke_command(&eo, s, &notif_test_id,
+				    TEE_TIMEOUT_INFINITE, cmd, &param);
+	if (!res && cmd == PTA_SYSTEM_NOTIF_ALLOC)
+		*value = param.u[0].val.a;
+	return res;
+}
+
+/*
+ * Retrieves all pending values like normal world does and sends the
+ * values which aren't in @mask again, those belong to someone else.
+ * Returns the values of @mask which were pending.
+ */
+static uint64_t notif_test_drain(uint64_t mask)
+{
+	uint64_t seen = 0;
+	uint32_t value = 0;
+	bool pending = false;
+
+	while (notif_get_value(&value, &pending))
+		seen |= BIT64(value);
+
+	for (value = 0; value <= NOTIF_ASYNC_VALUE_MAX; value++)
+		if ((seen & ~mask) & BIT64(value))
+			notif_send_async(value);
+
+	return seen & mask;
+}
+
+static TEE_Result notif_test_session(struct tee_ta_session *s)
+{
+	uint32_t values[NOTIF_TEST_MAX_VALUES] = { };
+	TEE_Result res = TEE_SUCCESS;
+	uint64_t mask = 0;
+	uint64_t seen = 0;
+	uint32_t extra = 0;
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(values); n++) {
+		res = notif_test_invoke(s, PTA_SYSTEM_NOTIF_ALLOC, values + n);
+		if (res) {
+			EMSG("alloc %zu: %#" PRIx32, n, res);
+			return res;
+		}
+		if (values[n] < NOTIF_WQ_VALUE_COUNT ||
+		    values[n] > NOTIF_ASYNC_VALUE_MAX) {
+			EMSG("alloc %zu: bad value %" PRIu32, n, values[n]);
+			return TEE_ERROR_GENERIC;
+		}
+		mask |= BIT64(values[n]);
+	}
+
+	res = notif_test_invoke(s, PTA_SYSTEM_NOTIF_ALLOC, &extra);
+	if (res != TEE_ERROR_OUT_OF_MEMORY) {
+		EMSG("alloc beyond the session limit: %#" PRIx32, res);
+		return TEE_ERROR_GENERIC;
+	}
+
+	/*
+	 * Normal world may retrieve the values before we do once it has
+	 * been interrupted, so a sent value isn't required to be seen here.
+	 */
+	for (n = 0; n < ARRAY_SIZE(values); n++) {
+		res = notif_test_invoke(s, PTA_SYSTEM_NOTIF_SEND, values + n);
+		if (res) {
+			EMSG("send %" PRIu32 ": %#" PRIx32, values[n], res);
+			return res;
+		}
+	}
+	seen = notif_test_drain(mask);
+	DMSG("Sent values retrieved here: %#" PRIx64, seen);
+
+	/* A value sent and then freed must not stay pending */
+	res = notif_test_invoke(s, PTA_SYSTEM_NOTIF_SEND, values);
+	if (!res)
+		res = notif_test_invoke(s, PTA_SYSTEM_NOTIF_FREE, values);
+	if (res) {
+		EMSG("send and free %" PRIu32 ": %#" PRIx32, values[0], res);
+		return res;
+	}
+	seen = notif_test_drain(BIT64(values[0]));
+	if (seen) {
+		EMSG("Freed value %" PRIu32 " still pending", values[0]);
+		return TEE_ERROR_GENERIC;
+	}
+
+	res = notif_test_invoke(s, PTA_SYSTEM_NOTIF_SEND, values);
+	if (res != TEE_ERROR_BAD_PARAMETERS) {
+		EMSG("send of freed value: %#" PRIx32, res);
+		return TEE_ERROR_GENERIC;
+	}
+
+	/* Room for one more value again */
+	res = notif_test_invoke(s, PTA_SYSTEM_NOTIF_ALLOC, &extra);
+	if (res) {
+		EMSG("alloc after free: %#" PRIx32, res);
+		return res;
+	}
+
+	return TEE_SUCCESS;
+}
+
+TEE_Result core_notif_tests(uint32_t nParamTypes,
+			    TEE_Param pParams[TEE_NUM_PARAMS] __unused)
+{
+	struct tee_ta_session_head sessions = TAILQ_HEAD_INITIALIZER(sessions);
+	static const TEE_UUID uuid = PTA_SYSTEM_UUID;
+	struct tee_ta_param param = { };
+	TEE_ErrorOrigin eo = TEE_ORIGIN_TEE;
+	struct tee_ta_session *s = NULL;
+	TEE_Result res = TEE_SUCCESS;
+
+	if (nParamTypes)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	res = tee_ta_open_session(&eo, &s, &sessions, &uuid, &notif_test_id,
+				  TEE_TIMEOUT_INFINITE, &param);
+	if (res) {
+		EMSG("open system PTA: %#" PRIx32, res);
+		return res;
+	}
+
+	res = notif_test_session(s);
+
+	/* Closing the session frees the values still held */
+	tee_ta_close_session(s, &sessions, &notif_test_id);
+
+	return res;
+}
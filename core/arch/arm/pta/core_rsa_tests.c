@@ -0,0 +1,511 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2018, Linaro Limited
+ */
+
+#include <arm.h>
+#include <crypto/crypto.h>
+#include <malloc.h>
+#include <pta_invoke_tests.h>
+#include <string.h>
+#include <trace.h>
+#include <util.h>
+
+#include "core_self_tests.h"
+
+/*
+ * Fixed test keys so that the numbers are comparable between runs, the
+ * public exponent is 65537 for both.
+ */
+static const uint8_t rsa_perf_e[] = { 0x01, 0x00, 0x01 };
+
+static const uint8_t rsa2048_n[] = {
+	0xb1, 0x33, 0x48, 0xb1, 0x5e, 0x42, 0x40, 0x99, 0xab, 0x83, 0x59, 0x41,
+	0x31, 0x56, 0x6f, 0xac, 0x6c, 0xac, 0xee, 0x4d, 0x48, 0xa9, 0xfb, 0x20,
+	0x1b, 0xe5, 0xba, 0xdb, 0x1d, 0x31, 0xae, 0x24, 0x4d, 0x17, 0xd0, 0xa5,
+	0x70, 0xe0, 0x9b, 0x05, 0x03, 0x75, 0x93, 0x85, 0x1a, 0xc8, 0x22, 0xa9,
+	0x21, 0x3b, 0xdc, 0xb7, 0x87, 0x35, 0x83, 0xed, 0x75, 0x9f, 0xe4, 0x56,
+	0xa4, 0xd3, 0x70, 0x11, 0x4a, 0x9b, 0xaa, 0x6f, 0xcb, 0x2b, 0xb0, 0xd6,
+	0xa0, 0x7d, 0x73, 0xda, 0x0f, 0x73, 0x81, 0x53, 0xf8, 0xf5, 0xc6, 0x20,
+	0x54, 0xd8, 0xab, 0xf6, 0x7d, 0x12, 0xba, 0xf3, 0x13, 0xe7, 0x92, 0x67,
+	0xff, 0xa0, 0x6c, 0xc6, 0xd0, 0x96, 0x1a, 0xa4, 0x88, 0x8a, 0xb1, 0x00,
+	0x0b, 0x1f, 0xdd, 0x14, 0x90, 0x40, 0xb3, 0xfd, 0xc6, 0xcd, 0xb3, 0x53,
+	0xba, 0x39, 0x43, 0x67, 0xd7, 0xa0, 0xf4, 0xac, 0x7d, 0xc7, 0x95, 0x7b,
+	0x1c, 0x9f, 0x83, 0xd0, 0x3c, 0x29, 0x2c, 0x51, 0x8a, 0xd9, 0xc2, 0x29,
+	0x6f, 0xfe, 0x73, 0x8c, 0x44, 0xa6, 0xc2, 0xe1, 0xe0, 0xfb, 0x7c, 0xd9,
+	0xb2, 0x73, 0x5d, 0xaf, 0x6d, 0x65, 0xd0, 0x89, 0xa0, 0x86, 0x62, 0x3d,
+	0x6b, 0xbf, 0x9f, 0xe0, 0x1a, 0x76, 0x45, 0x16, 0x8f, 0xf5, 0xbe, 0x4a,
+	0x1b, 0x71, 0xff, 0x2e, 0x3e, 0x65, 0xaf, 0x19, 0xfd, 0x4c, 0x54, 0x84,
+	0x82, 0x71, 0x09, 0x34, 0x7b, 0x30, 0x52, 0x27, 0xb4, 0xe8, 0x1b, 0x10,
+	0x51, 0x3f, 0x80, 0x92, 0x27, 0xf5, 0xca, 0x67, 0x8d, 0x27, 0x9d, 0x56,
+	0x92, 0x3c, 0x94, 0x22, 0x8a, 0x03, 0x2f, 0xfa, 0xfc, 0x3d, 0x84, 0x6e,
+	0x27, 0xcf, 0x5a, 0x9e, 0xce, 0xf4, 0x8e, 0x04, 0x85, 0x6e, 0xa6, 0x05,
+	0xee, 0x51, 0xbc, 0xbf, 0x67, 0xa5, 0xb0, 0x4c, 0x76, 0xa6, 0xf7, 0xc8,
+	0x82, 0x71, 0xc9, 0xc9,
+};
+
+static const uint8_t rsa2048_d[] = {
+	0x2a, 0x05, 0xd5, 0x79, 0x6a, 0xb7, 0x1f, 0x86, 0xd1, 0xeb, 0xe6, 0x60,
+	0xd5, 0x88, 0x80, 0x17, 0x4d, 0xf6, 0x7c, 0xd5, 0x0b, 0x24, 0x74, 0x8f,
+	0x9a, 0xce, 0x12, 0x50, 0x20, 0x4e, 0x45, 0xd4, 0x0a, 0x0c, 0x59, 0xc8,
+	0xc2, 0x4a, 0x21, 0xb9, 0x40, 0xa6, 0xc3, 0x83, 0x4f, 0x64, 0xa3, 0x03,
+	0xa5, 0x04, 0x03, 0x45, 0xea, 0xe4, 0xc0, 0x12, 0xb2, 0x50, 0x66, 0xe0,
+	0x3d, 0x5a, 0x7f, 0x3b, 0x3a, 0x8c, 0x4c, 0x11, 0x13, 0x07, 0x9b, 0x7a,
+	0x6a, 0xb9, 0x15, 0x9e, 0x63, 0x07, 0xab, 0x65, 0xf4, 0xa6, 0xa4, 0x83,
+	0xca, 0x5b, 0x4f, 0xfc, 0xb6, 0x90, 0x98, 0x91, 0x48, 0xe9, 0x24, 0x09,
+	0x51, 0xd0, 0x03, 0xbb, 0xea, 0x7f, 0x8e, 0x75, 0xf2, 0x83, 0xa1, 0x92,
+	0x37, 0x11, 0x29, 0x66, 0xd5, 0x06, 0xe3, 0x28, 0x8d, 0xda, 0xfe, 0x6a,
+	0x1e, 0xc1, 0xb1, 0xc0, 0x90, 0x9c, 0x75, 0x29, 0x85, 0xd8, 0x40, 0x65,
+	0x13, 0x30, 0x6d, 0xf9, 0xf6, 0x30, 0x14, 0x7d, 0x2a, 0xdd, 0xdc, 0x19,
+	0xec, 0x8c, 0x14, 0xcb, 0xfb, 0x01, 0x1c, 0xfd, 0x2b, 0x35, 0x68, 0xc4,
+	0x9d, 0x6a, 0xbf, 0x75, 0xb0, 0x8a, 0x63, 0xcb, 0x3e, 0x51, 0xc7, 0xcb,
+	0xb5, 0x73, 0xcf, 0xd4, 0xf8, 0x1c, 0x4d, 0xcd, 0x32, 0xfe, 0xe5, 0x9b,
+	0x5a, 0x2b, 0x1e, 0xcb, 0xc8, 0xf5, 0x8b, 0x53, 0xd9, 0xd5, 0x5c, 0x3c,
+	0x46, 0xcd, 0xff, 0x22, 0x9d, 0x35, 0x96, 0x2e, 0x12, 0xdc, 0x72, 0x9b,
+	0xd3, 0x38, 0x9f, 0xce, 0x37, 0x03, 0x45, 0x22, 0xe9, 0xf7, 0x8f, 0x2c,
+	0xa4, 0x96, 0xa0, 0x6c, 0x97, 0xad, 0xef, 0x5e, 0x38, 0xe4, 0xee, 0xd5,
+	0x25, 0xd4, 0x79, 0x0b, 0x45, 0x8e, 0x90, 0xe1, 0x6c, 0xa7, 0xbc, 0x07,
+	0x62, 0x35, 0x29, 0xfb, 0xb3, 0x2c, 0x0d, 0x36, 0xe3, 0x46, 0x93, 0x58,
+	0x39, 0x0e, 0x41, 0xe1,
+};
+
+static const uint8_t rsa2048_p[] = {
+	0xdd, 0xc9, 0x2a, 0xea, 0xf8, 0xb2, 0xbd, 0x43, 0x4b, 0xb7, 0xab, 0xd3,
+	0xd2, 0x1e, 0x56, 0x71, 0x6e, 0x42, 0x74, 0x67, 0x9b, 0xf0, 0x5e, 0x54,
+	0x1a, 0xcf, 0xd1, 0x89, 0x1f, 0x1a, 0xa1, 0xf9, 0x52, 0xcf, 0xae, 0xa3,
+	0xc9, 0xa3, 0xa9, 0x1a, 0x96, 0xd8, 0xbd, 0x57, 0x46, 0x0b, 0xa0, 0xaa,
+	0x2f, 0xa5, 0x14, 0xfd, 0xcc, 0x92, 0xc5, 0x1a, 0x00, 0x9e, 0x3d, 0x91,
+	0x4f, 0xc1, 0x43, 0x80, 0x42, 0x1e, 0xc4, 0x45, 0x2e, 0x18, 0x3f, 0x6a,
+	0x71, 0xbb, 0x1b, 0x16, 0x08, 0x1c, 0x6c, 0x8e, 0x17, 0xe8, 0x18, 0xa7,
+	0x12, 0x98, 0x11, 0x4c, 0xe2, 0xae, 0x85, 0x0f, 0x50, 0xf4, 0xbf, 0x3a,
+	0x87, 0x2c, 0x98, 0x20, 0x97, 0xa8, 0xc9, 0x6b, 0xc3, 0xb2, 0x17, 0x54,
+	0xc3, 0xd3, 0x12, 0x84, 0x09, 0x2f, 0x64, 0x33, 0x59, 0x41, 0x9d, 0x7c,
+	0x15, 0x4d, 0xde, 0xb7, 0x3d, 0x3c, 0xcd, 0x65,
+};
+
+static const uint8_t rsa2048_q[] = {
+	0xcc, 0x89, 0x55, 0x3a, 0x22, 0x0e, 0x29, 0x1c, 0x0a, 0x77, 0xb7, 0x8d,
+	0x1d, 0xd9, 0xa5, 0x81, 0x1c, 0xf1, 0xf7, 0xd4, 0x2e, 0xbd, 0x4f, 0x98,
+	0xf0, 0x43, 0x1f, 0xff, 0x99, 0x40, 0xff, 0xf6, 0x46, 0xdc, 0x4b, 0xa4,
+	0x82, 0xf6, 0x85, 0x20, 0xa3, 0x08, 0xba, 0xa9, 0x1d, 0x65, 0xb3, 0xc8,
+	0x70, 0x52, 0xe4, 0x3a, 0x9f, 0x14, 0x94, 0x21, 0x5b, 0x4e, 0x9a, 0x97,
+	0x40, 0xa5, 0x8d, 0x2f, 0x4a, 0x65, 0xbd, 0x54, 0xd3, 0x66, 0x39, 0x5a,
+	0xa5, 0x99, 0xd1, 0xc1, 0x11, 0x07, 0x17, 0xb9, 0x7f, 0xcd, 0xfa, 0xea,
+	0x4c, 0x55, 0x7b, 0x90, 0x21, 0x49, 0x41, 0xda, 0x64, 0xfe, 0x61, 0x44,
+	0x17, 0xd9, 0xf2, 0x19, 0x80, 0x93, 0x2a, 0x74, 0x53, 0xbc, 0xa4, 0x58,
+	0x7f, 0x78, 0xd7, 0xd0, 0x10, 0x9c, 0x22, 0x0b, 0x8f, 0x3c, 0x2c, 0x54,
+	0x4f, 0x12, 0xd1, 0xff, 0x0b, 0xd8, 0x66, 0x95,
+};
+
+static const uint8_t rsa2048_dp[] = {
+	0x2e, 0xca, 0xd9, 0x9e, 0x37, 0x98, 0x66, 0x6c, 0x03, 0x56, 0x9e, 0x0f,
+	0x13, 0xbe, 0xc8, 0xd8, 0x27, 0xbe, 0x27, 0x97, 0x10, 0x84, 0x77, 0x32,
+	0x61, 0x71, 0xc5, 0x30, 0x9b, 0xfa, 0x5f, 0x80, 0x1d, 0xe3, 0xa9, 0x61,
+	0xef, 0x11, 0xf3, 0x84, 0xa3, 0x9c, 0xd8, 0xdd, 0xc7, 0xee, 0x7e, 0x18,
+	0x49, 0xf3, 0x17, 0x69, 0xb0, 0xb6, 0xaa, 0x95, 0x20, 0xda, 0x41, 0xfd,
+	0x1d, 0x89, 0x95, 0xf7, 0x42, 0x7c, 0x01, 0x46, 0xe3, 0x41, 0xc4, 0x67,
+	0x6d, 0xd5, 0x5f, 0x12, 0x97, 0xe5, 0x7f, 0x55, 0xbf, 0x5f, 0x7d, 0x8c,
+	0x0a, 0x55, 0x41, 0x19, 0x2a, 0x9e, 0x4d, 0x7e, 0x7c, 0xc3, 0x16, 0x71,
+	0x7f, 0xc1, 0x7d, 0xdb, 0x2a, 0x84, 0x36, 0xf2, 0xe0, 0x97, 0xfb, 0x6a,
+	0x2b, 0xe2, 0xa5, 0x7e, 0x6b, 0xfd, 0xae, 0xb3, 0x52, 0xba, 0x90, 0x42,
+	0x74, 0xb0, 0x38, 0x34, 0x0a, 0xdc, 0x80, 0x2d,
+};
+
+static const uint8_t rsa2048_dq[] = {
+	0x5a, 0x51, 0xda, 0xbc, 0xcd, 0x05, 0x0b, 0xca, 0x42, 0x25, 0x13, 0x7c,
+	0xd1, 0x4d, 0xa6, 0xf4, 0x18, 0xe0, 0x10, 0xdc, 0x35, 0xb7, 0x8b, 0x4a,
+	0xb1, 0xee, 0x32, 0x57, 0x20, 0x49, 0xbf, 0xbd, 0xf5, 0x14, 0x9a, 0xa2,
+	0x8e, 0xe2, 0x65, 0x6f, 0x40, 0x0f, 0x3e, 0xbe, 0x27, 0x29, 0x1d, 0xf6,
+	0xc9, 0x03, 0x11, 0x9d, 0x81, 0x5a, 0x08, 0xff, 0xa1, 0xde, 0x58, 0x0d,
+	0xaa, 0x92, 0x70, 0x82, 0x0d, 0x8c, 0x57, 0xca, 0xf9, 0x7f, 0x0e, 0x9c,
+	0xa4, 0xbc, 0x04, 0x10, 0x09, 0x80, 0xe4, 0x4d, 0x19, 0xce, 0xcf, 0x9a,
+	0x5f, 0x12, 0xf0, 0x79, 0x78, 0xf9, 0x6c, 0x87, 0x10, 0x49, 0xf4, 0x91,
+	0xa9, 0x26, 0xa8, 0xed, 0xf2, 0x05, 0x0a, 0x9e, 0x4b, 0xcb, 0xe5, 0x96,
+	0xde, 0xd3, 0x72, 0x19, 0x82, 0xfc, 0x2f, 0x5c, 0x83, 0x67, 0xc2, 0xfb,
+	0x87, 0xdf, 0x7b, 0xb3, 0xf0, 0x7b, 0x22, 0xf1,
+};
+
+static const uint8_t rsa2048_qp[] = {
+	0x78, 0x5c, 0xca, 0x1e, 0x8c, 0xc7, 0x7c, 0x5d, 0x1c, 0x48, 0x83, 0x20,
+	0x25, 0x06, 0x2a, 0xa8, 0x24, 0x8d, 0xf6, 0xef, 0x4d, 0x2f, 0xb7, 0xb7,
+	0xa1, 0x03, 0x01, 0x2d, 0xaf, 0x70, 0x5f, 0x1d, 0xe1, 0x35, 0x29, 0x93,
+	0x62, 0x69, 0x31, 0xa3, 0xf6, 0xa3, 0xf3, 0xf3, 0x65, 0x19, 0xce, 0xe8,
+	0x37, 0x08, 0xe9, 0xa0, 0x6f, 0x80, 0x68, 0x06, 0xe2, 0x62, 0xf2, 0x35,
+	0x1b, 0x45, 0x0d, 0x26, 0x3d, 0x61, 0x8c, 0x6c, 0x3e, 0x21, 0x51, 0x42,
+	0x12, 0x8d, 0x19, 0x59, 0x6e, 0xb8, 0xab, 0xac, 0x0a, 0xcd, 0xf8, 0x1b,
+	0x48, 0xd9, 0x34, 0x17, 0xdf, 0xdd, 0x04, 0xb9, 0x31, 0x36, 0xd7, 0x3b,
+	0x3c, 0x4a, 0x30, 0x71, 0xf6, 0x7b, 0x9d, 0xcb, 0xf6, 0xfd, 0xf4, 0x9b,
+	0xff, 0x3c, 0x07, 0x62, 0xc0, 0x04, 0x30, 0x1d, 0x38, 0x4a, 0x6d, 0x8e,
+	0x23, 0xbb, 0x65, 0x7c, 0xa6, 0xb0, 0xa4, 0x48,
+};
+
+static const uint8_t rsa4096_n[] = {
+	0xbd, 0xa3, 0xc7, 0x25, 0x69, 0xa3, 0x99, 0x34, 0x2c, 0x58, 0xa0, 0x7e,
+	0xaa, 0x00, 0x8d, 0x84, 0x66, 0x14, 0x4f, 0xa8, 0x1f, 0xf6, 0xc7, 0xf9,
+	0x1b, 0xee, 0xda, 0x70, 0x50, 0x88, 0x9d, 0x8e, 0xab, 0xab, 0x23, 0xf7,
+	0x9c, 0xb3, 0xf2, 0xc2, 0xd7, 0x53, 0x9a, 0x7b, 0x43, 0x7d, 0x9a, 0x2e,
+	0x9e, 0x79, 0x57, 0xd2, 0x8f, 0x97, 0x8f, 0xb2, 0x8c, 0x1d, 0xac, 0x6a,
+	0x68, 0x25, 0xd8, 0x19, 0x15, 0x1f, 0x2e, 0x44, 0xef, 0xab, 0xbe, 0x13,
+	0x63, 0xbd, 0x64, 0x8c, 0xcc, 0x9b, 0x9d, 0x27, 0x04, 0x2c, 0x44, 0x60,
+	0x94, 0x60, 0xfd, 0x3c, 0x8a, 0x30, 0x46, 0xe7, 0x40, 0x90, 0x85, 0x89,
+	0xdd, 0x51, 0xc0, 0x39, 0x07, 0x10, 0x4d, 0x80, 0x8b, 0x7d, 0x02, 0x8a,
+	0x30, 0x92, 0xca, 0x9b, 0xe2, 0x73, 0xdc, 0x36, 0xd0, 0xa9, 0x7a, 0x42,
+	0x3d, 0xf6, 0x7e, 0x30, 0x58, 0xbb, 0x19, 0x70, 0x40, 0x44, 0x79, 0xf0,
+	0xce, 0x96, 0x26, 0xed, 0x0f, 0xd4, 0x58, 0xb8, 0x05, 0xe0, 0x93, 0x28,
+	0x80, 0x90, 0xd0, 0x25, 0x24, 0x21, 0x5e, 0xf4, 0x71, 0xfe, 0x62, 0x32,
+	0x19, 0x4d, 0xf9, 0x7d, 0x78, 0x58, 0xf5, 0x78, 0x30, 0x01, 0x33, 0x42,
+	0xd7, 0x1d, 0x34, 0x57, 0x42, 0x97, 0xf6, 0x17, 0xef, 0x1f, 0x80, 0x83,
+	0x01, 0x9e, 0xa3, 0x9d, 0x96, 0x9d, 0x35, 0x77, 0x63, 0x2d, 0x72, 0x32,
+	0x70, 0xae, 0x4d, 0x75, 0xe4, 0xe0, 0xe9, 0x92, 0x13, 0xab, 0x43, 0x6b,
+	0xe4, 0x60, 0x3c, 0x44, 0x54, 0xc0, 0xd1, 0x8f, 0x12, 0xef, 0x15, 0x7e,
+	0xcb, 0x6c, 0xc7, 0x2f, 0x8f, 0xa4, 0xb8, 0x6c, 0xcb, 0xe7, 0x26, 0x58,
+	0x29, 0xe3, 0x74, 0xb7, 0x0d, 0x8f, 0xe1, 0xe7, 0x5c, 0xdc, 0xe2, 0x1b,
+	0x5c, 0x34, 0x3b, 0xf6, 0x36, 0xf3, 0xef, 0x16, 0x4d, 0x2a, 0x74, 0xf9,
+	0x92, 0xc7, 0x0e, 0x93, 0x36, 0xb2, 0x31, 0xb6, 0xbc, 0x83, 0xa9, 0x04,
+	0xd2, 0x13, 0x3c, 0x57, 0x5d, 0xdc, 0x94, 0x57, 0x73, 0x13, 0xd8, 0x9e,
+	0x2f, 0x02, 0x3e, 0x9c, 0x73, 0x03, 0x0e, 0x89, 0x56, 0xed, 0xd7, 0x63,
+	0x81, 0xfc, 0x47, 0xad, 0x98, 0x4d, 0x3f, 0xbd, 0x1e, 0x8a, 0xdc, 0x3a,
+	0x07, 0xf5, 0x0c, 0x8b, 0x1a, 0x76, 0x95, 0x52, 0x4c, 0xea, 0x90, 0xfe,
+	0xb2, 0xe6, 0x10, 0x04, 0x52, 0xef, 0xf8, 0x5c, 0x52, 0x45, 0x60, 0x60,
+	0xa4, 0xe2, 0x7a, 0xcc, 0xf1, 0x15, 0x75, 0xb4, 0xbd, 0x88, 0xf0, 0xfe,
+	0xbf, 0x82, 0x73, 0x7b, 0xdd, 0xc7, 0xe4, 0x6e, 0x17, 0xb5, 0xcd, 0x91,
+	0x6b, 0xde, 0xd4, 0x3b, 0x87, 0xda, 0xac, 0xf6, 0xc4, 0x72, 0x27, 0x1c,
+	0x11, 0x3c, 0x5e, 0x6d, 0x02, 0x99, 0x26, 0x58, 0x50, 0xad, 0x48, 0x43,
+	0xd6, 0x72, 0xab, 0x98, 0x9a, 0x57, 0xd0, 0x86, 0xbd, 0xe2, 0x65, 0x8d,
+	0x14, 0x95, 0xc7, 0x3d, 0xa6, 0xd4, 0x43, 0xaa, 0x16, 0x47, 0xc4, 0x31,
+	0x68, 0xbf, 0x00, 0xd0, 0x06, 0x6b, 0x25, 0x69, 0x83, 0x06, 0xc1, 0xe9,
+	0xfd, 0x36, 0xa1, 0xa0, 0x59, 0x60, 0xe5, 0xec, 0xad, 0xb4, 0xec, 0x3c,
+	0xeb, 0x39, 0x87, 0x32, 0x36, 0x81, 0xa3, 0x8d, 0xc2, 0x21, 0x25, 0xce,
+	0x15, 0xc4, 0x51, 0x5d, 0x29, 0x65, 0x0d, 0xba, 0xc7, 0x4d, 0xd3, 0x3d,
+	0xb1, 0x78, 0xdb, 0xa4, 0xf1, 0xb3, 0x0e, 0x6f, 0x82, 0x59, 0xb5, 0xb0,
+	0x28, 0xef, 0x60, 0xba, 0xe9, 0x2d, 0x77, 0xd6, 0x67, 0xe2, 0x4c, 0x88,
+	0x4e, 0xb6, 0x5a, 0xd2, 0x44, 0x37, 0xe6, 0x1c, 0x21, 0xf7, 0x31, 0xf7,
+	0x70, 0xca, 0x69, 0xee, 0x77, 0xcc, 0x10, 0x92, 0x31, 0xc9, 0xf6, 0x28,
+	0xa4, 0xd6, 0x22, 0xce, 0xb0, 0xf2, 0xbc, 0x77, 0xf6, 0xed, 0x9a, 0x0a,
+	0xc2, 0x91, 0x24, 0x9d, 0x98, 0xba, 0x6b, 0x2d,
+};
+
+static const uint8_t rsa4096_d[] = {
+	0xaa, 0xeb, 0x00, 0xa3, 0x14, 0x9a, 0x11, 0x8b, 0xb7, 0x68, 0x4d, 0x86,
+	0xbb, 0xbb, 0xf1, 0xd0, 0x61, 0x9c, 0x6e, 0xca, 0xcd, 0xbc, 0x43, 0x31,
+	0x9e, 0xde, 0x60, 0xdc, 0x17, 0x89, 0x79, 0xcf, 0xcb, 0xa3, 0x5c, 0xb0,
+	0x5f, 0xf8, 0xc3, 0x94, 0x9e, 0x33, 0xc8, 0xa8, 0xce, 0x04, 0x57, 0x41,
+	0x2b, 0x2d, 0x9c, 0x5c, 0xb7, 0x74, 0x57, 0x5c, 0x09, 0xf2, 0xf8, 0xa1,
+	0x92, 0xaa, 0x81, 0x20, 0xe2, 0x2b, 0x8f, 0x2d, 0x2c, 0x82, 0x32, 0xb7,
+	0x11, 0x0e, 0xf2, 0xa0, 0x00, 0x0d, 0x44, 0xcf, 0x94, 0x70, 0x3d, 0x54,
+	0x7a, 0x87, 0x0b, 0xd6, 0x53, 0x89, 0xfd, 0x6d, 0x91, 0x80, 0x70, 0x0a,
+	0xf8, 0x81, 0x24, 0xe9, 0x81, 0x17, 0x4d, 0x72, 0xcc, 0xc5, 0x67, 0xd3,
+	0x9a, 0xc1, 0xc2, 0x80, 0x4a, 0xd2, 0x37, 0xa8, 0xe3, 0xd9, 0xcb, 0xca,
+	0x06, 0x44, 0xb2, 0x28, 0xea, 0xdf, 0xfe, 0xa6, 0x70, 0x16, 0x07, 0x7d,
+	0x65, 0x04, 0x69, 0xa3, 0x01, 0xc0, 0x56, 0x11, 0xcd, 0xa2, 0x41, 0x9f,
+	0xa0, 0x78, 0x64, 0x51, 0x05, 0x46, 0x5a, 0x69, 0xa0, 0x90, 0x30, 0x7a,
+	0x8c, 0xd9, 0xfd, 0x41, 0xfb, 0x84, 0xda, 0x00, 0x6f, 0xeb, 0xb5, 0x02,
+	0xca, 0x14, 0x95, 0x47, 0x0c, 0x4b, 0x1f, 0xcf, 0x24, 0x82, 0xd4, 0xf5,
+	0xbe, 0x30, 0xf7, 0xb0, 0x21, 0xbe, 0x21, 0x21, 0x30, 0x2f, 0x16, 0x9c,
+	0xa5, 0x78, 0x43, 0x72, 0x3d, 0x4e, 0x04, 0xd5, 0xd6, 0x8a, 0x66, 0x22,
+	0xc8, 0xdb, 0x7f, 0x95, 0xea, 0x79, 0x3a, 0xa6, 0x63, 0xdf, 0x3e, 0x15,
+	0x60, 0x4c, 0xf3, 0x1d, 0x47, 0xae, 0xa3, 0x55, 0xd3, 0x54, 0xca, 0xf7,
+	0x6d, 0x11, 0x86, 0xf1, 0x30, 0xf4, 0xfc, 0x1a, 0xe5, 0x54, 0x63, 0x29,
+	0x5b, 0xa9, 0xec, 0x5d, 0x15, 0xdc, 0x37, 0x21, 0x77, 0x7d, 0x0b, 0x9e,
+	0xa0, 0x8e, 0x6d, 0xef, 0xec, 0x76, 0x92, 0x1d, 0xa3, 0xdf, 0x09, 0x1c,
+	0x5d, 0x17, 0x89, 0x7e, 0xcd, 0xbe, 0xc1, 0xe2, 0x17, 0xbb, 0x72, 0xa0,
+	0x40, 0x9f, 0xba, 0xa6, 0xca, 0x40, 0x3c, 0x18, 0x5a, 0x25, 0x41, 0x51,
+	0x23, 0x76, 0xd8, 0x4b, 0x98, 0x3c, 0x88, 0x58, 0x83, 0x45, 0x17, 0xf9,
+	0x52, 0x02, 0x25, 0x04, 0x97, 0xe1, 0x74, 0xdd, 0x18, 0xd9, 0xfb, 0xce,
+	0xce, 0x3d, 0xc6, 0x28, 0xf0, 0x57, 0x42, 0xcd, 0x34, 0x9f, 0x49, 0x96,
+	0xbf, 0xdf, 0x53, 0x65, 0xc4, 0x54, 0x61, 0x2b, 0xab, 0xb4, 0x07, 0x44,
+	0x3e, 0xad, 0x04, 0xbf, 0xbd, 0x2c, 0xd5, 0x62, 0x50, 0x0f, 0xe6, 0xdd,
+	0x84, 0x6f, 0x4d, 0xb6, 0xf9, 0x88, 0x96, 0x01, 0x94, 0x04, 0xcc, 0xa4,
+	0x50, 0x01, 0xee, 0x69, 0x8e, 0x88, 0x30, 0xb8, 0x9c, 0x1b, 0xe5, 0x04,
+	0x2b, 0xcc, 0xfd, 0xec, 0x73, 0xcc, 0xab, 0x5d, 0x05, 0x2a, 0xdc, 0xbe,
+	0xf2, 0x1d, 0x2e, 0x9e, 0xd9, 0x64, 0xda, 0x0b, 0xf6, 0x60, 0x4c, 0x59,
+	0xe7, 0x9c, 0x0f, 0x22, 0x5a, 0xf8, 0xc9, 0xfb, 0x1a, 0x0e, 0x55, 0x54,
+	0x17, 0xb7, 0xdb, 0x57, 0x04, 0x36, 0xba, 0xc9, 0xb5, 0xe4, 0x7c, 0x8e,
+	0xe5, 0x13, 0xdf, 0x5f, 0x73, 0xe6, 0x1c, 0x1d, 0x67, 0x3e, 0x00, 0x5e,
+	0x35, 0xe9, 0x2c, 0x80, 0xdd, 0x18, 0x1c, 0x8c, 0x75, 0x79, 0x5c, 0x70,
+	0x0d, 0xb2, 0x1d, 0x53, 0x1e, 0xc4, 0xef, 0xfa, 0x7a, 0xda, 0xaf, 0xa0,
+	0xb1, 0x85, 0x2a, 0x5e, 0xf0, 0x93, 0x98, 0xfd, 0x70, 0x99, 0x19, 0x30,
+	0xd1, 0x60, 0xaf, 0x75, 0x7a, 0x49, 0xef, 0xcc, 0xc1, 0xa4, 0x0a, 0xb4,
+	0x30, 0xe5, 0xee, 0xe9, 0xec, 0x05, 0xf9, 0x0f, 0x02, 0x5d, 0x7e, 0x7e,
+	0x7e, 0x51, 0xd0, 0x52, 0xe9, 0xc9, 0xa4, 0x23, 0x4f, 0x17, 0xd3, 0x6f,
+	0x8b, 0xab, 0x94, 0x7d, 0x3e, 0x85, 0x7d, 0xc1,
+};
+
+static const uint8_t rsa4096_p[] = {
+	0xed, 0x60, 0x8b, 0x43, 0xe9, 0x8f, 0xa1, 0x2f, 0x3f, 0x2b, 0x61, 0x22,
+	0x49, 0x56, 0x3f, 0x4e, 0x6d, 0xfe, 0x95, 0xc4, 0x80, 0x71, 0x7e, 0x3b,
+	0x44, 0x75, 0x06, 0xa0, 0x14, 0x8b, 0x43, 0x80, 0x5d, 0x5f, 0x8d, 0x4c,
+	0x61, 0x71, 0x6a, 0x56, 0xd9, 0xd2, 0xd8, 0x3b, 0x20, 0x54, 0xe6, 0xcc,
+	0xb1, 0xb8, 0x5c, 0x95, 0x03, 0x03, 0xb5, 0x39, 0x25, 0xf5, 0x8f, 0x5d,
+	0xc1, 0x47, 0x6a, 0x99, 0xa9, 0xc7, 0xa2, 0x0c, 0xc5, 0xd5, 0x4c, 0xd5,
+	0x4e, 0xd5, 0x73, 0x37, 0x38, 0x61, 0x4e, 0xb8, 0xd8, 0x06, 0x8c, 0x5e,
+	0x81, 0xe8, 0xad, 0x8c, 0x7c, 0xf7, 0x72, 0x4c, 0x2c, 0x90, 0xb3, 0xef,
+	0xc7, 0x52, 0xbe, 0xbc, 0x59, 0x6a, 0xda, 0x5e, 0x85, 0xe9, 0x3a, 0x32,
+	0xc8, 0x53, 0xc6, 0xc6, 0x7e, 0xae, 0x95, 0xa9, 0x44, 0x97, 0xb0, 0x61,
+	0x02, 0x60, 0xc6, 0xcc, 0x19, 0xcd, 0xeb, 0x54, 0x3b, 0xc4, 0x29, 0x79,
+	0xc5, 0x6e, 0x01, 0x3b, 0x37, 0xa7, 0xc1, 0x5a, 0x91, 0x67, 0xea, 0xf3,
+	0xca, 0x10, 0x6e, 0xbf, 0x2f, 0x73, 0x4a, 0x60, 0x35, 0x04, 0x9e, 0x06,
+	0xf4, 0x07, 0xd6, 0xc5, 0x2a, 0xdb, 0xd3, 0x46, 0x0c, 0x54, 0x1a, 0x80,
+	0x95, 0xfd, 0x2a, 0x64, 0x6e, 0xbb, 0x79, 0x37, 0x73, 0x6a, 0xac, 0xd4,
+	0xb3, 0x9d, 0x20, 0xca, 0x08, 0x1e, 0x88, 0xb4, 0xc1, 0xcd, 0x03, 0x18,
+	0x11, 0x26, 0x1e, 0x2e, 0x96, 0xe8, 0x06, 0x7a, 0xfc, 0x6c, 0xf4, 0xca,
+	0xf1, 0xe3, 0x6c, 0x9d, 0x3f, 0x43, 0x73, 0x99, 0x56, 0xd9, 0x85, 0xe4,
+	0xcf, 0x7e, 0x8d, 0x1f, 0xc8, 0x4c, 0x0f, 0x94, 0xc9, 0x51, 0x0b, 0x31,
+	0xb4, 0x9f, 0x2f, 0x1c, 0xe3, 0x5d, 0x72, 0xda, 0x14, 0x91, 0xf1, 0x2d,
+	0x05, 0xe7, 0x07, 0x6d, 0x8a, 0x15, 0xf2, 0x03, 0x2d, 0x3b, 0xe9, 0x29,
+	0x03, 0x9a, 0xf3, 0xb1,
+};
+
+static const uint8_t rsa4096_q[] = {
+	0xcc, 0x84, 0x7b, 0x5c, 0xda, 0xcf, 0xf3, 0x1a, 0x4c, 0x55, 0xa8, 0x3c,
+	0xc0, 0x1b, 0x98, 0x32, 0x4d, 0xaf, 0x55, 0xe0, 0xce, 0x56, 0xa9, 0x2e,
+	0x74, 0xd8, 0x31, 0xa0, 0xd8, 0x43, 0x50, 0x68, 0x98, 0x13, 0x75, 0xf0,
+	0x4d, 0x0f, 0xc3, 0x04, 0xbe, 0xbb, 0xa6, 0x9c, 0xbb, 0xea, 0x20, 0x1b,
+	0x37, 0x00, 0x35, 0x75, 0xe0, 0xa9, 0x69, 0x61, 0x1f, 0x18, 0x31, 0x2f,
+	0xd8, 0x07, 0x9a, 0x7a, 0x94, 0xb5, 0x59, 0x3b, 0x2c, 0x7f, 0x1a, 0x80,
+	0xad, 0x90, 0xcd, 0x99, 0xfe, 0xd6, 0xd7, 0xbf, 0xf6, 0xf3, 0x7c, 0x82,
+	0xc5, 0x9b, 0x88, 0x00, 0x52, 0x86, 0x31, 0x15, 0xd3, 0xb7, 0x9b, 0x9e,
+	0xd3, 0x87, 0x71, 0x5c, 0xf9, 0x33, 0x90, 0xa4, 0x43, 0xe2, 0xa8, 0x65,
+	0x99, 0x4b, 0xdf, 0x91, 0x7c, 0xc0, 0x1a, 0xc8, 0x05, 0x97, 0x6a, 0x1c,
+	0x61, 0x99, 0x16, 0x7d, 0x69, 0x4e, 0x69, 0x44, 0x9e, 0x6e, 0x06, 0x68,
+	0x16, 0xdd, 0xa0, 0x55, 0xed, 0xfa, 0xc0, 0x0b, 0xce, 0xd2, 0xeb, 0x57,
+	0x63, 0x3d, 0x2a, 0x03, 0x34, 0x74, 0xa1, 0xfd, 0x0e, 0x09, 0xfa, 0xe6,
+	0xbb, 0x00, 0xc7, 0x58, 0x80, 0x1a, 0x8d, 0x8a, 0x4e, 0xf0, 0xfc, 0x64,
+	0x80, 0x50, 0x1e, 0x25, 0xf3, 0xcb, 0x70, 0x8b, 0x1c, 0xef, 0xfb, 0x17,
+	0xbe, 0xf2, 0xdd, 0x59, 0x2b, 0xed, 0x57, 0x12, 0x51, 0x14, 0x1d, 0x5a,
+	0x3d, 0xed, 0x79, 0xf9, 0xaa, 0x04, 0x30, 0xe0, 0x79, 0x00, 0x7d, 0xc4,
+	0x69, 0xc8, 0xbd, 0x2f, 0x1a, 0xfd, 0xeb, 0x97, 0x8b, 0x1c, 0x34, 0x81,
+	0x83, 0x4e, 0x6b, 0xed, 0x4a, 0xb5, 0x4b, 0xd3, 0x9f, 0x8b, 0xeb, 0xb0,
+	0xb8, 0xff, 0xd8, 0x59, 0x1d, 0xa3, 0x33, 0x61, 0xec, 0xb2, 0x94, 0x62,
+	0x60, 0x9b, 0x17, 0x5d, 0x0b, 0x5c, 0x30, 0x8e, 0x26, 0xb1, 0x46, 0x25,
+	0xf6, 0x6c, 0x7a, 0x3d,
+};
+
+static const uint8_t rsa4096_dp[] = {
+	0x10, 0xcd, 0x77, 0xae, 0x2b, 0xf7, 0x35, 0xc2, 0xa1, 0x67, 0x11, 0xae,
+	0x1a, 0xa0, 0xd7, 0x44, 0x56, 0xf6, 0xe1, 0x65, 0x12, 0x6e, 0x76, 0x2f,
+	0xfd, 0xcd, 0x86, 0xd5, 0x87, 0xfe, 0xbf, 0x9d, 0x73, 0x7e, 0x93, 0x02,
+	0xe8, 0x16, 0xde, 0x1f, 0x1d, 0xb6, 0x16, 0x06, 0x41, 0x68, 0xa1, 0x19,
+	0xb6, 0x2e, 0xc5, 0xa6, 0xea, 0x9a, 0xb5, 0x96, 0x41, 0x00, 0x9b, 0xd0,
+	0x58, 0x21, 0x15, 0x03, 0xa1, 0x87, 0xf7, 0x09, 0x8e, 0x6b, 0x65, 0xcf,
+	0xe7, 0x8f, 0xa6, 0x63, 0x2f, 0x43, 0x7c, 0x0e, 0x0b, 0x84, 0x93, 0x25,
+	0x11, 0x6f, 0x05, 0xf1, 0xde, 0xda, 0xa9, 0x25, 0x89, 0x36, 0x08, 0xf6,
+	0x9d, 0x16, 0x57, 0x57, 0xff, 0xc0, 0x57, 0x8a, 0xbf, 0x51, 0xde, 0x03,
+	0xc0, 0x38, 0x65, 0xe6, 0xa1, 0x0a, 0xfc, 0x9f, 0x09, 0xb2, 0xef, 0x12,
+	0x3e, 0xd7, 0xd8, 0xda, 0x93, 0xad, 0x06, 0xce, 0x64, 0x98, 0xa3, 0x12,
+	0xf2, 0x8d, 0xb1, 0xda, 0x9e, 0x3a, 0xea, 0xad, 0xdd, 0x83, 0x0c, 0x97,
+	0x8b, 0x23, 0x14, 0xa3, 0xc5, 0xd9, 0x14, 0x57, 0xb1, 0x09, 0x0d, 0xa2,
+	0x92, 0x5d, 0x87, 0xaf, 0x57, 0x34, 0x4e, 0x45, 0x34, 0x14, 0x33, 0xf8,
+	0x0c, 0x25, 0xea, 0x7d, 0x47, 0x75, 0x4f, 0xc4, 0x44, 0x10, 0x36, 0x01,
+	0xac, 0x61, 0x1f, 0xf4, 0x0d, 0x15, 0x14, 0x3a, 0x2f, 0x49, 0xb2, 0xc1,
+	0x5e, 0x5d, 0x63, 0x5f, 0x8a, 0xe1, 0x0b, 0xac, 0x62, 0xf7, 0xd7, 0x70,
+	0x12, 0x25, 0x36, 0x07, 0xff, 0x75, 0x67, 0xd6, 0x5f, 0xd6, 0x6f, 0xea,
+	0xdd, 0x61, 0x28, 0xde, 0x2a, 0x10, 0x70, 0x3d, 0xe8, 0xee, 0x2a, 0xab,
+	0xaf, 0x0c, 0x61, 0x8a, 0x5a, 0xf1, 0xbf, 0x72, 0x7e, 0x68, 0x42, 0x39,
+	0x1c, 0xa4, 0xd8, 0xda, 0xc1, 0x1e, 0x82, 0x8e, 0x05, 0x02, 0xab, 0xa3,
+	0x72, 0x94, 0xe2, 0x51,
+};
+
+static const uint8_t rsa4096_dq[] = {
+	0x3b, 0x63, 0x91, 0x4b, 0x32, 0x83, 0x46, 0x6d, 0xf1, 0x92, 0xc2, 0x2a,
+	0xfa, 0x02, 0x49, 0x5c, 0xfa, 0x30, 0x1b, 0x39, 0x0f, 0xd2, 0x1c, 0x88,
+	0xd0, 0x07, 0x63, 0xc9, 0xf8, 0x62, 0xfb, 0xbb, 0x93, 0xc5, 0xba, 0xee,
+	0xd0, 0x01, 0xee, 0xb8, 0xb7, 0x06, 0x58, 0xe8, 0x94, 0xac, 0xf5, 0x2b,
+	0xd1, 0xf9, 0xee, 0x8c, 0x4f, 0x74, 0x02, 0x94, 0xe0, 0x69, 0xaf, 0x06,
+	0xdc, 0xad, 0xc0, 0x8f, 0x2e, 0x15, 0xc7, 0x56, 0xa6, 0xa2, 0x36, 0x38,
+	0xfd, 0xad, 0xd9, 0xf6, 0x89, 0x09, 0x2c, 0x57, 0xa3, 0x47, 0xab, 0x75,
+	0x72, 0x1a, 0xab, 0x10, 0xa4, 0xe6, 0x30, 0xe4, 0xcc, 0xb9, 0x39, 0xa8,
+	0x92, 0x76, 0x77, 0x55, 0xef, 0x4b, 0xa9, 0x09, 0xfa, 0x68, 0x9c, 0x4b,
+	0xfc, 0x8b, 0x0a, 0xdd, 0xfd, 0xa2, 0xef, 0x63, 0xfc, 0x33, 0xae, 0xed,
+	0x94, 0xed, 0xd6, 0x99, 0x0e, 0x76, 0x65, 0x9d, 0x36, 0x80, 0x6e, 0xbd,
+	0xd5, 0x3e, 0x00, 0x6c, 0x53, 0x92, 0x08, 0x28, 0xa5, 0xa3, 0x9c, 0x11,
+	0xa1, 0x50, 0xc6, 0x9d, 0x6d, 0xa3, 0x1c, 0xd3, 0x16, 0x3b, 0x91, 0xaf,
+	0x64, 0xc8, 0x62, 0x1a, 0xf2, 0x00, 0x43, 0xef, 0xd0, 0xe2, 0xab, 0xf8,
+	0x27, 0x46, 0x9c, 0xaa, 0x9a, 0xb4, 0x0d, 0xf7, 0x67, 0xac, 0xcc, 0x76,
+	0x65, 0xcd, 0xb2, 0xb7, 0x4d, 0x49, 0x3b, 0x8a, 0xa7, 0x1e, 0xb7, 0x33,
+	0x58, 0x5e, 0x58, 0x98, 0x46, 0x65, 0xb7, 0x27, 0xc8, 0x1b, 0x7b, 0x6a,
+	0x08, 0xe9, 0xf0, 0xfd, 0xf7, 0xd1, 0x9a, 0x93, 0x44, 0x23, 0x29, 0xa0,
+	0x1e, 0x58, 0x2c, 0x81, 0x18, 0xbb, 0xb2, 0xcc, 0x3e, 0x3d, 0x6c, 0x70,
+	0xc2, 0x18, 0x11, 0x64, 0x37, 0x76, 0x07, 0xda, 0xbc, 0xd8, 0x52, 0xbc,
+	0x8a, 0x9f, 0x1e, 0xd6, 0xb7, 0x10, 0xcb, 0x4c, 0xcc, 0x31, 0x98, 0x54,
+	0x37, 0xcd, 0xe2, 0x65,
+};
+
+static const uint8_t rsa4096_qp[] = {
+	0xde, 0x33, 0x09, 0x89, 0xf0, 0xef, 0x05, 0xec, 0x57, 0x12, 0x8f, 0x54,
+	0x3e, 0xf6, 0xba, 0x2f, 0x58, 0x63, 0x34, 0xa0, 0x39, 0x45, 0xa0, 0x0b,
+	0x17, 0xa1, 0x02, 0x65, 0x56, 0xfb, 0x80, 0x85, 0x50, 0x72, 0x6f, 0x03,
+	0xbc, 0x08, 0xbd, 0xad, 0xc0, 0x43, 0x69, 0xdd, 0x18, 0xe4, 0xec, 0x3d,
+	0x8d, 0x4f, 0x12, 0xa0, 0xcb, 0x5a, 0x75, 0x37, 0xd1, 0x77, 0xee, 0xf7,
+	0x75, 0x1b, 0xfe, 0x4c, 0xdb, 0x44, 0x1c, 0x55, 0x67, 0x08, 0x4e, 0x55,
+	0xbe, 0xde, 0x8a, 0xad, 0xfb, 0xdd, 0x12, 0xb1, 0xa4, 0xbf, 0x4c, 0x5b,
+	0x4b, 0x96, 0x72, 0xaf, 0x81, 0xad, 0xb1, 0x73, 0x20, 0xe9, 0xbb, 0xa3,
+	0x6f, 0x09, 0x99, 0x28, 0x62, 0xc3, 0x09, 0x90, 0x8a, 0x6b, 0xd2, 0xd4,
+	0x87, 0x9a, 0x2f, 0x77, 0xe8, 0xfc, 0x59, 0xa7, 0x42, 0xc9, 0x60, 0xc9,
+	0x85, 0x51, 0x70, 0x7c, 0xf5, 0x32, 0x37, 0x56, 0xb3, 0xe6, 0x93, 0x32,
+	0xbb, 0xeb, 0xf3, 0xfc, 0x32, 0xc3, 0x18, 0xf6, 0xee, 0xa1, 0x21, 0x3a,
+	0x3c, 0xc6, 0xe0, 0x28, 0x1c, 0xed, 0xff, 0xcc, 0xac, 0xd2, 0xc0, 0x67,
+	0x70, 0x9c, 0x0b, 0x19, 0xd0, 0x33, 0x2f, 0xcd, 0xcb, 0x6d, 0xc4, 0xfa,
+	0x6e, 0x59, 0xbe, 0xe3, 0x02, 0x49, 0xec, 0xd6, 0xac, 0x8c, 0xf4, 0x64,
+	0x3a, 0xfe, 0xc9, 0x1f, 0x74, 0x78, 0xca, 0xea, 0xb5, 0x01, 0x7b, 0x85,
+	0x3b, 0x21, 0x24, 0xe0, 0x48, 0x63, 0x81, 0x25, 0x33, 0x00, 0x70, 0xe4,
+	0x1c, 0x11, 0x4f, 0x86, 0x8f, 0x22, 0x88, 0x33, 0x4c, 0x99, 0x20, 0x32,
+	0x69, 0x94, 0x18, 0xca, 0xee, 0x99, 0xd8, 0x4d, 0xbe, 0xeb, 0x3c, 0x54,
+	0x1b, 0x28, 0x67, 0x7a, 0xbb, 0x9d, 0x3f, 0xf6, 0x67, 0x38, 0xdb, 0x7a,
+	0x0d, 0xfa, 0xf9, 0x3f, 0x34, 0x11, 0xad, 0x04, 0x45, 0xd3, 0x1a, 0x64,
+	0x5d, 0x95, 0x64, 0x41,
+};
+
+#define RSA_PERF_KEY(bits) { \
+		.key_bits = (bits), \
+		.n = rsa##bits##_n, .d = rsa##bits##_d, \
+		.p = rsa##bits##_p, .q = rsa##bits##_q, \
+		.dp = rsa##bits##_dp, .dq = rsa##bits##_dq, \
+		.qp = rsa##bits##_qp, \
+	}
+
+static const struct rsa_perf_key {
+	size_t key_bits;
+	const uint8_t *n;
+	const uint8_t *d;
+	const uint8_t *p;
+	const uint8_t *q;
+	const uint8_t *dp;
+	const uint8_t *dq;
+	const uint8_t *qp;
+} rsa_perf_keys[] = {
+	RSA_PERF_KEY(2048),
+	RSA_PERF_KEY(4096),
+};
+
+static const struct rsa_perf_key *rsa_perf_find_key(size_t key_bits)
+{
+	size_t n;
+
+	for (n = 0; n < ARRAY_SIZE(rsa_perf_keys); n++)
+		if (rsa_perf_keys[n].key_bits == key_bits)
+			return rsa_perf_keys + n;
+	return NULL;
+}
+
+static void rsa_perf_free_key(struct rsa_keypair *kp)
+{
+	crypto_bignum_free(kp->e);
+	crypto_bignum_free(kp->d);
+	crypto_bignum_free(kp->n);
+	crypto_bignum_free(kp->p);
+	crypto_bignum_free(kp->q);
+	crypto_bignum_free(kp->qp);
+	crypto_bignum_free(kp->dp);
+	crypto_bignum_free(kp->dq);
+}
+
+static TEE_Result rsa_perf_load_key(const struct rsa_perf_key *k,
+				    struct rsa_keypair *kp)
+{
+	size_t mod_len = k->key_bits / 8;
+	size_t half_len = mod_len / 2;
+	TEE_Result res;
+
+	res = crypto_acipher_alloc_rsa_keypair(kp, k->key_bits);
+	if (res)
+		return res;
+
+	res = crypto_bignum_bin2bn(rsa_perf_e, sizeof(rsa_perf_e), kp->e);
+	if (!res)
+		res = crypto_bignum_bin2bn(k->n, mod_len, kp->n);
+	if (!res)
+		res = crypto_bignum_bin2bn(k->d, mod_len, kp->d);
+	if (!res)
+		res = crypto_bignum_bin2bn(k->p, half_len, kp->p);
+	if (!res)
+		res = crypto_bignum_bin2bn(k->q, half_len, kp->q);
+	if (!res)
+		res = crypto_bignum_bin2bn(k->dp, half_len, kp->dp);
+	if (!res)
+		res = crypto_bignum_bin2bn(k->dq, half_len, kp->dq);
+	if (!res)
+		res = crypto_bignum_bin2bn(k->qp, half_len, kp->qp);
+	if (res)
+		rsa_perf_free_key(kp);
+	return res;
+}
+
+/*
+ * Reports the cost of an RSA private key operation (raw RSA decryption
+ * using the CRT parameters) with the bignum library the core is built
+ * with:
+ *
+ * [in]  value[0].a	Key size in bits, 2048 or 4096
+ * [in]  value[0].b	Number of iterations
+ * [out] value[1].a	Thousands of cycles per operation
+ * [out] value[1].b	Microseconds per operation
+ */
+TEE_Result core_rsa_perf_tests(uint32_t nParamTypes,
+			       TEE_Param pParams[TEE_NUM_PARAMS])
+{
+	uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+					  TEE_PARAM_TYPE_VALUE_OUTPUT,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE);
+	const struct rsa_perf_key *k;
+	struct rsa_keypair kp;
+	TEE_Result res = TEE_SUCCESS;
+	uint32_t num_iter;
+	uint64_t cycles;
+	uint64_t cnt;
+	size_t mod_len;
+	size_t dlen;
+	uint8_t *src;
+	uint8_t *dst;
+	uint32_t n;
+
+	if (nParamTypes != exp_pt || !pParams[0].value.b)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	k = rsa_perf_find_key(pParams[0].value.a);
+	if (!k)
+		return TEE_ERROR_NOT_SUPPORTED;
+	num_iter = pParams[0].value.b;
+	mod_len = k->key_bits / 8;
+
+	src = malloc(mod_len);
+	dst = malloc(mod_len);
+	if (!src || !dst) {
+		res = TEE_ERROR_OUT_OF_MEMORY;
+		goto out;
+	}
+
+	res = rsa_perf_load_key(k, &kp);
+	if (res)
+		goto out;
+
+	/* Any input with the most significant byte cleared is below n */
+	for (n = 0; n < mod_len; n++)
+		src[n] = n;
+
+	cnt = read_cntpct();
+	cycles = read_pmccntr();
+
+	for (n = 0; n < num_iter && !res; n++) {
+		dlen = mod_len;
+		res = crypto_acipher_rsanopad_decrypt(&kp, src, mod_len, dst,
+						      &dlen);
+	}
+
+	cycles = read_pmccntr() - cycles;
+	cnt = read_cntpct() - cnt;
+	rsa_perf_free_key(&kp);
+	if (res)
+		goto out;
+
+	pParams[1].value.a = cycles / num_iter / 1000;
+	pParams[1].value.b = (cnt * 1000000) / read_cntfrq() / num_iter;
+
+	IMSG("RSA-%zu private: %" PRIu32 " kcycles, %" PRIu32 " us per op",
+	     k->key_bits, pParams[1].value.a, pParams[1].value.b);
+out:
+	free(src);
+	free(dst);
+	return res;
+}
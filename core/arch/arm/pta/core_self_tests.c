@@ -6,6 +6,7 @@
 #include <malloc.h>
 #include <stdbool.h>
 #include <trace.h>
+#include <kernel/handle.h>
 #include <kernel/panic.h>
 #include <util.h>
 #include "core_self_tests.h"
@@ -465,6 +466,50 @@ static int self_test_nex_malloc(void)
 	return 0;
 }
 #endif
+
+/* test handle allocation, release and detection of stale handles */
+static int self_test_handle_db(void)
+{
+	struct handle_db db = HANDLE_DB_INITIALIZER;
+	int h[10] = { 0 };
+	int stale = 0;
+	int ret = 0;
+	size_t n;
+
+	LOG("handle_db tests (handle_get, handle_put, handle_lookup):");
+
+	for (n = 0; n < ARRAY_SIZE(h); n++) {
+		h[n] = handle_get(&db, h + n);
+		if (h[n] < 0 || handle_lookup(&db, h[n]) != h + n)
+			ret = -1;
+	}
+
+	stale = h[3];
+	if (handle_put(&db, h[3]) != h + 3 || handle_lookup(&db, stale) ||
+	    handle_put(&db, stale))
+		ret = -1;
+
+	/* The released entry is reused but the old handle stays invalid */
+	h[3] = handle_get(&db, h + 3);
+	if (h[3] < 0 || h[3] == stale || handle_lookup(&db, stale) ||
+	    handle_lookup(&db, h[3]) != h + 3)
+		ret = -1;
+
+	if (handle_get(&db, NULL) != -1 || handle_lookup(&db, -1) ||
+	    handle_put(&db, -1))
+		ret = -1;
+
+	for (n = 0; n < ARRAY_SIZE(h); n++)
+		if (handle_put(&db, h[n]) != h + n)
+			ret = -1;
+
+	handle_db_destroy(&db);
+	LOG("  => test %s", ret ? "FAILED" : "ok");
+	LOG("");
+
+	return ret;
+}
+
 /* exported entry points for some basic test */
 TEE_Result core_self_tests(uint32_t nParamTypes __unused,
 		TEE_Param pParams[TEE_NUM_PARAMS] __unused)
@@ -472,7 +517,7 @@ TEE_Result core_self_tests(uint32_t nParamTypes __unused,
 	if (self_test_mul_signed_overflow() || self_test_add_overflow() ||
 	    self_test_sub_overflow() || self_test_mul_unsigned_overflow() ||
 	    self_test_division() || self_test_malloc() ||
-	    self_test_nex_malloc()) {
+	    self_test_nex_malloc() || self_test_handle_db()) {
 		EMSG("some self_test_xxx failed! you should enable local LOG");
 		return TEE_ERROR_GENERIC;
 	}
@@ -19,6 +19,58 @@ TEE_Result core_fs_htree_tests(uint32_t nParamTypes,
 TEE_Result core_mutex_tests(uint32_t nParamTypes,
 			    TEE_Param pParams[TEE_NUM_PARAMS]);
 
+TEE_Result core_aes_gcm_tests(uint32_t nParamTypes,
+			      TEE_Param pParams[TEE_NUM_PARAMS]);
+
+TEE_Result core_aes_gcm_perf_tests(uint32_t nParamTypes,
+				   TEE_Param pParams[TEE_NUM_PARAMS]);
+
+TEE_Result core_rsa_perf_tests(uint32_t nParamTypes,
+			       TEE_Param pParams[TEE_NUM_PARAMS]);
+
+TEE_Result core_handle_perf_tests(uint32_t nParamTypes,
+				  TEE_Param pParams[TEE_NUM_PARAMS]);
+
+TEE_Result core_msg_param_tests(uint32_t nParamTypes,
+				TEE_Param pParams[TEE_NUM_PARAMS]);
+
+/* libmpa is only part of the core when it isn't replaced by MbedTLS */
+#ifndef CFG_CORE_MBEDTLS_MPI
+TEE_Result core_mpa_tests(uint32_t nParamTypes,
+			  TEE_Param pParams[TEE_NUM_PARAMS]);
+#else
+static inline TEE_Result core_mpa_tests(
+		uint32_t nParamTypes __unused,
+		TEE_Param pParams[TEE_NUM_PARAMS] __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
+#ifdef CFG_TA_IMAGE_CACHE
+TEE_Result core_ta_image_cache_tests(uint32_t nParamTypes,
+				     TEE_Param pParams[TEE_NUM_PARAMS]);
+#else
+static inline TEE_Result core_ta_image_cache_tests(
+		uint32_t nParamTypes __unused,
+		TEE_Param pParams[TEE_NUM_PARAMS] __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
+#if defined(CFG_CORE_ASYNC_NOTIF) && defined(CFG_SYSTEM_PTA)
+TEE_Result core_notif_tests(uint32_t nParamTypes,
+			    TEE_Param pParams[TEE_NUM_PARAMS]);
+#else
+static inline TEE_Result core_notif_tests(
+		uint32_t nParamTypes __unused,
+		TEE_Param pParams[TEE_NUM_PARAMS] __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
 #ifdef CFG_LOCKDEP
 TEE_Result core_lockdep_tests(uint32_t nParamTypes,
 			      TEE_Param pParams[TEE_NUM_PARAMS]);
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2019, Linaro Limited
+ */
+
+#include <kernel/user_ta.h>
+#include <pta_invoke_tests.h>
+#include <tee/uuid.h>
+#include <trace.h>
+
+#include "core_self_tests.h"
+
+static TEE_Result check_info(const TEE_UUID *uuid, unsigned int pin_count,
+			     unsigned int *num_hits)
+{
+	unsigned int pc = 0;
+	TEE_Result res;
+
+	res = ta_image_cache_get_info(uuid, &pc, num_hits);
+	if (res) {
+		EMSG("get_info: %#" PRIx32, res);
+		return res;
+	}
+	if (pc != pin_count) {
+		EMSG("pin_count %u, expected %u", pc, pin_count);
+		return TEE_ERROR_GENERIC;
+	}
+
+	return TEE_SUCCESS;
+}
+
+/*
+ * Preloads, loads and releases the TA in memref[0] and checks that the
+ * image stays in the cache until the last pin is dropped and is evicted
+ * after that. The TA may already be pinned by someone else, in that case
+ * it's never evicted.
+ */
+TEE_Result core_ta_image_cache_tests(uint32_t nParamTypes,
+				     TEE_Param pParams[TEE_NUM_PARAMS])
+{
+	uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_MEMREF_INPUT,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE);
+	unsigned int pin_count = 0;
+	unsigned int num_hits = 0;
+	unsigned int hits = 0;
+	TEE_Result res;
+	TEE_UUID uuid;
+
+	if (nParamTypes != exp_pt ||
+	    pParams[0].memref.size != sizeof(TEE_UUID))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	tee_uuid_from_octets(&uuid, pParams[0].memref.buffer);
+
+	res = ta_image_cache_get_info(&uuid, &pin_count, &num_hits);
+	if (res == TEE_ERROR_ITEM_NOT_FOUND)
+		pin_count = 0;
+	else if (res)
+		return res;
+
+	res = ta_image_cache_preload(&uuid);
+	if (res) {
+		EMSG("preload: %#" PRIx32, res);
+		return res;
+	}
+	res = check_info(&uuid, pin_count + 1, &num_hits);
+	if (res)
+		goto out_release;
+
+	/*
+	 * A second preload opens the TA through the cache like a TA load
+	 * does, it must be served from the cache and take one more pin.
+	 */
+	res = ta_image_cache_preload(&uuid);
+	if (res) {
+		EMSG("second preload: %#" PRIx32, res);
+		goto out_release;
+	}
+	res = check_info(&uuid, pin_count + 2, &hits);
+	if (res)
+		goto out_release2;
+	if (hits != num_hits + 1) {
+		EMSG("num_hits %u, expected %u", hits, num_hits + 1);
+		res = TEE_ERROR_GENERIC;
+		goto out_release2;
+	}
+
+	/* Still pinned once, must survive a flush */
+	res = ta_image_cache_release(&uuid);
+	if (res) {
+		EMSG("release: %#" PRIx32, res);
+		goto out_release;
+	}
+	ta_image_cache_flush();
+	res = check_info(&uuid, pin_count + 1, &hits);
+	if (res)
+		goto out_release;
+
+	res = ta_image_cache_release(&uuid);
+	if (res) {
+		EMSG("last release: %#" PRIx32, res);
+		return res;
+	}
+	ta_image_cache_flush();
+
+	if (pin_count)
+		return check_info(&uuid, pin_count, &hits);
+
+	/* No pins left, the image must have been evicted */
+	res = ta_image_cache_get_info(&uuid, &pin_count, &hits);
+	if (res != TEE_ERROR_ITEM_NOT_FOUND) {
+		EMSG("Image not evicted: %#" PRIx32, res);
+		return TEE_ERROR_GENERIC;
+	}
+	if (ta_image_cache_release(&uuid) != TEE_ERROR_ITEM_NOT_FOUND) {
+		EMSG("Unbalanced release succeeded");
+		return TEE_ERROR_GENERIC;
+	}
+
+	return TEE_SUCCESS;
+
+out_release2:
+	ta_image_cache_release(&uuid);
+out_release:
+	ta_image_cache_release(&uuid);
+	return res;
+}
@@ -410,6 +410,22 @@ static TEE_Result invoke_command(void *pSessionContext __unused,
 		return core_mutex_tests(nParamTypes, pParams);
 	case PTA_INVOKE_TESTS_CMD_LOCKDEP:
 		return core_lockdep_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TESTS_CMD_AES_GCM_PERF:
+		return core_aes_gcm_perf_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TESTS_CMD_RSA_PERF:
+		return core_rsa_perf_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TESTS_CMD_HANDLE_PERF:
+		return core_handle_perf_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TESTS_CMD_TA_IMAGE_CACHE:
+		return core_ta_image_cache_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TESTS_CMD_AES_GCM:
+		return core_aes_gcm_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TESTS_CMD_MPA:
+		return core_mpa_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TESTS_CMD_NOTIF:
+		return core_notif_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TESTS_CMD_MSG_PARAM:
+		return core_msg_param_tests(nParamTypes, pParams);
 	default:
 		break;
 	}
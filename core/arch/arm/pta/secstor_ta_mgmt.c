@@ -5,6 +5,7 @@
 
 #include <kernel/pseudo_ta.h>
 #include <tee/tadb.h>
+#include <tee/tee_cryp_utl.h>
 #include <pta_secstor_ta_mgmt.h>
 #include <signed_hdr.h>
 #include <string_ext.h>
@@ -108,8 +109,7 @@ static TEE_Result install_ta(struct shdr *shdr, const uint8_t *nw,
 	while (offs < nw_size) {
 		size_t l = MIN(buf_size, nw_size - offs);
 
-		memcpy(buf, nw + offs, l);
-		res = crypto_hash_update(hash_ctx, hash_algo, buf, l);
+		res = tee_hash_update_copy(hash_ctx, hash_algo, buf, nw + offs, l);
 		if (res)
 			goto err_ta_finalize;
 		res = tee_tadb_ta_write(ta, buf, l);
@@ -3,14 +3,19 @@
  * Copyright (c) 2015, Linaro Limited
  */
 #include <compiler.h>
+#include <crypto/crypto.h>
 #include <stdio.h>
 #include <trace.h>
+#include <kernel/mutex.h>
 #include <kernel/pseudo_ta.h>
+#include <kernel/tee_time.h>
+#include <mm/pgt_cache.h>
 #include <mm/tee_pager.h>
 #include <mm/tee_mm.h>
 #include <string.h>
 #include <string_ext.h>
 #include <malloc.h>
+#include <mempool.h>
 
 #define TA_NAME		"stats.ta"
 
@@ -21,6 +26,10 @@
 #define STATS_CMD_PAGER_STATS		0
 #define STATS_CMD_ALLOC_STATS		1
 #define STATS_CMD_MEMLEAK_STATS		2
+#define STATS_CMD_PGT_CACHE_STATS	3
+#define STATS_CMD_BIGNUM_POOL_STATS	4
+#define STATS_CMD_GET_SYS_TIME		5
+#define STATS_CMD_MUTEX_STATS		6
 
 #define STATS_NB_POOLS			4
 
@@ -137,6 +146,131 @@ static TEE_Result get_memleak_stats(uint32_t type,
 	return TEE_SUCCESS;
 }
 
+static TEE_Result get_pgt_cache_stats(uint32_t type,
+				      TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct pgt_cache_stats stats;
+
+	/*
+	 * p[0].value.a = 0 if no reset of the stats
+	 * p[1].value.a = number of user translation tables reused
+	 * p[1].value.b = number of user translation tables populated
+	 * p[2].value.a = number of cached tables evicted
+	 * p[2].value.b = number of translation tables in the pool
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	pgt_get_cache_stats(&stats, p[0].value.a);
+	p[1].value.a = stats.hits;
+	p[1].value.b = stats.misses;
+	p[2].value.a = stats.evictions;
+	p[2].value.b = PGT_CACHE_SIZE;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result get_bignum_pool_stats(uint32_t type,
+					TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct mempool_stats stats;
+
+	/*
+	 * p[0].value.a = 0 if no reset of the stats
+	 * p[1].value.a = size in bytes of each arena
+	 * p[1].value.b = number of arenas, one per concurrent user
+	 * p[2].value.a = high-water mark in bytes of the most used arena
+	 * p[2].value.b = highest number of arenas in use at the same time
+	 * p[3].value.a = number of times a thread waited for a free arena
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	crypto_bignum_get_pool_stats(&stats, p[0].value.a);
+	p[1].value.a = stats.arena_size;
+	p[1].value.b = stats.num_arenas;
+	p[2].value.a = stats.max_allocated;
+	p[2].value.b = stats.max_arenas_in_use;
+	p[3].value.a = stats.num_waits;
+	p[3].value.b = 0;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result get_mutex_stats(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct mutex_stats stats;
+	uint64_t top[MUTEX_STATS_NUM_TOP * 2];
+	size_t n;
+
+	/*
+	 * p[0].value.a = 0 if no reset of the stats
+	 * p[1].value.a = number of lock attempts finding the mutex locked
+	 * p[1].value.b = number of those which got the mutex by spinning
+	 * p[2].value.a = number of sleeps in normal world waiting for a mutex
+	 * p[2].value.b = number of entries in p[3]
+	 * p[3].memref.buffer = output buffer with pairs of uint64_t, the
+	 *   core virtual address of a mutex and the number of sleeps waiting
+	 *   for it, for the mutexes causing the most sleeps. Unused entries
+	 *   are zero.
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_MEMREF_OUTPUT) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (p[3].memref.size < sizeof(top)) {
+		p[3].memref.size = sizeof(top);
+		return TEE_ERROR_SHORT_BUFFER;
+	}
+
+	mutex_get_stats(&stats, p[0].value.a);
+	p[1].value.a = stats.contended;
+	p[1].value.b = stats.spun;
+	p[2].value.a = stats.sleeps;
+	p[2].value.b = MUTEX_STATS_NUM_TOP;
+
+	for (n = 0; n < MUTEX_STATS_NUM_TOP; n++) {
+		top[n * 2] = stats.top[n].va;
+		top[n * 2 + 1] = stats.top[n].sleeps;
+	}
+	/* The buffer isn't necessarily 64-bit aligned */
+	memcpy(p[3].memref.buffer, top, sizeof(top));
+	p[3].memref.size = sizeof(top);
+
+	return TEE_SUCCESS;
+}
+
+/*
+ * Also served by fast_invoke_command() when the time source is CNTPCT, as
+ * that one doesn't block or do RPC.
+ */
+static TEE_Result get_sys_time(TEE_Param p[TEE_NUM_PARAMS])
+{
+	TEE_Result res;
+	TEE_Time t;
+
+	/*
+	 * p[0].value.a = seconds of the TEE system time
+	 * p[0].value.b = milliseconds of the TEE system time
+	 */
+	res = tee_time_get_sys_time(&t);
+	if (res)
+		return res;
+
+	p[0].value.a = t.seconds;
+	p[0].value.b = t.millis;
+
+	return TEE_SUCCESS;
+}
+
 /*
  * Trusted Application Entry Points
  */
@@ -152,12 +286,48 @@ static TEE_Result invoke_command(void *psess __unused,
 		return get_alloc_stats(ptypes, params);
 	case STATS_CMD_MEMLEAK_STATS:
 		return get_memleak_stats(ptypes, params);
+	case STATS_CMD_PGT_CACHE_STATS:
+		return get_pgt_cache_stats(ptypes, params);
+	case STATS_CMD_BIGNUM_POOL_STATS:
+		return get_bignum_pool_stats(ptypes, params);
+	case STATS_CMD_GET_SYS_TIME:
+		if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_OUTPUT,
+				    TEE_PARAM_TYPE_NONE,
+				    TEE_PARAM_TYPE_NONE,
+				    TEE_PARAM_TYPE_NONE) != ptypes)
+			return TEE_ERROR_BAD_PARAMETERS;
+		return get_sys_time(params);
+	case STATS_CMD_MUTEX_STATS:
+		return get_mutex_stats(ptypes, params);
 	default:
 		break;
 	}
 	return TEE_ERROR_BAD_PARAMETERS;
 }
 
+#ifdef CFG_SECURE_TIME_SOURCE_CNTPCT
+static TEE_Result fast_invoke_command(uint32_t cmd, uint32_t ptypes,
+				      TEE_Param params[TEE_NUM_PARAMS])
+{
+	switch (cmd) {
+	case STATS_CMD_GET_SYS_TIME:
+		if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INOUT,
+				    TEE_PARAM_TYPE_VALUE_INOUT,
+				    TEE_PARAM_TYPE_NONE,
+				    TEE_PARAM_TYPE_NONE) != ptypes)
+			return TEE_ERROR_BAD_PARAMETERS;
+		return get_sys_time(params);
+	default:
+		return TEE_ERROR_NOT_SUPPORTED;
+	}
+}
+#define STATS_FAST_INVOKE	fast_invoke_command
+#else
+/* Other time sources may block or do RPC, not allowed in a fast call */
+#define STATS_FAST_INVOKE	NULL
+#endif
+
 pseudo_ta_register(.uuid = STATS_UUID, .name = TA_NAME,
 		   .flags = PTA_DEFAULT_FLAGS,
-		   .invoke_command_entry_point = invoke_command);
+		   .invoke_command_entry_point = invoke_command,
+		   .fast_invoke_command_entry_point = STATS_FAST_INVOKE);
@@ -3,11 +3,25 @@ srcs-y += pta_invoke_tests.c
 srcs-y += core_self_tests.c
 srcs-y += interrupt_tests.c
 srcs-y += core_mutex_tests.c
+srcs-y += core_aes_gcm_tests.c
+srcs-y += core_rsa_tests.c
+srcs-y += core_handle_tests.c
+srcs-y += core_msg_param_tests.c
+ifneq ($(CFG_CORE_MBEDTLS_MPI),y)
+srcs-y += core_mpa_tests.c
+endif
 srcs-$(CFG_WITH_USER_TA) += core_fs_htree_tests.c
+ifeq ($(CFG_WITH_USER_TA),y)
+srcs-$(CFG_TA_IMAGE_CACHE) += core_ta_image_cache_tests.c
+endif
 srcs-$(CFG_LOCKDEP) += core_lockdep_tests.c
+ifeq ($(CFG_SYSTEM_PTA),y)
+srcs-$(CFG_CORE_ASYNC_NOTIF) += core_notif_tests.c
+endif
 endif
 ifeq ($(CFG_WITH_USER_TA),y)
 srcs-$(CFG_SECSTOR_TA_MGMT_PTA) += secstor_ta_mgmt.c
+srcs-$(CFG_TA_IMAGE_CACHE) += ta_preload.c
 endif
 srcs-$(CFG_WITH_STATS) += stats.c
 srcs-$(CFG_TA_GPROF_SUPPORT) += gprof.c
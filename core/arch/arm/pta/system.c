@@ -3,13 +3,22 @@
  * Copyright (c) 2018, Linaro Limited
  */
 #include <kernel/msg_param.h>
+#include <kernel/notif.h>
 #include <kernel/pseudo_ta.h>
 #include <kernel/user_ta.h>
 #include <pta_system.h>
 #include <crypto/crypto.h>
+#include <stdlib.h>
 #include <util.h>
 
 #define MAX_ENTROPY_IN			32u
+/* Keeps a single session from allocating all the notification values */
+#define MAX_NOTIF_VALUES		4
+
+struct system_ctx {
+	/* Notification values allocated by the session */
+	uint64_t notif_values;
+};
 
 static unsigned int system_pnum;
 
@@ -40,23 +49,105 @@ static TEE_Result system_rng_reseed(struct tee_ta_session *s __unused,
 	return TEE_SUCCESS;
 }
 
+#ifdef CFG_CORE_ASYNC_NOTIF
+static TEE_Result system_notif(struct system_ctx *ctx, uint32_t cmd_id,
+			       uint32_t param_types,
+			       TEE_Param params[TEE_NUM_PARAMS])
+{
+	uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE);
+	uint32_t value = 0;
+	TEE_Result res;
+
+	if (cmd_id == PTA_SYSTEM_NOTIF_ALLOC) {
+		exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_OUTPUT,
+					 TEE_PARAM_TYPE_NONE,
+					 TEE_PARAM_TYPE_NONE,
+					 TEE_PARAM_TYPE_NONE);
+		if (exp_pt != param_types)
+			return TEE_ERROR_BAD_PARAMETERS;
+
+		if (__builtin_popcountll(ctx->notif_values) >=
+		    MAX_NOTIF_VALUES)
+			return TEE_ERROR_OUT_OF_MEMORY;
+		res = notif_alloc_async_value(&value);
+		if (res)
+			return res;
+		ctx->notif_values |= BIT64(value);
+		params[0].value.a = value;
+		params[0].value.b = 0;
+		return TEE_SUCCESS;
+	}
+
+	if (exp_pt != param_types)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	/* Only values allocated by this session can be used */
+	value = params[0].value.a;
+	if (value > NOTIF_ASYNC_VALUE_MAX ||
+	    !(ctx->notif_values & BIT64(value)))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (cmd_id == PTA_SYSTEM_NOTIF_FREE) {
+		ctx->notif_values &= ~BIT64(value);
+		notif_free_async_value(value);
+	} else {
+		notif_send_async(value);
+	}
+
+	return TEE_SUCCESS;
+}
+#else
+static TEE_Result system_notif(struct system_ctx *ctx __unused,
+			       uint32_t cmd_id __unused,
+			       uint32_t param_types __unused,
+			       TEE_Param params[TEE_NUM_PARAMS] __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
 static TEE_Result open_session(uint32_t param_types __unused,
 			       TEE_Param params[TEE_NUM_PARAMS] __unused,
-			       void **sess_ctx __unused)
+			       void **sess_ctx)
 {
 	struct tee_ta_session *s;
+	struct system_ctx *ctx;
 
-	/* Check that we're called from a user TA */
+	/*
+	 * Check that we're called from a TA and not from normal world,
+	 * pseudo TAs like the core self tests are accepted too.
+	 */
 	s = tee_ta_get_calling_session();
 	if (!s)
 		return TEE_ERROR_ACCESS_DENIED;
-	if (!is_user_ta_ctx(s->ctx))
-		return TEE_ERROR_ACCESS_DENIED;
 
+	ctx = calloc(1, sizeof(*ctx));
+	if (!ctx)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	*sess_ctx = ctx;
 	return TEE_SUCCESS;
 }
 
-static TEE_Result invoke_command(void *sess_ctx __unused, uint32_t cmd_id,
+static void close_session(void *sess_ctx)
+{
+	struct system_ctx *ctx = sess_ctx;
+
+#ifdef CFG_CORE_ASYNC_NOTIF
+	while (ctx->notif_values) {
+		uint32_t value = __builtin_ctzll(ctx->notif_values);
+
+		ctx->notif_values &= ~BIT64(value);
+		notif_free_async_value(value);
+	}
+#endif
+	free(ctx);
+}
+
+static TEE_Result invoke_command(void *sess_ctx, uint32_t cmd_id,
 				 uint32_t param_types,
 				 TEE_Param params[TEE_NUM_PARAMS])
 {
@@ -65,6 +156,10 @@ static TEE_Result invoke_command(void *sess_ctx __unused, uint32_t cmd_id,
 	switch (cmd_id) {
 	case PTA_SYSTEM_ADD_RNG_ENTROPY:
 		return system_rng_reseed(s, param_types, params);
+	case PTA_SYSTEM_NOTIF_ALLOC:
+	case PTA_SYSTEM_NOTIF_FREE:
+	case PTA_SYSTEM_NOTIF_SEND:
+		return system_notif(sess_ctx, cmd_id, param_types, params);
 	default:
 		break;
 	}
@@ -75,4 +170,5 @@ static TEE_Result invoke_command(void *sess_ctx __unused, uint32_t cmd_id,
 pseudo_ta_register(.uuid = PTA_SYSTEM_UUID, .name = "system.pta",
 		   .flags = PTA_DEFAULT_FLAGS,
 		   .open_session_entry_point = open_session,
+		   .close_session_entry_point = close_session,
 		   .invoke_command_entry_point = invoke_command);
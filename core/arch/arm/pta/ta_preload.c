@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2019, Linaro Limited
+ */
+
+#include <initcall.h>
+#include <kernel/generic_boot.h>
+#include <kernel/pseudo_ta.h>
+#include <kernel/user_ta.h>
+#include <pta_ta_preload.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tee_api_defines_extensions.h>
+#include <tee/uuid.h>
+#include <trace.h>
+
+#ifdef CFG_DT
+#include <libfdt.h>
+#endif
+
+#define PTA_NAME "ta_preload.pta"
+
+#define DT_TA_PRELOAD_COMPAT	"linaro,optee-ta-preload"
+
+/* TAs listed in the secure device tree, in octet format */
+static uint8_t *dt_uuids;
+static size_t dt_uuids_size;
+
+static TEE_Result preload_uuids(uint32_t cmd_id, const uint8_t *uuids,
+				size_t size)
+{
+	TEE_Result res = TEE_SUCCESS;
+	TEE_UUID uuid;
+	size_t n;
+
+	if (size % sizeof(TEE_UUID))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	for (n = 0; n < size; n += sizeof(TEE_UUID)) {
+		tee_uuid_from_octets(&uuid, uuids + n);
+		if (cmd_id == PTA_TA_PRELOAD_CMD_PRELOAD) {
+			res = ta_image_cache_preload(&uuid);
+			if (res) {
+				EMSG("Failed to preload %pUl: %#" PRIx32,
+				     (void *)&uuid, res);
+				return res;
+			}
+			DMSG("Preloaded %pUl", (void *)&uuid);
+		} else {
+			/* Not preloaded or already evicted is fine */
+			ta_image_cache_release(&uuid);
+		}
+	}
+
+	return res;
+}
+
+/*
+ * Pinned images use a part of the TA image cache shared by everyone, so
+ * only TAs and clients in the REE kernel may preload TAs
+ */
+static TEE_Result open_session(uint32_t param_types __unused,
+			       TEE_Param params[TEE_NUM_PARAMS] __unused,
+			       void **sess_ctx __unused)
+{
+	struct tee_ta_session *s = NULL;
+
+	if (tee_ta_get_calling_session())
+		return TEE_SUCCESS;
+
+	if (tee_ta_get_current_session(&s) ||
+	    s->clnt_id.login != TEE_LOGIN_REE_KERNEL)
+		return TEE_ERROR_ACCESS_DENIED;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result invoke_command(void *psess __unused, uint32_t cmd_id,
+				 uint32_t ptypes,
+				 TEE_Param params[TEE_NUM_PARAMS])
+{
+	const uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_MEMREF_INPUT,
+						TEE_PARAM_TYPE_NONE,
+						TEE_PARAM_TYPE_NONE,
+						TEE_PARAM_TYPE_NONE);
+
+	if (cmd_id != PTA_TA_PRELOAD_CMD_PRELOAD &&
+	    cmd_id != PTA_TA_PRELOAD_CMD_RELEASE)
+		return TEE_ERROR_NOT_IMPLEMENTED;
+
+	if (!ptypes)
+		return preload_uuids(cmd_id, dt_uuids, dt_uuids_size);
+
+	if (ptypes != exp_pt)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	return preload_uuids(cmd_id, params[0].memref.buffer,
+			     params[0].memref.size);
+}
+
+pseudo_ta_register(.uuid = PTA_TA_PRELOAD_UUID, .name = PTA_NAME,
+		   .flags = PTA_DEFAULT_FLAGS,
+		   .open_session_entry_point = open_session,
+		   .invoke_command_entry_point = invoke_command);
+
+#ifdef CFG_DT
+/*
+ * The TAs to preload are listed in the secure device tree, for example:
+ *
+ * ta-preload {
+ *	compatible = "linaro,optee-ta-preload";
+ *	ta-uuids = [ 8a ad ec 4a 2f 4e 11 e8 ba 23 c7 5d 7f 7d 8c 55 ];
+ * };
+ *
+ * They can't be loaded from here since tee-supplicant isn't available
+ * yet, the REE kernel invokes PTA_TA_PRELOAD_CMD_PRELOAD once it is.
+ */
+static TEE_Result ta_preload_dt_init(void)
+{
+	void *fdt = get_embedded_dt();
+	const void *prop;
+	int offs;
+	int len;
+
+	if (!fdt)
+		return TEE_SUCCESS;
+
+	offs = fdt_node_offset_by_compatible(fdt, -1, DT_TA_PRELOAD_COMPAT);
+	if (offs < 0)
+		return TEE_SUCCESS;
+
+	prop = fdt_getprop(fdt, offs, "ta-uuids", &len);
+	if (!prop || len <= 0 || len % sizeof(TEE_UUID)) {
+		EMSG("Invalid ta-uuids property in %s", DT_TA_PRELOAD_COMPAT);
+		return TEE_SUCCESS;
+	}
+
+	dt_uuids = malloc(len);
+	if (!dt_uuids)
+		return TEE_ERROR_OUT_OF_MEMORY;
+	memcpy(dt_uuids, prop, len);
+	dt_uuids_size = len;
+
+	return TEE_SUCCESS;
+}
+service_init(ta_preload_dt_init);
+#endif /*CFG_DT*/
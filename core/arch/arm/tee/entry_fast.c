@@ -11,6 +11,8 @@
 #include <kernel/tee_l2cc_mutex.h>
 #include <kernel/virtualization.h>
 #include <kernel/misc.h>
+#include <kernel/notif.h>
+#include <kernel/pseudo_ta.h>
 #include <mm/core_mmu.h>
 
 static void tee_entry_get_shm_config(struct thread_smc_args *args)
@@ -82,7 +84,10 @@ static void tee_entry_exchange_capabilities(struct thread_smc_args *args)
 	}
 
 	args->a0 = OPTEE_SMC_RETURN_OK;
-	args->a1 = OPTEE_SMC_SEC_CAP_HAVE_RESERVED_SHM;
+	args->a1 = OPTEE_SMC_SEC_CAP_HAVE_RESERVED_SHM |
+		   OPTEE_SMC_SEC_CAP_INVOKE_BATCH |
+		   OPTEE_SMC_SEC_CAP_PTA_FAST_CALL |
+		   OPTEE_SMC_SEC_CAP_NONCONTIG_RUNS;
 
 #if defined(CFG_DYN_SHM_CAP)
 	dyn_shm_en = core_mmu_nsec_ddr_is_defined();
@@ -91,6 +96,11 @@ static void tee_entry_exchange_capabilities(struct thread_smc_args *args)
 #endif
 
 	IMSG("Dynamic shared memory is %sabled", dyn_shm_en ? "en" : "dis");
+
+#if defined(CFG_CORE_ASYNC_NOTIF)
+	args->a1 |= OPTEE_SMC_SEC_CAP_ASYNC_NOTIF;
+	args->a2 = NOTIF_ASYNC_VALUE_MAX;
+#endif
 }
 
 static void tee_entry_disable_shm_cache(struct thread_smc_args *args)
@@ -132,6 +142,72 @@ static void tee_entry_boot_secondary(struct thread_smc_args *args)
 #endif
 }
 
+static void tee_entry_get_pta_fast_handle(struct thread_smc_args *args)
+{
+	TEE_UUID uuid;
+	uint32_t handle = 0;
+	size_t n;
+
+	uuid.timeLow = args->a1;
+	uuid.timeMid = args->a2 >> 16;
+	uuid.timeHiAndVersion = args->a2;
+	for (n = 0; n < 4; n++) {
+		uuid.clockSeqAndNode[n] = args->a3 >> (24 - n * 8);
+		uuid.clockSeqAndNode[n + 4] = args->a4 >> (24 - n * 8);
+	}
+
+	if (pseudo_ta_get_fast_handle(&uuid, &handle)) {
+		args->a0 = OPTEE_SMC_RETURN_ENOTAVAIL;
+		return;
+	}
+
+	args->a0 = OPTEE_SMC_RETURN_OK;
+	args->a1 = handle;
+}
+
+static void tee_entry_call_pta_fast(struct thread_smc_args *args)
+{
+	TEE_Param params[TEE_NUM_PARAMS] = { 0 };
+	TEE_Result res;
+
+	params[0].value.a = args->a3;
+	params[0].value.b = args->a4;
+	params[1].value.a = args->a5;
+	params[1].value.b = args->a6;
+
+	res = pseudo_ta_fast_invoke(args->a1, args->a2, params);
+
+	args->a0 = OPTEE_SMC_RETURN_OK;
+	args->a1 = res;
+	args->a2 = params[0].value.a;
+	args->a3 = params[0].value.b;
+	args->a4 = params[1].value.a;
+	args->a5 = params[1].value.b;
+}
+
+#if defined(CFG_CORE_ASYNC_NOTIF)
+static void tee_entry_get_async_notif_value(struct thread_smc_args *args)
+{
+	uint32_t value = 0;
+	bool pending = false;
+
+	args->a0 = OPTEE_SMC_RETURN_OK;
+	args->a2 = 0;
+	if (notif_get_value(&value, &pending)) {
+		args->a1 = value;
+		args->a2 |= OPTEE_SMC_ASYNC_NOTIF_VALID;
+	}
+	if (pending)
+		args->a2 |= OPTEE_SMC_ASYNC_NOTIF_PENDING;
+}
+
+static void tee_entry_enable_async_notif(struct thread_smc_args *args)
+{
+	notif_enable_async();
+	args->a0 = OPTEE_SMC_RETURN_OK;
+}
+#endif
+
 #if defined(CFG_VIRTUALIZATION)
 static void tee_entry_vm_created(struct thread_smc_args *args)
 {
@@ -200,6 +276,21 @@ void tee_entry_fast(struct thread_smc_args *args)
 	case OPTEE_SMC_BOOT_SECONDARY:
 		tee_entry_boot_secondary(args);
 		break;
+	case OPTEE_SMC_GET_PTA_FAST_HANDLE:
+		tee_entry_get_pta_fast_handle(args);
+		break;
+	case OPTEE_SMC_CALL_PTA_FAST:
+		tee_entry_call_pta_fast(args);
+		break;
+
+#if defined(CFG_CORE_ASYNC_NOTIF)
+	case OPTEE_SMC_GET_ASYNC_NOTIF_VALUE:
+		tee_entry_get_async_notif_value(args);
+		break;
+	case OPTEE_SMC_ENABLE_ASYNC_NOTIF:
+		tee_entry_enable_async_notif(args);
+		break;
+#endif
 
 #if defined(CFG_VIRTUALIZATION)
 	case OPTEE_SMC_VM_CREATED:
@@ -223,8 +314,11 @@ size_t tee_entry_generic_get_api_call_count(void)
 	 * target has additional calls it will call this function and
 	 * add the number of calls the target has added.
 	 */
-	size_t ret = 11;
+	size_t ret = 13;
 
+#if defined(CFG_CORE_ASYNC_NOTIF)
+	ret += 2;
+#endif
 #if defined(CFG_VIRTUALIZATION)
 	ret += 2;
 #endif
@@ -18,7 +18,9 @@
 #include <mm/mobj.h>
 #include <optee_msg.h>
 #include <sm/optee_smc.h>
+#include <stdlib.h>
 #include <string.h>
+#include <tee_api_defines_extensions.h>
 #include <tee/entry_std.h>
 #include <tee/tee_cryp_utl.h>
 #include <tee/uuid.h>
@@ -270,6 +272,7 @@ static TEE_Result get_open_session_meta(size_t num_params,
 	clnt_id->login = params[1].u.value.c;
 	switch (clnt_id->login) {
 	case TEE_LOGIN_PUBLIC:
+	case TEE_LOGIN_REE_KERNEL:
 		memset(&clnt_id->uuid, 0, sizeof(clnt_id->uuid));
 		break;
 	case TEE_LOGIN_USER:
@@ -398,6 +401,81 @@ out:
 	smc_args->a0 = OPTEE_SMC_RETURN_OK;
 }
 
+static void invoke_batch_entry(struct tee_ta_session *s, uint32_t func,
+			       struct optee_msg_param *params,
+			       uint32_t num_params)
+{
+	TEE_Result res;
+	TEE_ErrorOrigin err_orig = TEE_ORIGIN_TEE;
+	struct tee_ta_param param = { 0 };
+	uint64_t saved_attr[TEE_NUM_PARAMS] = { 0 };
+
+	res = copy_in_params(params + 1, num_params, &param, saved_attr);
+	if (res == TEE_SUCCESS) {
+		res = tee_ta_invoke_command(&err_orig, s, NSAPP_IDENTITY,
+					    TEE_TIMEOUT_INFINITE, func, &param);
+		copy_out_param(&param, num_params, params + 1, saved_attr);
+	}
+
+	cleanup_shm_refs(saved_attr, &param, num_params);
+
+	params->u.value.c = (uint64_t)err_orig << 32 | res;
+}
+
+/*
+ * Invokes the commands of a batch back to back, the session is looked up
+ * only once and the thread is kept for the entire batch.
+ */
+static void entry_invoke_batch(struct thread_smc_args *smc_args,
+			       struct optee_msg_arg *arg, uint32_t num_params)
+{
+	TEE_Result res = TEE_SUCCESS;
+	struct msg_param_batch_entry *entries = NULL;
+	struct tee_ta_session *s;
+	size_t num_entries = 0;
+	size_t n = 0;
+
+	bm_timestamp();
+
+	entries = calloc(num_params, sizeof(*entries));
+	if (!entries) {
+		res = num_params ? TEE_ERROR_OUT_OF_MEMORY :
+				   TEE_ERROR_BAD_PARAMETERS;
+		goto out;
+	}
+
+	/*
+	 * The entire batch is checked before invoking anything. The
+	 * commands are invoked from the entries read here, normal world
+	 * may change the parameters in the meantime.
+	 */
+	res = msg_param_get_batch(arg->params, num_params, entries,
+				  &num_entries);
+	if (res != TEE_SUCCESS)
+		goto out;
+
+	s = tee_ta_get_session(arg->session, true, &tee_open_sessions);
+	if (!s) {
+		res = TEE_ERROR_BAD_PARAMETERS;
+		goto out;
+	}
+
+	for (n = 0; n < num_entries; n++)
+		invoke_batch_entry(s, entries[n].func,
+				   arg->params + entries[n].idx,
+				   entries[n].num_params);
+
+	bm_timestamp();
+
+	tee_ta_put_session(s);
+
+out:
+	free(entries);
+	arg->ret = res;
+	arg->ret_origin = TEE_ORIGIN_TEE;
+	smc_args->a0 = OPTEE_SMC_RETURN_OK;
+}
+
 static void entry_cancel(struct thread_smc_args *smc_args,
 			struct optee_msg_arg *arg, uint32_t num_params)
 {
@@ -569,6 +647,9 @@ void __weak tee_entry_std(struct thread_smc_args *smc_args)
 	case OPTEE_MSG_CMD_INVOKE_COMMAND:
 		entry_invoke_command(smc_args, arg, num_params);
 		break;
+	case OPTEE_MSG_CMD_INVOKE_BATCH:
+		entry_invoke_batch(smc_args, arg, num_params);
+		break;
 	case OPTEE_MSG_CMD_CANCEL:
 		entry_cancel(smc_args, arg, num_params);
 		break;
@@ -66,20 +66,22 @@ static void ghash_update_lengths(struct internal_aes_gcm_state *state,
 	internal_aes_gcm_ghash_update(state, (uint8_t *)len_fields, NULL, 0);
 }
 
-static TEE_Result __gcm_init(struct internal_aes_gcm_state *state,
-			     const struct internal_aes_gcm_key *ek,
-			     TEE_OperationMode mode, const void *nonce,
-			     size_t nonce_len, size_t tag_len)
+/*
+ * Initializes the message specific part of @state, the key specific part
+ * is expected to be initialized by internal_aes_gcm_set_key() while
+ * everything else must be zero.
+ */
+static TEE_Result __gcm_init_nonce(struct internal_aes_gcm_state *state,
+				   const struct internal_aes_gcm_key *ek,
+				   TEE_OperationMode mode, const void *nonce,
+				   size_t nonce_len, size_t tag_len)
 {
 	COMPILE_TIME_ASSERT(sizeof(state->ctr) == TEE_AES_BLOCK_SIZE);
 
 	if (tag_len > sizeof(state->buf_tag))
 		return TEE_ERROR_BAD_PARAMETERS;
 
-	memset(state, 0, sizeof(*state));
-
 	state->tag_len = tag_len;
-	internal_aes_gcm_set_key(state, ek);
 
 	if (nonce_len == (96 / 8)) {
 		memcpy(state->ctr, nonce, nonce_len);
@@ -119,6 +121,17 @@ static TEE_Result __gcm_init(struct internal_aes_gcm_state *state,
 	return TEE_SUCCESS;
 }
 
+static TEE_Result __gcm_init(struct internal_aes_gcm_state *state,
+			     const struct internal_aes_gcm_key *ek,
+			     TEE_OperationMode mode, const void *nonce,
+			     size_t nonce_len, size_t tag_len)
+{
+	memset(state, 0, sizeof(*state));
+	internal_aes_gcm_set_key(state, ek);
+
+	return __gcm_init_nonce(state, ek, mode, nonce, nonce_len, tag_len);
+}
+
 TEE_Result internal_aes_gcm_init(struct internal_aes_gcm_ctx *ctx,
 				 TEE_OperationMode mode, const void *key,
 				 size_t key_len, const void *nonce,
@@ -133,6 +146,32 @@ TEE_Result internal_aes_gcm_init(struct internal_aes_gcm_ctx *ctx,
 			  tag_len);
 }
 
+TEE_Result internal_aes_gcm_init_key(struct internal_aes_gcm_ctx *ctx,
+				     const void *key, size_t key_len)
+{
+	TEE_Result res = internal_aes_gcm_expand_enc_key(key, key_len,
+							 &ctx->key);
+	if (res)
+		return res;
+
+	memset(&ctx->state, 0, sizeof(ctx->state));
+	internal_aes_gcm_set_key(&ctx->state, &ctx->key);
+
+	return TEE_SUCCESS;
+}
+
+TEE_Result internal_aes_gcm_init_from_key(struct internal_aes_gcm_ctx *ctx,
+					  const struct internal_aes_gcm_ctx *kctx,
+					  TEE_OperationMode mode,
+					  const void *nonce, size_t nonce_len,
+					  size_t tag_len)
+{
+	memcpy(ctx, kctx, sizeof(*ctx));
+
+	return __gcm_init_nonce(&ctx->state, &ctx->key, mode, nonce,
+				nonce_len, tag_len);
+}
+
 static TEE_Result __gcm_update_aad(struct internal_aes_gcm_state *state,
 				   const void *data, size_t len)
 {
@@ -418,6 +457,9 @@ TEE_Result crypto_aes_gcm_alloc_ctx(void **ctx_ret)
 
 void crypto_aes_gcm_free_ctx(void *ctx)
 {
+	/* The context holds the expanded key */
+	if (ctx)
+		memzero_explicit(ctx, sizeof(struct internal_aes_gcm_ctx));
 	free(ctx);
 }
 
@@ -435,6 +477,21 @@ TEE_Result crypto_aes_gcm_init(void *c, TEE_OperationMode mode,
 				     tag_len);
 }
 
+TEE_Result crypto_aes_gcm_init_key_ctx(void *key_ctx, const uint8_t *key,
+				       size_t key_len)
+{
+	return internal_aes_gcm_init_key(key_ctx, key, key_len);
+}
+
+TEE_Result crypto_aes_gcm_init_from_key_ctx(void *c, TEE_OperationMode mode,
+					    const void *key_ctx,
+					    const uint8_t *nonce,
+					    size_t nonce_len, size_t tag_len)
+{
+	return internal_aes_gcm_init_from_key(c, key_ctx, mode, nonce,
+					      nonce_len, tag_len);
+}
+
 TEE_Result crypto_aes_gcm_update_aad(void *c, const uint8_t *data, size_t len)
 {
 	return internal_aes_gcm_update_aad(c, data, len);
@@ -9,6 +9,7 @@
 #include <crypto/aes-gcm.h>
 #include <crypto/crypto.h>
 #include <kernel/panic.h>
+#include <mempool.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -94,6 +95,24 @@ TEE_Result crypto_cipher_get_block_size(uint32_t algo __unused,
 {
 	return TEE_ERROR_NOT_IMPLEMENTED;
 }
+
+TEE_Result crypto_cipher_init_key_ctx(void *key_ctx __unused,
+				      uint32_t algo __unused,
+				      const uint8_t *key __unused,
+				      size_t key_len __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+
+TEE_Result crypto_cipher_init_from_key_ctx(void *ctx __unused,
+					   uint32_t algo __unused,
+					   TEE_OperationMode mode __unused,
+					   const void *key_ctx __unused,
+					   const uint8_t *iv __unused,
+					   size_t iv_len __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
 #endif /*_CFG_CRYPTO_WITH_CIPHER*/
 
 #if !defined(_CFG_CRYPTO_WITH_MAC)
@@ -215,6 +234,43 @@ TEE_Result crypto_authenc_init(void *ctx __maybe_unused,
 	}
 }
 
+TEE_Result crypto_authenc_init_key_ctx(void *key_ctx __maybe_unused,
+				       uint32_t algo,
+				       const uint8_t *key __maybe_unused,
+				       size_t key_len __maybe_unused)
+{
+	switch (algo) {
+#if defined(CFG_CRYPTO_GCM)
+	case TEE_ALG_AES_GCM:
+		return crypto_aes_gcm_init_key_ctx(key_ctx, key, key_len);
+#endif
+	default:
+		return TEE_ERROR_NOT_SUPPORTED;
+	}
+}
+
+TEE_Result crypto_authenc_init_from_key_ctx(void *ctx __maybe_unused,
+					    uint32_t algo,
+					    TEE_OperationMode mode __maybe_unused,
+					    const void *key_ctx __maybe_unused,
+					    const uint8_t *nonce __maybe_unused,
+					    size_t nonce_len __maybe_unused,
+					    size_t tag_len __maybe_unused,
+					    size_t aad_len __unused,
+					    size_t payload_len __unused)
+{
+	switch (algo) {
+#if defined(CFG_CRYPTO_GCM)
+	case TEE_ALG_AES_GCM:
+		return crypto_aes_gcm_init_from_key_ctx(ctx, mode, key_ctx,
+							nonce, nonce_len,
+							tag_len);
+#endif
+	default:
+		return TEE_ERROR_NOT_SUPPORTED;
+	}
+}
+
 TEE_Result crypto_authenc_update_aad(void *ctx __maybe_unused,
 				     uint32_t algo __maybe_unused,
 				     TEE_OperationMode mode __unused,
@@ -414,6 +470,12 @@ int32_t crypto_bignum_compare(struct bignum *a __unused,
 	bignum_cant_happen();
 	return -1;
 }
+
+void crypto_bignum_get_pool_stats(struct mempool_stats *stats,
+				  bool reset __unused)
+{
+	memset(stats, 0, sizeof(*stats));
+}
 #endif /*!_CFG_CRYPTO_WITH_ACIPHER*/
 
 #if !defined(CFG_CRYPTO_RSA) || !defined(_CFG_CRYPTO_WITH_ACIPHER)
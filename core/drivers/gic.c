@@ -306,8 +306,17 @@ static void gic_it_set_pending(struct gic_data *gd, size_t it)
 
 	/* Should be Peripheral Interrupt */
 	assert(it >= NUM_SGI);
+#ifdef CFG_CORE_ASYNC_NOTIF
+	/*
+	 * Assigned to group0, except the asynchronous notification
+	 * interrupt which is group1 and delivered to normal world
+	 */
+	assert(it == CFG_CORE_ASYNC_NOTIF_GIC_INTID ||
+	       !(io_read32(gd->gicd_base + GICD_IGROUPR(idx)) & mask));
+#else
 	/* Assigned to group0 */
 	assert(!(io_read32(gd->gicd_base + GICD_IGROUPR(idx)) & mask));
+#endif
 
 	/* Raise the interrupt */
 	io_write32(gd->gicd_base + GICD_ISPENDR(idx), mask);
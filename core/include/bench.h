@@ -6,6 +6,7 @@
 #ifndef BENCH_H
 #define BENCH_H
 
+#include <arm.h>
 #include <inttypes.h>
 #include <mm/core_memprot.h>
 #include <mm/core_mmu.h>
@@ -51,10 +52,39 @@ struct tee_ts_global {
 	struct tee_ts_cpu_buf cpu_buf[];
 };
 
+/* Phases of loading a user TA accounted by bm_ta_load_add() */
+enum bm_ta_load_phase {
+	BM_TA_LOAD_RPC,		/* Fetching the binary from normal world */
+	BM_TA_LOAD_VERIFY,	/* Verifying the signature of the header */
+	BM_TA_LOAD_HASH,	/* Copying and hashing the binary */
+	BM_TA_LOAD_RELOCATE,	/* Processing relocations */
+	BM_TA_LOAD_MAP,		/* Mapping segments and setting protection */
+	BM_TA_LOAD_TOTAL,	/* The entire load, counts loads too */
+	BM_TA_LOAD_NUM_PHASES
+};
+
 #ifdef CFG_TEE_BENCHMARK
 void bm_timestamp(void);
+
+static inline uint64_t bm_ta_load_start(void)
+{
+	return read_cntpct();
+}
+
+/* Adds the time elapsed since @start, from bm_ta_load_start(), to @phase */
+void bm_ta_load_add(enum bm_ta_load_phase phase, uint64_t start);
 #else
 static inline void bm_timestamp(void) {}
+
+static inline uint64_t bm_ta_load_start(void)
+{
+	return 0;
+}
+
+static inline void bm_ta_load_add(enum bm_ta_load_phase phase __unused,
+				  uint64_t start __unused)
+{
+}
 #endif /* CFG_TEE_BENCHMARK */
 
 #endif /* BENCH_H */
@@ -13,6 +13,12 @@ TEE_Result crypto_aes_gcm_init(void *ctx, TEE_OperationMode mode,
 			       const uint8_t *key, size_t key_len,
 			       const uint8_t *nonce, size_t nonce_len,
 			       size_t tag_len);
+TEE_Result crypto_aes_gcm_init_key_ctx(void *key_ctx, const uint8_t *key,
+				       size_t key_len);
+TEE_Result crypto_aes_gcm_init_from_key_ctx(void *ctx, TEE_OperationMode mode,
+					    const void *key_ctx,
+					    const uint8_t *nonce,
+					    size_t nonce_len, size_t tag_len);
 TEE_Result crypto_aes_gcm_update_aad(void *ctx, const uint8_t *data,
 				     size_t len);
 TEE_Result crypto_aes_gcm_update_payload(void *ctx, TEE_OperationMode mode,
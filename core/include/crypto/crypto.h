@@ -88,6 +88,35 @@ void crypto_authenc_final(void *ctx, uint32_t algo);
 void crypto_authenc_free_ctx(void *ctx, uint32_t algo);
 void crypto_authenc_copy_state(void *dst_ctx, void *src_ctx, uint32_t algo);
 
+/*
+ * Key contexts
+ *
+ * A key context is a context allocated for @algo which only holds an
+ * expanded key. crypto_*_init_key_ctx() runs the key schedule of @key into
+ * @key_ctx and crypto_*_init_from_key_ctx() initializes an operation in
+ * @ctx using @key_ctx instead of a raw key, avoiding running the key
+ * schedule again for each message. TEE_ERROR_NOT_SUPPORTED is returned
+ * for algorithms where this isn't available, the caller is then expected
+ * to use crypto_*_init() with the raw key instead.
+ *
+ * MACs don't need special functions, a context initialized with
+ * crypto_mac_init() can be duplicated using crypto_mac_copy_state().
+ */
+TEE_Result crypto_cipher_init_key_ctx(void *key_ctx, uint32_t algo,
+				      const uint8_t *key, size_t key_len);
+TEE_Result crypto_cipher_init_from_key_ctx(void *ctx, uint32_t algo,
+					   TEE_OperationMode mode,
+					   const void *key_ctx,
+					   const uint8_t *iv, size_t iv_len);
+TEE_Result crypto_authenc_init_key_ctx(void *key_ctx, uint32_t algo,
+				       const uint8_t *key, size_t key_len);
+TEE_Result crypto_authenc_init_from_key_ctx(void *ctx, uint32_t algo,
+					    TEE_OperationMode mode,
+					    const void *key_ctx,
+					    const uint8_t *nonce,
+					    size_t nonce_len, size_t tag_len,
+					    size_t aad_len, size_t payload_len);
+
 /* Implementation-defined big numbers */
 
 /*
@@ -107,6 +136,13 @@ void crypto_bignum_clear(struct bignum *a);
 /* return -1 if a<b, 0 if a==b, +1 if a>b */
 int32_t crypto_bignum_compare(struct bignum *a, struct bignum *b);
 
+/*
+ * Reports the usage of the scratch memory pool backing the bignums, the
+ * high-water marks are reset after being reported if @reset is true.
+ */
+struct mempool_stats;
+void crypto_bignum_get_pool_stats(struct mempool_stats *stats, bool reset);
+
 /* Asymmetric algorithms */
 
 struct rsa_keypair {
@@ -24,6 +24,10 @@ struct internal_aes_gcm_state {
 	uint64_t HH[16];
 #else
 	uint8_t hash_subkey[TEE_AES_BLOCK_SIZE];
+#if defined(ARM64) && defined(CFG_CRYPTO_WITH_CE)
+	/* H^2, H^3 and H^4 in the same format as hash_subkey */
+	uint64_t hash_subkey_pow[3][2];
+#endif
 #endif
 	uint8_t hash_state[TEE_AES_BLOCK_SIZE];
 
@@ -46,6 +50,19 @@ TEE_Result internal_aes_gcm_init(struct internal_aes_gcm_ctx *ctx,
 				 TEE_OperationMode mode, const void *key,
 				 size_t key_len, const void *nonce,
 				 size_t nonce_len, size_t tag_len);
+/*
+ * internal_aes_gcm_init_key() expands @key into @ctx without starting a
+ * message, internal_aes_gcm_init_from_key() starts a message in @ctx
+ * using the expanded key in @kctx, saving the key schedule and hash
+ * subkey computations when a key is used for many messages.
+ */
+TEE_Result internal_aes_gcm_init_key(struct internal_aes_gcm_ctx *ctx,
+				     const void *key, size_t key_len);
+TEE_Result internal_aes_gcm_init_from_key(struct internal_aes_gcm_ctx *ctx,
+					  const struct internal_aes_gcm_ctx *kctx,
+					  TEE_OperationMode mode,
+					  const void *nonce, size_t nonce_len,
+					  size_t tag_len);
 TEE_Result internal_aes_gcm_update_aad(struct internal_aes_gcm_ctx *ctx,
 				       const void *data, size_t len);
 TEE_Result internal_aes_gcm_update_payload(struct internal_aes_gcm_ctx *ctx,
@@ -5,14 +5,23 @@
 #ifndef KERNEL_HANDLE_H
 #define KERNEL_HANDLE_H
 
+#include <stddef.h>
 #include <stdint.h>
 
+struct handle_db_entry;
+
+/*
+ * The free entries are kept in a list threaded through the entries
+ * themselves, first_free is the index of the first free entry or equal
+ * to max_ptrs when there's no free entry.
+ */
 struct handle_db {
-	void **ptrs;
+	struct handle_db_entry *ents;
 	size_t max_ptrs;
+	size_t first_free;
 };
 
-#define HANDLE_DB_INITIALIZER { NULL, 0 }
+#define HANDLE_DB_INITIALIZER { NULL, 0, 0 }
 
 /*
  * Frees all internal data structures of the database, but does not free
@@ -27,6 +36,10 @@ void handle_db_destroy(struct handle_db *db);
  * The function returns
  * >= 0 on success and
  * -1 on failure
+ *
+ * Each entry has a generation counter which is part of the handle and
+ * increased each time the entry is released. A stale handle of a
+ * released entry is thus not valid even if the entry has been reused.
  */
 int handle_get(struct handle_db *db, void *ptr);
 
@@ -34,6 +34,7 @@
 #include <types_ext.h>
 #include <kernel/msg_param.h>
 #include <mm/mobj.h>
+#include <tee_api_types.h>
 
 /**
  * msg_param_mobj_from_noncontig() - construct mobj from non-contiguous
@@ -50,6 +51,38 @@
 struct mobj *msg_param_mobj_from_noncontig(paddr_t buf_ptr, size_t size,
 					   uint64_t shm_ref, bool map_buffer);
 
+/**
+ * struct msg_param_batch_entry - entry of an OPTEE_MSG_CMD_INVOKE_BATCH
+ *
+ * @idx - index of the meta parameter starting the entry
+ * @func - Trusted Application function
+ * @num_params - number of parameters following the meta parameter
+ */
+struct msg_param_batch_entry {
+	uint32_t idx;
+	uint32_t func;
+	uint32_t num_params;
+};
+
+/**
+ * msg_param_get_batch() - get the entries of an OPTEE_MSG_CMD_INVOKE_BATCH
+ *
+ * @params - parameters of the batch
+ * @num_params - number of parameters in @params
+ * @entries - returned entries, room for @num_params entries is needed
+ * @num_entries - returned number of entries in @entries
+ *
+ * Each meta parameter is read only once since @params is shared with
+ * normal world, the commands are to be invoked from @entries.
+ *
+ * return:
+ *	TEE_SUCCESS or TEE_ERROR_BAD_PARAMETERS if the batch is malformed
+ */
+TEE_Result msg_param_get_batch(const struct optee_msg_param *params,
+			       size_t num_params,
+			       struct msg_param_batch_entry *entries,
+			       size_t *num_entries);
+
 /**
  * msg_param_attr_is_tmem - helper functions that cheks if attribute is tmem
  *
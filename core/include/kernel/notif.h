@@ -0,0 +1,78 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2018, Linaro Limited
+ */
+
+#ifndef __KERNEL_NOTIF_H
+#define __KERNEL_NOTIF_H
+
+#include <compiler.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <tee_api_types.h>
+
+/*
+ * Asynchronous notifications from secure world to normal world
+ *
+ * A notification is a value in the range [0, NOTIF_ASYNC_VALUE_MAX]. Sent
+ * values are recorded as pending and an interrupt,
+ * CFG_CORE_ASYNC_NOTIF_GIC_INTID, is raised in normal world which
+ * retrieves the pending values with OPTEE_SMC_GET_ASYNC_NOTIF_VALUE. No
+ * thread is needed on either side to deliver a notification.
+ *
+ * Values below NOTIF_WQ_VALUE_COUNT wake up the wait queue key with the
+ * same value, as OPTEE_RPC_WAIT_QUEUE_WAKEUP does. The remaining values
+ * are allocated with notif_alloc_async_value() by the users of this
+ * interface.
+ */
+#define NOTIF_WQ_VALUE_COUNT	32
+#define NOTIF_ASYNC_VALUE_MAX	63
+
+#ifdef CFG_CORE_ASYNC_NOTIF
+/*
+ * notif_send_async() - send an asynchronous notification
+ * @value:	value to send
+ *
+ * Sending a value which is already pending has no further effect.
+ */
+void notif_send_async(uint32_t value);
+
+/*
+ * notif_wq_wakeup() - wake up a wait queue key without RPC
+ * @key:	wait queue key
+ *
+ * Returns true if normal world was notified, false if the wakeup has to
+ * be done with OPTEE_RPC_WAIT_QUEUE_WAKEUP since normal world hasn't
+ * enabled asynchronous notifications or @key is out of range.
+ */
+bool notif_wq_wakeup(uint32_t key);
+
+TEE_Result notif_alloc_async_value(uint32_t *value);
+
+/*
+ * notif_free_async_value() - free a value from notif_alloc_async_value()
+ * @value:	value to free
+ *
+ * The value is no longer pending once freed.
+ */
+void notif_free_async_value(uint32_t value);
+
+/*
+ * notif_get_value() - get and clear the lowest pending value
+ * @value:	returned value
+ * @pending:	true if more values are pending
+ *
+ * Returns false if no value was pending.
+ */
+bool notif_get_value(uint32_t *value, bool *pending);
+
+/* Called when normal world is ready to receive notifications */
+void notif_enable_async(void);
+#else
+static inline bool notif_wq_wakeup(uint32_t key __unused)
+{
+	return false;
+}
+#endif
+
+#endif /*__KERNEL_NOTIF_H*/
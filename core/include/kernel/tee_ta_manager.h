@@ -22,7 +22,7 @@
 #define NSAPP_IDENTITY	(NULL)
 
 TAILQ_HEAD(tee_ta_session_head, tee_ta_session);
-TAILQ_HEAD(tee_ta_ctx_head, tee_ta_ctx);
+LIST_HEAD(tee_ta_ctx_head, tee_ta_ctx);
 
 struct mobj;
 
@@ -35,6 +35,8 @@ struct param_mem {
 	struct mobj *mobj;
 	size_t size;
 	size_t offs;
+	/* Mapped read-only if the memref is passed to a user TA */
+	bool read_only;
 };
 
 struct tee_ta_param {
@@ -79,17 +81,20 @@ struct tee_ta_ctx {
 	TEE_UUID uuid;
 	const struct tee_ta_ops *ops;
 	uint32_t flags;		/* TA_FLAGS from TA header */
-	TAILQ_ENTRY(tee_ta_ctx) link;
+	LIST_ENTRY(tee_ta_ctx) link;
 	uint32_t panicked;	/* True if TA has panicked, written from asm */
 	uint32_t panic_code;	/* Code supplied for panic */
 	uint32_t ref_count;	/* Reference counter for multi session TA */
 	bool busy;		/* context is busy and cannot be entered */
+	struct mutex busy_mu;	/* Protects busy */
 	struct condvar busy_cv;	/* CV used when context is busy */
 };
 
 struct tee_ta_session {
 	TAILQ_ENTRY(tee_ta_session) link;
 	TAILQ_ENTRY(tee_ta_session) link_tsd;
+	LIST_ENTRY(tee_ta_session) hash_link;
+	struct tee_ta_session_head *open_sessions; /* List holding @link */
 	uint32_t id;		/* Session handle (0 is invalid) */
 	struct tee_ta_ctx *ctx;	/* TA context */
 	TEE_Identity clnt_id;	/* Identify of client */
@@ -107,11 +112,14 @@ struct tee_ta_session {
 #endif
 };
 
-/* Registered contexts */
-extern struct tee_ta_ctx_head tee_ctxes;
-
 extern struct mutex tee_ta_mutex;
 
+/*
+ * Makes a newly created context available to other sessions, called with
+ * tee_ta_mutex held.
+ */
+void tee_ta_register_ctx(struct tee_ta_ctx *ctx);
+
 TEE_Result tee_ta_open_session(TEE_ErrorOrigin *err,
 			       struct tee_ta_session **sess,
 			       struct tee_ta_session_head *open_sessions,
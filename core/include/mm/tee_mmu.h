@@ -30,6 +30,13 @@ TEE_Result vm_map(struct user_ta_ctx *utc, vaddr_t *va, size_t len,
 TEE_Result vm_set_prot(struct user_ta_ctx *utc, vaddr_t va, size_t len,
 		       uint32_t prot);
 
+/*
+ * Replaces the unpaged memory object backing a mapped region, @va and
+ * @len must match an already registered region exactly.
+ */
+TEE_Result vm_set_mobj(struct user_ta_ctx *utc, vaddr_t va, size_t len,
+		       struct mobj *mobj, size_t offs);
+
 /* Map stack of a user TA.  */
 TEE_Result tee_mmu_map_stack(struct user_ta_ctx *utc, struct mobj *mobj);
 
@@ -45,6 +52,18 @@ TEE_Result tee_mmu_map_add_segment(struct user_ta_ctx *utc, struct mobj *mobj,
 TEE_Result tee_mmu_map_param(struct user_ta_ctx *utc,
 		struct tee_ta_param *param, void *param_va[TEE_NUM_PARAMS]);
 
+/*
+ * Called when the invocation using the parameters mapped by
+ * tee_mmu_map_param() has ended and the context isn't active any longer.
+ */
+void tee_mmu_end_param(struct user_ta_ctx *utc);
+
+/*
+ * Drops the parameter mappings of @mobj kept from earlier invocations,
+ * called before registered shared memory is released.
+ */
+void tee_mmu_release_shm_param_maps(struct mobj *mobj);
+
 TEE_Result tee_mmu_add_rwmem(struct user_ta_ctx *utc, struct mobj *mobj,
 			     vaddr_t *va);
 void tee_mmu_rem_rwmem(struct user_ta_ctx *utc, struct mobj *mobj, vaddr_t va);
@@ -5,6 +5,7 @@
 #ifndef TEE_MMU_TYPES_H
 #define TEE_MMU_TYPES_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <sys/queue.h>
 #include <util.h>
@@ -77,6 +78,7 @@ struct vm_region {
 	vaddr_t va;
 	size_t size;
 	uint32_t attr; /* TEE_MATTR_* above */
+	bool mapped; /* Entries written to the translation tables */
 	TAILQ_ENTRY(vm_region) link;
 };
 
@@ -49,6 +49,12 @@
  * Every entry in buffer should point to a 4k page beginning (12 least
  * significant bits must be equal to zero).
  *
+ * If secure world reports OPTEE_SMC_SEC_CAP_NONCONTIG_RUNS the 12 least
+ * significant bits of an entry (OPTEE_MSG_NONCONTIG_RUN_MASK) may instead
+ * hold the number of physically contiguous 4k pages following the page
+ * the entry points to. A single entry can in this way describe up to 16MB
+ * of contiguous memory, for instance a 2MB block.
+ *
  * 12 least significant of optee_msg_param.u.tmem.buf_ptr should hold page
  * offset of user buffer.
  *
@@ -87,12 +93,20 @@
 #define OPTEE_MSG_LOGIN_APPLICATION		0x00000004
 #define OPTEE_MSG_LOGIN_APPLICATION_USER	0x00000005
 #define OPTEE_MSG_LOGIN_APPLICATION_GROUP	0x00000006
+/* Client in the REE kernel, cannot be claimed by user space clients */
+#define OPTEE_MSG_LOGIN_REE_KERNEL		0x80000000
 
 /*
  * Page size used in non-contiguous buffer entries
  */
 #define OPTEE_MSG_NONCONTIG_PAGE_SIZE		4096
 
+/*
+ * Bits of a non-contiguous buffer entry holding the number of following
+ * contiguous pages, see OPTEE_MSG_ATTR_NONCONTIG
+ */
+#define OPTEE_MSG_NONCONTIG_RUN_MASK		GENMASK_64(11, 0)
+
 #ifndef ASM
 /**
  * struct optee_msg_param_tmem - temporary memory reference parameter
@@ -299,6 +313,30 @@ struct optee_msg_arg {
  * [in] param[0].u.rmem.shm_ref		holds shared memory reference
  * [in] param[0].u.rmem.offs		0
  * [in] param[0].u.rmem.size		0
+ *
+ * OPTEE_MSG_CMD_INVOKE_BATCH invokes a sequence of commands in a
+ * previously opened session to a Trusted Application with a single call
+ * to secure world, only available if secure world reports
+ * OPTEE_SMC_SEC_CAP_INVOKE_BATCH. struct optee_msg_arg::func isn't used,
+ * instead the parameters are a sequence of entries, one per command, where
+ * each entry starts with a parameter tagged as meta:
+ * [in]  param[x].attr			OPTEE_MSG_ATTR_TYPE_VALUE_INOUT |
+ *					OPTEE_MSG_ATTR_META
+ * [in]  param[x].u.value.a		Trusted Application function
+ * [in]  param[x].u.value.b		number of parameters, n, passed to
+ *					the function, at most 4
+ * [out] param[x].u.value.c		return value of the function in
+ *					bits [31:0] and origin of the
+ *					return value in bits [63:32]
+ * followed by the n parameters param[x + 1] .. param[x + n] of the
+ * command, as with OPTEE_MSG_CMD_INVOKE_COMMAND. The next entry starts
+ * at param[x + n + 1].
+ *
+ * The commands are invoked in order regardless of the result of the
+ * previous command. struct optee_msg_arg::ret is TEE_SUCCESS if all the
+ * commands were invoked. All the entries are checked first, if the
+ * sequence of entries is malformed no command is invoked. Invalid
+ * parameters of a command are reported in its param[x].u.value.c.
  */
 #define OPTEE_MSG_CMD_OPEN_SESSION	0
 #define OPTEE_MSG_CMD_INVOKE_COMMAND	1
@@ -306,6 +344,7 @@ struct optee_msg_arg {
 #define OPTEE_MSG_CMD_CANCEL		3
 #define OPTEE_MSG_CMD_REGISTER_SHM	4
 #define OPTEE_MSG_CMD_UNREGISTER_SHM	5
+#define OPTEE_MSG_CMD_INVOKE_BATCH	6
 #define OPTEE_MSG_FUNCID_CALL_WITH_ARG	0x0004
 
 #endif /* _OPTEE_MSG_H */
@@ -13,6 +13,19 @@ TEE_Result tee_hash_get_digest_size(uint32_t algo, size_t *size);
 TEE_Result tee_hash_createdigest(uint32_t algo, const uint8_t *data,
 				 size_t datalen, uint8_t *digest,
 				 size_t digestlen);
+/*
+ * tee_hash_update_copy() - Copies data and hashes the copy
+ * @ctx:	hash context
+ * @algo:	hash algorithm
+ * @dst:	destination of the copy, hashed
+ * @src:	source of the copy, for instance in non-secure memory
+ * @len:	number of bytes to copy and hash
+ *
+ * The data is processed in chunks small enough to still be in the data
+ * cache when hashed, instead of making two passes over the whole buffer.
+ */
+TEE_Result tee_hash_update_copy(void *ctx, uint32_t algo, void *dst,
+				const void *src, size_t len);
 TEE_Result tee_mac_get_digest_size(uint32_t algo, size_t *size);
 TEE_Result tee_cipher_get_block_size(uint32_t algo, size_t *size);
 TEE_Result tee_do_cipher_update(void *ctx, uint32_t algo,
@@ -22,6 +22,8 @@ struct tee_obj {
 	struct tee_pobj *pobj;	/* ptr to persistant object */
 	struct tee_file_handle *fh;
 	uint32_t flags;		/* permission flags for persistent objects */
+	void *key_ctx;		/* cached expanded key, see tee_obj_key_ctx_get() */
+	uint32_t key_ctx_algo;	/* algorithm of key_ctx, 0 if not cached */
 };
 
 void tee_obj_add(struct user_ta_ctx *utc, struct tee_obj *o);
@@ -72,6 +72,9 @@ TEE_Result syscall_authenc_dec_final(unsigned long state,
 			const void *src_data, size_t src_len, void *dest_data,
 			uint64_t *dest_len, const void *tag, size_t tag_len);
 
+TEE_Result syscall_cryp_batch(struct utee_cryp_op *ops,
+			unsigned long num_ops);
+
 TEE_Result syscall_asymm_operate(unsigned long state,
 			const struct utee_attribute *usr_params,
 			size_t num_params, const void *src_data,
@@ -86,6 +89,7 @@ TEE_Result tee_obj_set_type(struct tee_obj *o, uint32_t obj_type,
 
 void tee_obj_attr_free(struct tee_obj *o);
 void tee_obj_attr_clear(struct tee_obj *o);
+void tee_obj_key_ctx_free(struct tee_obj *o);
 TEE_Result tee_obj_attr_to_binary(struct tee_obj *o, void *data,
 				  size_t *data_len);
 TEE_Result tee_obj_attr_from_binary(struct tee_obj *o, const void *data,
@@ -2,6 +2,7 @@
 /*
  * Copyright (c) 2014, Linaro Limited
  */
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 #include <kernel/handle.h>
@@ -14,66 +15,123 @@
  */
 #define HANDLE_DB_INITIAL_MAX_PTRS	4
 
+/*
+ * A handle is the index of the entry in the lower HANDLE_INDEX_BITS bits
+ * and the generation of the entry in the bits above, keeping the handle
+ * a positive int.
+ */
+#define HANDLE_INDEX_BITS		16
+#define HANDLE_INDEX_MASK		((1U << HANDLE_INDEX_BITS) - 1)
+#define HANDLE_GEN_MASK			((1U << (31 - HANDLE_INDEX_BITS)) - 1)
+#define HANDLE_DB_MAX_PTRS		(HANDLE_INDEX_MASK + 1)
+
+struct handle_db_entry {
+	void *ptr;
+	/* Index of the next free entry, only valid while ptr is NULL */
+	uint32_t next_free;
+	uint32_t gen;
+};
+
 void handle_db_destroy(struct handle_db *db)
 {
 	if (db) {
-		free(db->ptrs);
-		db->ptrs = NULL;
+		free(db->ents);
+		db->ents = NULL;
 		db->max_ptrs = 0;
+		db->first_free = 0;
 	}
 }
 
-int handle_get(struct handle_db *db, void *ptr)
+static bool grow_db(struct handle_db *db)
 {
+	size_t new_max_ptrs;
 	size_t n;
 	void *p;
-	size_t new_max_ptrs;
-
-	if (!db || !ptr)
-		return -1;
 
-	/* Try to find an empty location */
-	for (n = 0; n < db->max_ptrs; n++) {
-		if (!db->ptrs[n]) {
-			db->ptrs[n] = ptr;
-			return n;
-		}
-	}
-
-	/* No location available, grow the ptrs array */
 	if (db->max_ptrs)
 		new_max_ptrs = db->max_ptrs * 2;
 	else
 		new_max_ptrs = HANDLE_DB_INITIAL_MAX_PTRS;
-	p = realloc(db->ptrs, new_max_ptrs * sizeof(void *));
+	if (new_max_ptrs > HANDLE_DB_MAX_PTRS)
+		return false;
+
+	p = realloc(db->ents, new_max_ptrs * sizeof(*db->ents));
 	if (!p)
-		return -1;
-	db->ptrs = p;
-	memset(db->ptrs + db->max_ptrs, 0,
-	       (new_max_ptrs - db->max_ptrs) * sizeof(void *));
+		return false;
+	db->ents = p;
+	memset(db->ents + db->max_ptrs, 0,
+	       (new_max_ptrs - db->max_ptrs) * sizeof(*db->ents));
+
+	/* The list is empty, chain the new entries in index order */
+	for (n = db->max_ptrs; n < new_max_ptrs; n++)
+		db->ents[n].next_free = n + 1;
+	db->first_free = db->max_ptrs;
 	db->max_ptrs = new_max_ptrs;
 
-	/* Since n stopped at db->max_ptrs there is an empty location there */
-	db->ptrs[n] = ptr;
-	return n;
+	return true;
+}
+
+static struct handle_db_entry *find_entry(struct handle_db *db, int handle)
+{
+	struct handle_db_entry *e;
+	size_t n;
+
+	if (!db || handle < 0)
+		return NULL;
+
+	n = (unsigned int)handle & HANDLE_INDEX_MASK;
+	if (n >= db->max_ptrs)
+		return NULL;
+
+	e = db->ents + n;
+	if (!e->ptr || e->gen != (unsigned int)handle >> HANDLE_INDEX_BITS)
+		return NULL;
+
+	return e;
+}
+
+int handle_get(struct handle_db *db, void *ptr)
+{
+	struct handle_db_entry *e;
+	size_t n;
+
+	if (!db || !ptr)
+		return -1;
+
+	/* No location available, grow the entries array */
+	if (db->first_free >= db->max_ptrs && !grow_db(db))
+		return -1;
+
+	n = db->first_free;
+	e = db->ents + n;
+	db->first_free = e->next_free;
+	e->ptr = ptr;
+
+	return (e->gen << HANDLE_INDEX_BITS) | n;
 }
 
 void *handle_put(struct handle_db *db, int handle)
 {
+	struct handle_db_entry *e = find_entry(db, handle);
 	void *p;
 
-	if (!db || handle < 0 || (size_t)handle >= db->max_ptrs)
+	if (!e)
 		return NULL;
 
-	p = db->ptrs[handle];
-	db->ptrs[handle] = NULL;
+	p = e->ptr;
+	e->ptr = NULL;
+	e->gen = (e->gen + 1) & HANDLE_GEN_MASK;
+	e->next_free = db->first_free;
+	db->first_free = e - db->ents;
 	return p;
 }
 
 void *handle_lookup(struct handle_db *db, int handle)
 {
-	if (!db || handle < 0 || (size_t)handle >= db->max_ptrs)
+	struct handle_db_entry *e = find_entry(db, handle);
+
+	if (!e)
 		return NULL;
 
-	return db->ptrs[handle];
+	return e->ptr;
 }
@@ -26,19 +26,23 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <io.h>
 #include <optee_msg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <types_ext.h>
 #include <kernel/msg_param.h>
 #include <mm/mobj.h>
+#include <util.h>
 
 /**
- * msg_param_extract_pages() - extract list of pages from
- * OPTEE_MSG_ATTR_NONCONTIG buffer.
+ * msg_param_extract_runs() - extract list of physically contiguous runs of
+ * pages from OPTEE_MSG_ATTR_NONCONTIG buffer.
  *
  * @buffer:	pointer to parameters array
- * @pages:	output array of page addresses
- * @num_pages:  number of pages in array
+ * @num_pages:  number of pages covered by the buffer
+ * @runs:	output array of runs, to be freed by the caller
+ * @num_runs:	number of runs in @runs
  *
  * return:
  *	true on success, false otherwise
@@ -53,16 +57,29 @@
  * So, it is a linked list of arrays, where each element of linked list fits
  * exactly into one 4K page.
  *
- * This function extracts data from arrays into one array pointed by @pages
+ * Each entry in the arrays holds the address of a page and, in the bits
+ * covered by OPTEE_MSG_NONCONTIG_RUN_MASK, the number of physically
+ * contiguous pages following it. This function collects the entries into
+ * one array pointed by @runs.
  *
  * @buffer points to data shared with normal world, so some precautions
  * should be taken.
  */
-static bool msg_param_extract_pages(paddr_t buffer, paddr_t *pages,
-				       size_t num_pages)
+static bool msg_param_extract_runs(paddr_t buffer, size_t num_pages,
+				   struct mobj_reg_shm_run **runs,
+				   size_t *num_runs)
 {
-	size_t cnt;
+	const size_t entries_per_page = OPTEE_MSG_NONCONTIG_PAGE_SIZE /
+					sizeof(uint64_t) - 1;
+	struct mobj_reg_shm_run *r = NULL;
+	struct mobj_reg_shm_run *new_r = NULL;
+	size_t max_runs = 0;
+	size_t run_pages;
+	size_t cnt = 0;
+	size_t n = 0;
+	size_t sz;
 	struct mobj *mobj;
+	uint64_t entry;
 	paddr_t page;
 	uint64_t *va;
 	bool ret = false;
@@ -81,7 +98,7 @@ static bool msg_param_extract_pages(paddr_t buffer, paddr_t *pages,
 	va = mobj_get_va(mobj, 0);
 	assert(va);
 
-	for (cnt = 0; cnt < num_pages; cnt++, va++) {
+	while (cnt < num_pages) {
 		/*
 		 * If we about to roll over page boundary, then last entry holds
 		 * address of next page of array. Unmap current page and map
@@ -100,13 +117,37 @@ static bool msg_param_extract_pages(paddr_t buffer, paddr_t *pages,
 			va = mobj_get_va(mobj, 0);
 			assert(va);
 		}
-		pages[cnt] = *va;
-		if (pages[cnt] & SMALL_PAGE_MASK)
+
+		/* Read only once, normal world may change it meanwhile */
+		entry = *va;
+		run_pages = (entry & OPTEE_MSG_NONCONTIG_RUN_MASK) + 1;
+		if (run_pages > num_pages - cnt)
 			goto out;
+
+		/* Grow by the number of entries in one page of the list */
+		if (n == max_runs) {
+			max_runs += MIN(entries_per_page, num_pages - cnt);
+			if (MUL_OVERFLOW(max_runs, sizeof(*r), &sz))
+				goto out;
+			new_r = realloc(r, sz);
+			if (!new_r)
+				goto out;
+			r = new_r;
+		}
+
+		r[n].pa = entry & ~OPTEE_MSG_NONCONTIG_RUN_MASK;
+		r[n].num_pages = run_pages;
+		n++;
+		cnt += run_pages;
+		va++;
 	}
 
+	*runs = r;
+	*num_runs = n;
+	r = NULL;
 	ret = true;
 out:
+	free(r);
 	mobj_free(mobj);
 	return ret;
 }
@@ -115,28 +156,60 @@ struct mobj *msg_param_mobj_from_noncontig(paddr_t buf_ptr, size_t size,
 					   uint64_t shm_ref, bool map_buffer)
 {
 	struct mobj *mobj = NULL;
-	paddr_t *pages;
+	struct mobj_reg_shm_run *runs = NULL;
+	size_t num_runs = 0;
 	paddr_t page_offset;
 	size_t num_pages;
 
 	page_offset = buf_ptr & SMALL_PAGE_MASK;
 	num_pages = (size + page_offset - 1) / SMALL_PAGE_SIZE + 1;
 
-	pages = malloc(num_pages * sizeof(paddr_t));
-	if (!pages)
+	if (!msg_param_extract_runs(buf_ptr & ~SMALL_PAGE_MASK, num_pages,
+				    &runs, &num_runs))
 		return NULL;
 
-	if (!msg_param_extract_pages(buf_ptr & ~SMALL_PAGE_MASK,
-				     pages, num_pages))
-		goto out;
+	mobj = mobj_reg_shm_alloc_runs(runs, num_runs, page_offset, shm_ref);
+	if (mobj && map_buffer && mobj_reg_shm_inc_map(mobj)) {
+		mobj_free(mobj);
+		mobj = NULL;
+	}
 
-	if (map_buffer)
-		mobj = mobj_mapped_shm_alloc(pages, num_pages, page_offset,
-					     shm_ref);
-	else
-		mobj = mobj_reg_shm_alloc(pages, num_pages, page_offset,
-					  shm_ref);
-out:
-	free(pages);
+	free(runs);
 	return mobj;
 }
+
+TEE_Result msg_param_get_batch(const struct optee_msg_param *params,
+			       size_t num_params,
+			       struct msg_param_batch_entry *entries,
+			       size_t *num_entries)
+{
+	const uint64_t req_attr = OPTEE_MSG_ATTR_META |
+				  OPTEE_MSG_ATTR_TYPE_VALUE_INOUT;
+	size_t idx = 0;
+	size_t n = 0;
+	uint64_t f = 0;
+	uint64_t np = 0;
+
+	if (!num_params)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	while (idx < num_params) {
+		if (READ_ONCE(params[idx].attr) != req_attr)
+			return TEE_ERROR_BAD_PARAMETERS;
+
+		f = READ_ONCE(params[idx].u.value.a);
+		np = READ_ONCE(params[idx].u.value.b);
+		if (f > UINT32_MAX || np > TEE_NUM_PARAMS ||
+		    np >= num_params - idx)
+			return TEE_ERROR_BAD_PARAMETERS;
+
+		entries[n].idx = idx;
+		entries[n].func = f;
+		entries[n].num_params = np;
+		n++;
+		idx += np + 1;
+	}
+
+	*num_entries = n;
+	return TEE_SUCCESS;
+}
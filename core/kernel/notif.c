@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2018, Linaro Limited
+ */
+
+#include <assert.h>
+#include <io.h>
+#include <kernel/interrupt.h>
+#include <kernel/notif.h>
+#include <kernel/spinlock.h>
+#include <util.h>
+
+#ifdef CFG_VIRTUALIZATION
+#error CFG_CORE_ASYNC_NOTIF is not supported with CFG_VIRTUALIZATION
+#endif
+
+static unsigned int notif_lock = SPINLOCK_UNLOCK;
+/* Values sent, but not yet retrieved by normal world */
+static uint64_t notif_pending;
+/* Values allocated with notif_alloc_async_value() */
+static uint64_t notif_alloced;
+static bool notif_enabled;
+
+void notif_send_async(uint32_t value)
+{
+	uint32_t exceptions = 0;
+	bool raise = false;
+
+	assert(value <= NOTIF_ASYNC_VALUE_MAX);
+
+	exceptions = cpu_spin_lock_xsave(&notif_lock);
+	/*
+	 * Normal world retrieves values until none is pending, so the
+	 * interrupt is only needed when the first value becomes pending.
+	 */
+	raise = notif_enabled && !notif_pending;
+	notif_pending |= BIT64(value);
+	cpu_spin_unlock_xrestore(&notif_lock, exceptions);
+
+	if (raise)
+		itr_raise_pi(CFG_CORE_ASYNC_NOTIF_GIC_INTID);
+}
+
+bool notif_wq_wakeup(uint32_t key)
+{
+	if (key >= NOTIF_WQ_VALUE_COUNT || !READ_ONCE(notif_enabled))
+		return false;
+
+	notif_send_async(key);
+	return true;
+}
+
+TEE_Result notif_alloc_async_value(uint32_t *value)
+{
+	TEE_Result res = TEE_ERROR_OUT_OF_MEMORY;
+	uint32_t exceptions = 0;
+	uint32_t n = 0;
+
+	exceptions = cpu_spin_lock_xsave(&notif_lock);
+	for (n = NOTIF_WQ_VALUE_COUNT; n <= NOTIF_ASYNC_VALUE_MAX; n++) {
+		if (!(notif_alloced & BIT64(n))) {
+			notif_alloced |= BIT64(n);
+			*value = n;
+			res = TEE_SUCCESS;
+			break;
+		}
+	}
+	cpu_spin_unlock_xrestore(&notif_lock, exceptions);
+
+	return res;
+}
+
+void notif_free_async_value(uint32_t value)
+{
+	uint32_t exceptions = 0;
+
+	assert(value >= NOTIF_WQ_VALUE_COUNT &&
+	       value <= NOTIF_ASYNC_VALUE_MAX);
+
+	exceptions = cpu_spin_lock_xsave(&notif_lock);
+	notif_alloced &= ~BIT64(value);
+	/* A value sent by the previous owner isn't for the next one */
+	notif_pending &= ~BIT64(value);
+	cpu_spin_unlock_xrestore(&notif_lock, exceptions);
+}
+
+bool notif_get_value(uint32_t *value, bool *pending)
+{
+	uint32_t exceptions = 0;
+	bool valid = false;
+
+	exceptions = cpu_spin_lock_xsave(&notif_lock);
+	if (notif_pending) {
+		*value = __builtin_ctzll(notif_pending);
+		notif_pending &= ~BIT64(*value);
+		valid = true;
+	}
+	*pending = notif_pending;
+	cpu_spin_unlock_xrestore(&notif_lock, exceptions);
+
+	return valid;
+}
+
+void notif_enable_async(void)
+{
+	uint32_t exceptions = 0;
+	bool raise = false;
+
+	exceptions = cpu_spin_lock_xsave(&notif_lock);
+	raise = !notif_enabled && notif_pending;
+	notif_enabled = true;
+	cpu_spin_unlock_xrestore(&notif_lock, exceptions);
+
+	/* Values sent before normal world was ready */
+	if (raise)
+		itr_raise_pi(CFG_CORE_ASYNC_NOTIF_GIC_INTID);
+}
@@ -8,6 +8,7 @@ srcs-y += handle.c
 srcs-y += interrupt.c
 srcs-$(CFG_LOCKDEP) += lockdep.c
 srcs-y += msg_param.c
+srcs-$(CFG_CORE_ASYNC_NOTIF) += notif.c
 srcs-y += panic.c
 srcs-y += refcount.c
 srcs-y += tee_misc.c
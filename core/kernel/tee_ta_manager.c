@@ -31,11 +31,34 @@
 #include <utee_types.h>
 #include <util.h>
 
-/* This mutex protects the critical section in tee_ta_init_session */
+/*
+ * Locking overview:
+ * tee_ta_mutex protects the critical section in tee_ta_init_session,
+ * the registered contexts and their reference counters.
+ * tee_ta_sess_mutex protects the sessions, their reference counters and
+ * the lists of open sessions. It's only held for short periods of time
+ * and never while entering a TA or loading a TA.
+ * ctx->busy_mu protects ctx->busy, so invoking unrelated TAs doesn't
+ * contend on a common lock.
+ * tee_ta_si_mutex protects the single-instance lock below.
+ *
+ * The lock order is tee_ta_mutex before tee_ta_sess_mutex, the other
+ * mutexes are never held while acquiring another mutex.
+ */
 struct mutex tee_ta_mutex = MUTEX_INITIALIZER;
-struct tee_ta_ctx_head tee_ctxes = TAILQ_HEAD_INITIALIZER(tee_ctxes);
+static struct mutex tee_ta_sess_mutex = MUTEX_INITIALIZER;
+
+/* Registered contexts, hashed by UUID */
+#define TEE_TA_CTX_HASH_SIZE	16
+static struct tee_ta_ctx_head tee_ctxes[TEE_TA_CTX_HASH_SIZE];
+
+/* Open sessions of all the lists of sessions, hashed by session ID */
+#define TEE_TA_SESS_HASH_SIZE	32
+LIST_HEAD(tee_ta_sess_hash_head, tee_ta_session);
+static struct tee_ta_sess_hash_head tee_sessions[TEE_TA_SESS_HASH_SIZE];
 
 #ifndef CFG_CONCURRENT_SINGLE_INSTANCE_TA
+static struct mutex tee_ta_si_mutex = MUTEX_INITIALIZER;
 static struct condvar tee_ta_cv = CONDVAR_INITIALIZER;
 static int tee_ta_single_instance_thread = THREAD_ID_INVALID;
 static size_t tee_ta_single_instance_count;
@@ -57,22 +80,26 @@ static bool has_single_instance_lock(void)
 #else
 static void lock_single_instance(void)
 {
-	/* Requires tee_ta_mutex to be held */
+	mutex_lock(&tee_ta_si_mutex);
+
 	if (tee_ta_single_instance_thread != thread_get_id()) {
 		/* Wait until the single-instance lock is available. */
 		while (tee_ta_single_instance_thread != THREAD_ID_INVALID)
-			condvar_wait(&tee_ta_cv, &tee_ta_mutex);
+			condvar_wait(&tee_ta_cv, &tee_ta_si_mutex);
 
 		tee_ta_single_instance_thread = thread_get_id();
 		assert(tee_ta_single_instance_count == 0);
 	}
 
 	tee_ta_single_instance_count++;
+
+	mutex_unlock(&tee_ta_si_mutex);
 }
 
 static void unlock_single_instance(void)
 {
-	/* Requires tee_ta_mutex to be held */
+	mutex_lock(&tee_ta_si_mutex);
+
 	assert(tee_ta_single_instance_thread == thread_get_id());
 	assert(tee_ta_single_instance_count > 0);
 
@@ -81,11 +108,16 @@ static void unlock_single_instance(void)
 		tee_ta_single_instance_thread = THREAD_ID_INVALID;
 		condvar_signal(&tee_ta_cv);
 	}
+
+	mutex_unlock(&tee_ta_si_mutex);
 }
 
 static bool has_single_instance_lock(void)
 {
-	/* Requires tee_ta_mutex to be held */
+	/*
+	 * No lock needed, only the calling thread can make this true or
+	 * false for the calling thread.
+	 */
 	return tee_ta_single_instance_thread == thread_get_id();
 }
 #endif
@@ -97,11 +129,11 @@ static bool tee_ta_try_set_busy(struct tee_ta_ctx *ctx)
 	if (ctx->flags & TA_FLAG_CONCURRENT)
 		return true;
 
-	mutex_lock(&tee_ta_mutex);
-
 	if (ctx->flags & TA_FLAG_SINGLE_INSTANCE)
 		lock_single_instance();
 
+	mutex_lock(&ctx->busy_mu);
+
 	if (has_single_instance_lock()) {
 		if (ctx->busy) {
 			/*
@@ -110,8 +142,6 @@ static bool tee_ta_try_set_busy(struct tee_ta_ctx *ctx)
 			 * dead-lock, we release the lock and return false.
 			 */
 			rc = false;
-			if (ctx->flags & TA_FLAG_SINGLE_INSTANCE)
-				unlock_single_instance();
 		}
 	} else {
 		/*
@@ -119,13 +149,17 @@ static bool tee_ta_try_set_busy(struct tee_ta_ctx *ctx)
 		 * wait for the TA to become available.
 		 */
 		while (ctx->busy)
-			condvar_wait(&ctx->busy_cv, &tee_ta_mutex);
+			condvar_wait(&ctx->busy_cv, &ctx->busy_mu);
 	}
 
 	/* Either it's already true or we should set it to true */
 	ctx->busy = true;
 
-	mutex_unlock(&tee_ta_mutex);
+	mutex_unlock(&ctx->busy_mu);
+
+	if (!rc && (ctx->flags & TA_FLAG_SINGLE_INSTANCE))
+		unlock_single_instance();
+
 	return rc;
 }
 
@@ -140,16 +174,16 @@ static void tee_ta_clear_busy(struct tee_ta_ctx *ctx)
 	if (ctx->flags & TA_FLAG_CONCURRENT)
 		return;
 
-	mutex_lock(&tee_ta_mutex);
+	mutex_lock(&ctx->busy_mu);
 
 	assert(ctx->busy);
 	ctx->busy = false;
 	condvar_signal(&ctx->busy_cv);
 
+	mutex_unlock(&ctx->busy_mu);
+
 	if (ctx->flags & TA_FLAG_SINGLE_INSTANCE)
 		unlock_single_instance();
-
-	mutex_unlock(&tee_ta_mutex);
 }
 
 static void dec_session_ref_count(struct tee_ta_session *s)
@@ -162,7 +196,7 @@ static void dec_session_ref_count(struct tee_ta_session *s)
 
 void tee_ta_put_session(struct tee_ta_session *s)
 {
-	mutex_lock(&tee_ta_mutex);
+	mutex_lock(&tee_ta_sess_mutex);
 
 	if (s->lock_thread == thread_get_id()) {
 		s->lock_thread = THREAD_ID_INVALID;
@@ -170,23 +204,24 @@ void tee_ta_put_session(struct tee_ta_session *s)
 	}
 	dec_session_ref_count(s);
 
-	mutex_unlock(&tee_ta_mutex);
+	mutex_unlock(&tee_ta_sess_mutex);
+}
+
+static struct tee_ta_sess_hash_head *sess_hash_head(uint32_t id)
+{
+	return tee_sessions + id % TEE_TA_SESS_HASH_SIZE;
 }
 
 static struct tee_ta_session *tee_ta_find_session_nolock(uint32_t id,
 			struct tee_ta_session_head *open_sessions)
 {
 	struct tee_ta_session *s = NULL;
-	struct tee_ta_session *found = NULL;
 
-	TAILQ_FOREACH(s, open_sessions, link) {
-		if (s->id == id) {
-			found = s;
-			break;
-		}
-	}
+	LIST_FOREACH(s, sess_hash_head(id), hash_link)
+		if (s->id == id && s->open_sessions == open_sessions)
+			return s;
 
-	return found;
+	return NULL;
 }
 
 struct tee_ta_session *tee_ta_find_session(uint32_t id,
@@ -194,11 +229,11 @@ struct tee_ta_session *tee_ta_find_session(uint32_t id,
 {
 	struct tee_ta_session *s = NULL;
 
-	mutex_lock(&tee_ta_mutex);
+	mutex_lock(&tee_ta_sess_mutex);
 
 	s = tee_ta_find_session_nolock(id, open_sessions);
 
-	mutex_unlock(&tee_ta_mutex);
+	mutex_unlock(&tee_ta_sess_mutex);
 
 	return s;
 }
@@ -208,7 +243,7 @@ struct tee_ta_session *tee_ta_get_session(uint32_t id, bool exclusive,
 {
 	struct tee_ta_session *s;
 
-	mutex_lock(&tee_ta_mutex);
+	mutex_lock(&tee_ta_sess_mutex);
 
 	while (true) {
 		s = tee_ta_find_session_nolock(id, open_sessions);
@@ -225,7 +260,7 @@ struct tee_ta_session *tee_ta_get_session(uint32_t id, bool exclusive,
 		assert(s->lock_thread != thread_get_id());
 
 		while (s->lock_thread != THREAD_ID_INVALID && !s->unlink)
-			condvar_wait(&s->lock_cv, &tee_ta_mutex);
+			condvar_wait(&s->lock_cv, &tee_ta_sess_mutex);
 
 		if (s->unlink) {
 			dec_session_ref_count(s);
@@ -237,14 +272,14 @@ struct tee_ta_session *tee_ta_get_session(uint32_t id, bool exclusive,
 		break;
 	}
 
-	mutex_unlock(&tee_ta_mutex);
+	mutex_unlock(&tee_ta_sess_mutex);
 	return s;
 }
 
 static void tee_ta_unlink_session(struct tee_ta_session *s,
 			struct tee_ta_session_head *open_sessions)
 {
-	mutex_lock(&tee_ta_mutex);
+	mutex_lock(&tee_ta_sess_mutex);
 
 	assert(s->ref_count >= 1);
 	assert(s->lock_thread == thread_get_id());
@@ -254,11 +289,24 @@ static void tee_ta_unlink_session(struct tee_ta_session *s,
 	condvar_broadcast(&s->lock_cv);
 
 	while (s->ref_count != 1)
-		condvar_wait(&s->refc_cv, &tee_ta_mutex);
+		condvar_wait(&s->refc_cv, &tee_ta_sess_mutex);
 
 	TAILQ_REMOVE(open_sessions, s, link);
+	LIST_REMOVE(s, hash_link);
 
-	mutex_unlock(&tee_ta_mutex);
+	mutex_unlock(&tee_ta_sess_mutex);
+}
+
+static struct tee_ta_ctx_head *ctx_hash_head(const TEE_UUID *uuid)
+{
+	return tee_ctxes + (uuid->timeLow ^ uuid->timeMid) %
+			   TEE_TA_CTX_HASH_SIZE;
+}
+
+void tee_ta_register_ctx(struct tee_ta_ctx *ctx)
+{
+	mutex_init(&ctx->busy_mu);
+	LIST_INSERT_HEAD(ctx_hash_head(&ctx->uuid), ctx, link);
 }
 
 /*
@@ -269,7 +317,7 @@ static struct tee_ta_ctx *tee_ta_context_find(const TEE_UUID *uuid)
 {
 	struct tee_ta_ctx *ctx;
 
-	TAILQ_FOREACH(ctx, &tee_ctxes, link) {
+	LIST_FOREACH(ctx, ctx_hash_head(uuid), link) {
 		if (memcmp(&ctx->uuid, uuid, sizeof(TEE_UUID)) == 0)
 			return ctx;
 	}
@@ -442,10 +490,11 @@ TEE_Result tee_ta_close_session(struct tee_ta_session *csess,
 	if (!ctx->ref_count && !keep_alive) {
 		DMSG("Destroy TA ctx");
 
-		TAILQ_REMOVE(&tee_ctxes, ctx, link);
+		LIST_REMOVE(ctx, link);
 		mutex_unlock(&tee_ta_mutex);
 
 		condvar_destroy(&ctx->busy_cv);
+		mutex_destroy(&ctx->busy_mu);
 
 		pgt_flush_ctx(ctx);
 		ctx->ops->destroy(ctx);
@@ -531,16 +580,19 @@ static TEE_Result tee_ta_init_session(TEE_ErrorOrigin *err,
 	 * We take the global TA mutex here and hold it while doing
 	 * RPC to load the TA. This big critical section should be broken
 	 * down into smaller pieces.
+	 *
+	 * The session is only made visible once it's initialized. As
+	 * sessions are only added here with tee_ta_mutex held the ID
+	 * remains free in the meantime.
 	 */
-
-
 	mutex_lock(&tee_ta_mutex);
+	mutex_lock(&tee_ta_sess_mutex);
 	s->id = new_session_id(open_sessions);
+	mutex_unlock(&tee_ta_sess_mutex);
 	if (!s->id) {
 		res = TEE_ERROR_OVERFLOW;
 		goto out;
 	}
-	TAILQ_INSERT_TAIL(open_sessions, s, link);
 
 	/* Look for already loaded TA */
 	ctx = tee_ta_context_find(uuid);
@@ -560,9 +612,13 @@ static TEE_Result tee_ta_init_session(TEE_ErrorOrigin *err,
 
 out:
 	if (res == TEE_SUCCESS) {
+		mutex_lock(&tee_ta_sess_mutex);
+		s->open_sessions = open_sessions;
+		TAILQ_INSERT_TAIL(open_sessions, s, link);
+		LIST_INSERT_HEAD(sess_hash_head(s->id), s, hash_link);
+		mutex_unlock(&tee_ta_sess_mutex);
 		*sess = s;
 	} else {
-		TAILQ_REMOVE(open_sessions, s, link);
 		free(s);
 	}
 	mutex_unlock(&tee_ta_mutex);
@@ -5,9 +5,11 @@
 
 #include <crypto/crypto.h>
 #include <kernel/panic.h>
+#include <mempool.h>
 #include <mpa.h>
 #include <mpalib.h>
 #include <tomcrypt.h>
+#include <util.h>
 #include "tomcrypt_mp.h"
 
 static mpa_scratch_mem external_mem_pool;
@@ -18,9 +20,11 @@ static mpa_scratch_mem external_mem_pool;
 	mpa_scratch_mem_size_in_U32(LTC_VARIABLE_NUMBER, \
 				    CFG_CORE_BIGNUM_MAX_BITS)
 
+#define LTC_MEMPOOL_ARENA_SIZE \
+	ROUNDUP(LTC_MEMPOOL_U32_SIZE * sizeof(uint32_t), MEMPOOL_ALIGN)
+
 #if defined(CFG_WITH_PAGER)
 #include <mm/tee_pager.h>
-#include <util.h>
 #include <mm/core_mmu.h>
 
 /* allocate pageable_zi vmem for mpa scratch memory pool */
@@ -29,20 +33,22 @@ static struct mempool *get_mpa_scratch_memory_pool(void)
 	size_t size;
 	void *data;
 
-	size = ROUNDUP((LTC_MEMPOOL_U32_SIZE * sizeof(uint32_t)),
-		        SMALL_PAGE_SIZE);
-	data = tee_pager_alloc(size, 0);
+	size = ROUNDUP(LTC_MEMPOOL_ARENA_SIZE, SMALL_PAGE_SIZE);
+	data = tee_pager_alloc(size * CFG_CORE_BIGNUM_NUM_ARENAS, 0);
 	if (!data)
 		panic();
 
-	return mempool_alloc_pool(data, size, tee_pager_release_phys);
+	return mempool_alloc_pool_arenas(data, size, CFG_CORE_BIGNUM_NUM_ARENAS,
+					 tee_pager_release_phys);
 }
 #else /* CFG_WITH_PAGER */
 static struct mempool *get_mpa_scratch_memory_pool(void)
 {
-	static uint32_t data[LTC_MEMPOOL_U32_SIZE] __aligned(MEMPOOL_ALIGN);
+	static uint8_t data[CFG_CORE_BIGNUM_NUM_ARENAS][LTC_MEMPOOL_ARENA_SIZE]
+		__aligned(MEMPOOL_ALIGN);
 
-	return mempool_alloc_pool(data, sizeof(data), NULL);
+	return mempool_alloc_pool_arenas(data, LTC_MEMPOOL_ARENA_SIZE,
+					 CFG_CORE_BIGNUM_NUM_ARENAS, NULL);
 }
 #endif
 
@@ -62,6 +68,11 @@ void init_mp_tomcrypt(void)
 	external_mem_pool = &mem;
 }
 
+void crypto_bignum_get_pool_stats(struct mempool_stats *stats, bool reset)
+{
+	mempool_get_stats(external_mem_pool->pool, stats, reset);
+}
+
 static int init_mpanum(mpanum *a)
 {
 	LTC_ARGCHK(a != NULL);
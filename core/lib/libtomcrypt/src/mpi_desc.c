@@ -22,25 +22,31 @@
 #define MPI_MEMPOOL_SIZE	(42 * 1024)
 
 #if defined(CFG_WITH_PAGER)
-/* allocate pageable_zi vmem for mp scratch memory pool */
+/*
+ * allocate pageable_zi vmem for mp scratch memory pool, the physical pages
+ * of an arena are released each time it's emptied.
+ */
 static struct mempool *get_mp_scratch_memory_pool(void)
 {
 	size_t size;
 	void *data;
 
 	size = ROUNDUP(MPI_MEMPOOL_SIZE, SMALL_PAGE_SIZE);
-	data = tee_pager_alloc(size, 0);
+	data = tee_pager_alloc(size * CFG_CORE_BIGNUM_NUM_ARENAS, 0);
 	if (!data)
 		panic();
 
-	return mempool_alloc_pool(data, size, tee_pager_release_phys);
+	return mempool_alloc_pool_arenas(data, size, CFG_CORE_BIGNUM_NUM_ARENAS,
+					 tee_pager_release_phys);
 }
 #else /* CFG_WITH_PAGER */
 static struct mempool *get_mp_scratch_memory_pool(void)
 {
-	static uint8_t data[MPI_MEMPOOL_SIZE] __aligned(MEMPOOL_ALIGN);
+	static uint8_t data[CFG_CORE_BIGNUM_NUM_ARENAS][MPI_MEMPOOL_SIZE]
+		__aligned(MEMPOOL_ALIGN);
 
-	return mempool_alloc_pool(data, sizeof(data), NULL);
+	return mempool_alloc_pool_arenas(data, MPI_MEMPOOL_SIZE,
+					 CFG_CORE_BIGNUM_NUM_ARENAS, NULL);
 }
 #endif
 
@@ -53,6 +59,11 @@ void init_mp_tomcrypt(void)
 	mbedtls_mpi_mempool = p;
 }
 
+void crypto_bignum_get_pool_stats(struct mempool_stats *stats, bool reset)
+{
+	mempool_get_stats(mbedtls_mpi_mempool, stats, reset);
+}
+
 static int init(void **a)
 {
 	mbedtls_mpi *bn = mempool_alloc(mbedtls_mpi_mempool, sizeof(*bn));
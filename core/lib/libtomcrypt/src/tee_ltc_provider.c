@@ -1711,16 +1711,20 @@ TEE_Result crypto_cipher_alloc_ctx(void **ctx_ret, uint32_t algo)
 	return TEE_SUCCESS;
 }
 
-void crypto_cipher_free_ctx(void *ctx, uint32_t algo __maybe_unused)
+void crypto_cipher_free_ctx(void *ctx, uint32_t algo)
 {
-	size_t ctx_size __maybe_unused;
+	size_t ctx_size = 0;
 
 	/*
 	 * Check that it's a supported algo, or crypto_cipher_alloc_ctx()
 	 * could never have succeded above.
 	 */
-	if (ctx)
-		assert(!cipher_get_ctx_size(algo, &ctx_size));
+	if (ctx) {
+		if (cipher_get_ctx_size(algo, &ctx_size))
+			assert(0);
+		/* The context holds the expanded key */
+		memzero_explicit(ctx, ctx_size);
+	}
 	free(ctx);
 }
 
@@ -1873,6 +1877,76 @@ TEE_Result crypto_cipher_init(void *ctx, uint32_t algo,
 		return TEE_ERROR_BAD_STATE;
 }
 
+TEE_Result crypto_cipher_init_key_ctx(void *key_ctx, uint32_t algo,
+				      const uint8_t *key, size_t key_len)
+{
+	uint8_t iv[TEE_AES_BLOCK_SIZE] = { 0 };
+	TEE_Result res;
+	size_t iv_len;
+
+	switch (algo) {
+	case TEE_ALG_AES_ECB_NOPAD:
+	case TEE_ALG_DES_ECB_NOPAD:
+	case TEE_ALG_DES3_ECB_NOPAD:
+	case TEE_ALG_AES_CBC_NOPAD:
+	case TEE_ALG_DES_CBC_NOPAD:
+	case TEE_ALG_DES3_CBC_NOPAD:
+	case TEE_ALG_AES_CTR:
+		res = crypto_cipher_get_block_size(algo, &iv_len);
+		if (res)
+			return res;
+		/* Any IV will do, it's replaced when the key is used */
+		return crypto_cipher_init(key_ctx, algo, TEE_MODE_ENCRYPT, key,
+					  key_len, NULL, 0, iv, iv_len);
+	default:
+		return TEE_ERROR_NOT_SUPPORTED;
+	}
+}
+
+TEE_Result crypto_cipher_init_from_key_ctx(void *ctx, uint32_t algo,
+					   TEE_OperationMode mode __unused,
+					   const void *key_ctx,
+					   const uint8_t *iv __maybe_unused,
+					   size_t iv_len __maybe_unused)
+{
+	int ltc_res = CRYPT_OK;
+
+	crypto_cipher_copy_state(ctx, (void *)key_ctx, algo);
+
+	switch (algo) {
+#if defined(CFG_CRYPTO_ECB)
+	case TEE_ALG_AES_ECB_NOPAD:
+	case TEE_ALG_DES_ECB_NOPAD:
+	case TEE_ALG_DES3_ECB_NOPAD:
+		break;
+#endif
+#if defined(CFG_CRYPTO_CBC)
+	case TEE_ALG_AES_CBC_NOPAD:
+	case TEE_ALG_DES_CBC_NOPAD:
+	case TEE_ALG_DES3_CBC_NOPAD:
+		if (!iv)
+			return TEE_ERROR_BAD_PARAMETERS;
+		ltc_res = cbc_setiv(iv, iv_len, ctx);
+		break;
+#endif
+#if defined(CFG_CRYPTO_CTR)
+	case TEE_ALG_AES_CTR:
+		if (!iv)
+			return TEE_ERROR_BAD_PARAMETERS;
+		ltc_res = ctr_setiv(iv, iv_len, ctx);
+		break;
+#endif
+	default:
+		return TEE_ERROR_NOT_SUPPORTED;
+	}
+
+	if (ltc_res == CRYPT_INVALID_ARG)
+		return TEE_ERROR_BAD_PARAMETERS;
+	if (ltc_res != CRYPT_OK)
+		return TEE_ERROR_BAD_STATE;
+	return TEE_SUCCESS;
+}
+
 TEE_Result crypto_cipher_update(void *ctx, uint32_t algo,
 				TEE_OperationMode mode,
 				bool last_block __maybe_unused,
@@ -2064,16 +2138,20 @@ TEE_Result crypto_mac_alloc_ctx(void **ctx_ret, uint32_t algo)
 	return TEE_SUCCESS;
 }
 
-void crypto_mac_free_ctx(void *ctx, uint32_t algo __maybe_unused)
+void crypto_mac_free_ctx(void *ctx, uint32_t algo)
 {
-	size_t ctx_size __maybe_unused;
+	size_t ctx_size = 0;
 
 	/*
 	 * Check that it's a supported algo, or crypto_mac_alloc_ctx()
 	 * could never have succeded above.
 	 */
-	if (ctx)
-		assert(!mac_get_ctx_size(algo, &ctx_size));
+	if (ctx) {
+		if (mac_get_ctx_size(algo, &ctx_size))
+			assert(0);
+		/* The context holds the expanded key */
+		memzero_explicit(ctx, ctx_size);
+	}
 	free(ctx);
 }
 
@@ -2573,6 +2651,23 @@ TEE_Result crypto_aes_gcm_init(void *ctx, TEE_OperationMode mode __unused,
 	return TEE_SUCCESS;
 }
 
+TEE_Result crypto_aes_gcm_init_key_ctx(void *key_ctx __unused,
+				       const uint8_t *key __unused,
+				       size_t key_len __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+
+TEE_Result crypto_aes_gcm_init_from_key_ctx(void *ctx __unused,
+					    TEE_OperationMode mode __unused,
+					    const void *key_ctx __unused,
+					    const uint8_t *nonce __unused,
+					    size_t nonce_len __unused,
+					    size_t tag_len __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+
 TEE_Result crypto_aes_gcm_update_aad(void *ctx, const uint8_t *data, size_t len)
 {
 	struct tee_gcm_state *gcm = ctx;
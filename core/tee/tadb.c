@@ -9,6 +9,7 @@
 #include <kernel/mutex.h>
 #include <kernel/refcount.h>
 #include <kernel/thread.h>
+#include <kernel/user_ta.h>
 #include <mm/mobj.h>
 #include <optee_rpc_cmd.h>
 #include <stdio.h>
@@ -71,6 +72,19 @@ static struct tee_tadb_dir *tadb_db;
 static struct refcount tadb_db_refc;
 static struct mutex tadb_mutex = MUTEX_INITIALIZER;
 
+/*
+ * In-memory index of the TA database, element n holds the UUID of entry
+ * n, or the null UUID if the entry is free. It's loaded when the
+ * database is first opened and updated with each change of the database
+ * so finding a TA only needs to read its entry. If the index can't be
+ * kept up to date it's invalidated, and the database is scanned until
+ * the index is loaded again. Protected by tadb_mutex, only updated while
+ * it's held for writing.
+ */
+static TEE_UUID *tadb_index;
+static size_t tadb_index_num_ents;
+static bool tadb_index_valid;
+
 static void file_num_to_str(char *buf, size_t blen, uint32_t file_number)
 {
 	snprintf(buf, blen, "%" PRIu32 ".ta", file_number);
@@ -190,6 +204,61 @@ static TEE_Result write_ent(struct tee_tadb_dir *db, size_t idx,
 	return db->ops->write(db->fh, idx * l, entry, l);
 }
 
+static TEE_Result grow_index(size_t num_ents)
+{
+	TEE_UUID *p;
+
+	if (num_ents <= tadb_index_num_ents)
+		return TEE_SUCCESS;
+
+	p = realloc(tadb_index, num_ents * sizeof(*p));
+	if (!p)
+		return TEE_ERROR_OUT_OF_MEMORY;
+	memset(p + tadb_index_num_ents, 0,
+	       (num_ents - tadb_index_num_ents) * sizeof(*p));
+	tadb_index = p;
+	tadb_index_num_ents = num_ents;
+
+	return TEE_SUCCESS;
+}
+
+static void update_index(size_t idx, const TEE_UUID *uuid)
+{
+	if (!tadb_index_valid)
+		return;
+
+	if (grow_index(idx + 1))
+		tadb_index_valid = false;
+	else
+		tadb_index[idx] = *uuid;
+}
+
+static TEE_Result load_index(struct tee_tadb_dir *db)
+{
+	struct tadb_entry entry;
+	TEE_Result res;
+	size_t idx;
+
+	tadb_index_valid = false;
+	tadb_index_num_ents = 0;
+
+	for (idx = 0;; idx++) {
+		res = read_ent(db, idx, &entry);
+		if (res == TEE_ERROR_ITEM_NOT_FOUND)
+			break;
+		if (res)
+			return res;
+
+		res = grow_index(idx + 1);
+		if (res)
+			return res;
+		tadb_index[idx] = entry.prop.uuid;
+	}
+
+	tadb_index_valid = true;
+	return TEE_SUCCESS;
+}
+
 static TEE_Result tadb_open(struct tee_tadb_dir **db_ret)
 {
 	TEE_Result res;
@@ -208,12 +277,17 @@ static TEE_Result tadb_open(struct tee_tadb_dir **db_ret)
 	if (res == TEE_ERROR_ITEM_NOT_FOUND)
 		res = db->ops->create(&po, false, NULL, 0, NULL, 0, NULL, 0,
 				      &db->fh);
-
 	if (res)
-		free(db);
-	else
-		*db_ret = db;
+		goto err;
+
+	/* Without an index the database is scanned instead */
+	if (!tadb_index_valid && load_index(db))
+		EMSG("Failed to load TA database index");
 
+	*db_ret = db;
+	return TEE_SUCCESS;
+err:
+	free(db);
 	return res;
 }
 
@@ -350,8 +424,11 @@ static TEE_Result populate_files(struct tee_tadb_dir *db)
 			     entry.file_number);
 			memset(&entry, 0, sizeof(entry));
 			res = write_ent(db, idx, &entry);
-			if (res)
+			if (res) {
+				tadb_index_valid = false;
 				goto err;
+			}
+			update_index(idx, &entry.prop.uuid);
 			continue;
 		}
 
@@ -491,12 +568,68 @@ void tee_tadb_ta_close_and_delete(struct tee_tadb_ta_write *ta)
 	free(ta);
 }
 
+/*
+ * The entry found in the index is always read back to check that the
+ * storage agrees, this includes a free entry or the end of the database
+ * when looking for the null UUID. TEE_ERROR_BAD_STATE is returned if
+ * the index is out of sync.
+ */
+static TEE_Result find_ent_in_index(struct tee_tadb_dir *db,
+				    const TEE_UUID *uuid, size_t *idx_ret,
+				    struct tadb_entry *entry_ret)
+{
+	struct tadb_entry entry;
+	TEE_Result res;
+	size_t idx;
+
+	for (idx = 0; idx < tadb_index_num_ents; idx++)
+		if (!memcmp(tadb_index + idx, uuid, sizeof(*uuid)))
+			break;
+
+	*idx_ret = idx;
+	res = read_ent(db, idx, &entry);
+	if (idx == tadb_index_num_ents) {
+		if (res == TEE_ERROR_ITEM_NOT_FOUND)
+			return TEE_ERROR_ITEM_NOT_FOUND;
+		return res ? res : TEE_ERROR_BAD_STATE;
+	}
+	if (res == TEE_ERROR_ITEM_NOT_FOUND)
+		return TEE_ERROR_BAD_STATE;
+	if (res)
+		return res;
+	if (memcmp(&entry.prop.uuid, uuid, sizeof(*uuid)))
+		return TEE_ERROR_BAD_STATE;
+
+	if (entry_ret)
+		*entry_ret = entry;
+	return TEE_SUCCESS;
+}
+
+/*
+ * @may_update_index is true if tadb_mutex is held for writing, an index
+ * found out of sync with the storage is then invalidated. With only a
+ * read lock the database is just scanned this time.
+ */
 static TEE_Result find_ent(struct tee_tadb_dir *db, const TEE_UUID *uuid,
-			   size_t *idx_ret, struct tadb_entry *entry_ret)
+			   size_t *idx_ret, struct tadb_entry *entry_ret,
+			   bool may_update_index)
 {
 	TEE_Result res;
 	size_t idx;
 
+	if (tadb_index_valid) {
+		res = find_ent_in_index(db, uuid, idx_ret, entry_ret);
+		if (res != TEE_ERROR_BAD_STATE)
+			return res;
+		/*
+		 * The storage doesn't match the index, fall back to a scan
+		 * until the index is loaded again
+		 */
+		EMSG("TA database index out of sync");
+		if (may_update_index)
+			tadb_index_valid = false;
+	}
+
 	/*
 	 * Search for the provided uuid, if it's found return the index it
 	 * has together with TEE_SUCCESS.
@@ -528,7 +661,7 @@ static TEE_Result find_ent(struct tee_tadb_dir *db, const TEE_UUID *uuid,
 static TEE_Result find_free_ent_idx(struct tee_tadb_dir *db, size_t *idx)
 {
 	const TEE_UUID null_uuid = { 0 };
-	TEE_Result res = find_ent(db, &null_uuid, idx, NULL);
+	TEE_Result res = find_ent(db, &null_uuid, idx, NULL, true);
 
 	/*
 	 * Note that *idx is set to the number of entries on
@@ -564,7 +697,7 @@ TEE_Result tee_tadb_ta_close_and_commit(struct tee_tadb_ta_write *ta)
 	 *
 	 * If there isn't an existing TA to replace, grab a new entry.
 	 */
-	res = find_ent(ta->db, &ta->entry.prop.uuid, &idx, &old_ent);
+	res = find_ent(ta->db, &ta->entry.prop.uuid, &idx, &old_ent, true);
 	if (!res) {
 		have_old_ent = true;
 	} else {
@@ -573,12 +706,16 @@ TEE_Result tee_tadb_ta_close_and_commit(struct tee_tadb_ta_write *ta)
 			goto err_mutex;
 	}
 	res = write_ent(ta->db, idx, &ta->entry);
-	if (res)
+	if (res) {
+		tadb_index_valid = false;
 		goto err_mutex;
+	}
+	update_index(idx, &ta->entry.prop.uuid);
 	if (have_old_ent)
 		clear_file(ta->db, old_ent.file_number);
 	mutex_unlock(&tadb_mutex);
 
+	ta_image_cache_invalidate(&ta->entry.prop.uuid);
 	crypto_authenc_final(ta->ctx, TADB_AUTH_ENC_ALG);
 	crypto_authenc_free_ctx(ta->ctx, TADB_AUTH_ENC_ALG);
 	tadb_put(ta->db);
@@ -610,7 +747,7 @@ TEE_Result tee_tadb_ta_delete(const TEE_UUID *uuid)
 		return res;
 
 	mutex_lock(&tadb_mutex);
-	res = find_ent(db, uuid, &idx, &entry);
+	res = find_ent(db, uuid, &idx, &entry, true);
 	if (res) {
 		mutex_unlock(&tadb_mutex);
 		tee_tadb_close(db);
@@ -619,6 +756,10 @@ TEE_Result tee_tadb_ta_delete(const TEE_UUID *uuid)
 
 	clear_file(db, entry.file_number);
 	res = write_ent(db, idx, &null_entry);
+	if (res)
+		tadb_index_valid = false;
+	else
+		update_index(idx, &null_entry.prop.uuid);
 	mutex_unlock(&tadb_mutex);
 
 	tee_tadb_close(db);
@@ -626,6 +767,7 @@ TEE_Result tee_tadb_ta_delete(const TEE_UUID *uuid)
 		return res;
 
 	ta_operation_remove(entry.file_number);
+	ta_image_cache_invalidate(uuid);
 	return TEE_SUCCESS;
 }
 
@@ -652,7 +794,7 @@ TEE_Result tee_tadb_ta_open(const TEE_UUID *uuid,
 			goto err_free; /* Mustn't all tadb_put() */
 
 		mutex_read_lock(&tadb_mutex);
-		res = find_ent(ta->db, uuid, &idx, &ta->entry);
+		res = find_ent(ta->db, uuid, &idx, &ta->entry, false);
 		mutex_read_unlock(&tadb_mutex);
 		if (res)
 			goto err;
@@ -683,6 +825,13 @@ tee_tadb_ta_get_property(struct tee_tadb_ta_read *ta)
 	return &ta->entry.prop;
 }
 
+const uint8_t *tee_tadb_ta_get_tag(struct tee_tadb_ta_read *ta,
+				   size_t *tag_len)
+{
+	*tag_len = sizeof(ta->entry.tag);
+	return ta->entry.tag;
+}
+
 static TEE_Result ta_load(struct tee_tadb_ta_read *ta)
 {
 	TEE_Result res;
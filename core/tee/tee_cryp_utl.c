@@ -14,6 +14,7 @@
 #include <tee/tee_cryp_utl.h>
 #include <trace.h>
 #include <utee_defines.h>
+#include <util.h>
 
 TEE_Result tee_hash_get_digest_size(uint32_t algo, size_t *size)
 {
@@ -80,6 +81,31 @@ out:
 	return res;
 }
 
+/* Small enough to stay in the L1 data cache between copy and hash */
+#define HASH_COPY_CHUNK_SIZE	2048
+
+TEE_Result tee_hash_update_copy(void *ctx, uint32_t algo, void *dst,
+				const void *src, size_t len)
+{
+	uint8_t *d = dst;
+	const uint8_t *s = src;
+	TEE_Result res;
+	size_t l;
+
+	while (len) {
+		l = MIN(len, (size_t)HASH_COPY_CHUNK_SIZE);
+		memcpy(d, s, l);
+		res = crypto_hash_update(ctx, algo, d, l);
+		if (res)
+			return res;
+		d += l;
+		s += l;
+		len -= l;
+	}
+
+	return TEE_SUCCESS;
+}
+
 TEE_Result tee_mac_get_digest_size(uint32_t algo, size_t *size)
 {
 	switch (algo) {
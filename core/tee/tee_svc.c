@@ -517,6 +517,7 @@ static TEE_Result utee_param_to_param(struct user_ta_ctx *utc,
 			p->u[n].mem.mobj = &mobj_virt;
 			p->u[n].mem.offs = a;
 			p->u[n].mem.size = b;
+			p->u[n].mem.read_only = false;
 			if (tee_mmu_check_access_rights(utc, flags, a, b))
 				return TEE_ERROR_ACCESS_DENIED;
 			break;
@@ -550,11 +551,59 @@ static TEE_Result alloc_temp_sec_mem(size_t size, struct mobj **mobj,
 	return TEE_SUCCESS;
 }
 
+#ifdef CFG_PAGED_USER_TA
+/* Paged TA memory can't be mapped into another TA */
+static bool share_private_memref(struct user_ta_ctx *utc __unused,
+				 struct tee_ta_param *param __unused,
+				 size_t n __unused)
+{
+	return false;
+}
+#else
+/*
+ * A TA with TA_FLAG_SHARE_PRIVATE_MEMREF lets memrefs in its private
+ * memory be mapped directly into the called TA instead of being copied.
+ * Only memrefs covering complete pages are shared, so nothing else of
+ * the private memory is exposed. Input memrefs are mapped read-only. The
+ * calling TA instance is busy during the call, so the called TA has
+ * exclusive access to output memrefs. That doesn't hold for a
+ * TA_FLAG_CONCURRENT caller where other sessions may run meanwhile, its
+ * memrefs are always copied.
+ */
+static bool share_private_memref(struct user_ta_ctx *utc,
+				 struct tee_ta_param *param, size_t n)
+{
+	const size_t mask = CORE_MMU_USER_PARAM_SIZE - 1;
+	struct param_mem *mem = &param->u[n].mem;
+	struct mobj *mobj = NULL;
+	size_t offs = 0;
+
+	if (!(utc->ctx.flags & TA_FLAG_SHARE_PRIVATE_MEMREF) ||
+	    (utc->ctx.flags & TA_FLAG_CONCURRENT))
+		return false;
+	if ((mem->offs & mask) || (mem->size & mask))
+		return false;
+	if (tee_mmu_vbuf_to_mobj_offs(utc, (void *)mem->offs, mem->size,
+				      &mobj, &offs))
+		return false;
+	if ((offs + mobj_get_phys_offs(mobj, CORE_MMU_USER_PARAM_SIZE)) &
+	    mask)
+		return false;
+
+	mem->mobj = mobj;
+	mem->offs = offs;
+	mem->read_only = TEE_PARAM_TYPE_GET(param->types, n) ==
+			 TEE_PARAM_TYPE_MEMREF_INPUT;
+	return true;
+}
+#endif
+
 /*
  * TA invokes some TA with parameter.
  * If some parameters are memory references:
  * - either the memref is inside TA private RAM: TA is not allowed to expose
- *   its private RAM: use a temporary memory buffer and copy the data.
+ *   its private RAM: use a temporary memory buffer and copy the data,
+ *   unless the TA has opted in to share it, see share_private_memref().
  * - or the memref is not in the TA private RAM:
  *   - if the memref was mapped to the TA, TA is allowed to expose it.
  *   - if so, converts memref virtual address into a physical address.
@@ -614,6 +663,8 @@ static TEE_Result tee_svc_copy_param(struct tee_ta_session *sess,
 			}
 			/* uTA cannot expose its private memory */
 			if (tee_mmu_is_vbuf_inside_ta_private(utc, va, s)) {
+				if (share_private_memref(utc, param, n))
+					break;
 
 				s = ROUNDUP(s, sizeof(uint32_t));
 				if (ADD_OVERFLOW(req_mem, s, &req_mem))
@@ -627,6 +678,12 @@ static TEE_Result tee_svc_copy_param(struct tee_ta_session *sess,
 							&param->u[n].mem.offs);
 			if (res != TEE_SUCCESS)
 				return res;
+			/* The called TA must not write what the caller can't */
+			if (tee_mmu_check_access_rights(utc,
+					TEE_MEMORY_ACCESS_WRITE |
+					TEE_MEMORY_ACCESS_ANY_OWNER,
+					(uaddr_t)va, s))
+				param->u[n].mem.read_only = true;
 			break;
 		default:
 			break;
@@ -983,11 +983,93 @@ TEE_Result syscall_cryp_obj_get_attr(unsigned long obj, unsigned long attr_id,
 	return ops->to_user(attr, sess, buffer, size);
 }
 
+static void key_ctx_free(void *ctx, uint32_t algo)
+{
+	switch (TEE_ALG_GET_CLASS(algo)) {
+	case TEE_OPERATION_CIPHER:
+		crypto_cipher_free_ctx(ctx, algo);
+		break;
+	case TEE_OPERATION_MAC:
+		crypto_mac_free_ctx(ctx, algo);
+		break;
+	case TEE_OPERATION_AE:
+		crypto_authenc_free_ctx(ctx, algo);
+		break;
+	default:
+		assert(!ctx);
+	}
+}
+
+static TEE_Result key_ctx_alloc(uint32_t algo,
+				const struct tee_cryp_obj_secret *key,
+				void **ctx)
+{
+	const uint8_t *k = (const uint8_t *)(key + 1);
+	TEE_Result res;
+
+	*ctx = NULL;
+	switch (TEE_ALG_GET_CLASS(algo)) {
+	case TEE_OPERATION_CIPHER:
+		res = crypto_cipher_alloc_ctx(ctx, algo);
+		if (!res)
+			res = crypto_cipher_init_key_ctx(*ctx, algo, k,
+							 key->key_size);
+		break;
+	case TEE_OPERATION_MAC:
+		res = crypto_mac_alloc_ctx(ctx, algo);
+		if (!res)
+			res = crypto_mac_init(*ctx, algo, k, key->key_size);
+		break;
+	case TEE_OPERATION_AE:
+		res = crypto_authenc_alloc_ctx(ctx, algo);
+		if (!res)
+			res = crypto_authenc_init_key_ctx(*ctx, algo, k,
+							  key->key_size);
+		break;
+	default:
+		return TEE_ERROR_NOT_SUPPORTED;
+	}
+
+	if (res) {
+		key_ctx_free(*ctx, algo);
+		*ctx = NULL;
+	}
+	return res;
+}
+
+/*
+ * Returns a context for @algo holding the expanded key of the secret
+ * value object @o, or NULL if @algo can't use a cached key. The context
+ * is created on first use and kept until the attributes of @o are
+ * cleared or freed. A failure to create the context is remembered too so
+ * that the key schedule isn't attempted twice for each operation.
+ */
+static const void *tee_obj_key_ctx_get(struct tee_obj *o, uint32_t algo)
+{
+	if (o->key_ctx_algo != algo) {
+		tee_obj_key_ctx_free(o);
+		if (key_ctx_alloc(algo, o->attr, &o->key_ctx))
+			o->key_ctx = NULL;
+		o->key_ctx_algo = algo;
+	}
+
+	return o->key_ctx;
+}
+
+void tee_obj_key_ctx_free(struct tee_obj *o)
+{
+	key_ctx_free(o->key_ctx, o->key_ctx_algo);
+	o->key_ctx = NULL;
+	o->key_ctx_algo = 0;
+}
+
 void tee_obj_attr_free(struct tee_obj *o)
 {
 	const struct tee_cryp_obj_type_props *tp;
 	size_t n;
 
+	tee_obj_key_ctx_free(o);
+
 	if (!o->attr)
 		return;
 	tp = tee_svc_find_type_props(o->info.objectType);
@@ -1006,6 +1088,8 @@ void tee_obj_attr_clear(struct tee_obj *o)
 	const struct tee_cryp_obj_type_props *tp;
 	size_t n;
 
+	tee_obj_key_ctx_free(o);
+
 	if (!o->attr)
 		return;
 	tp = tee_svc_find_type_props(o->info.objectType);
@@ -1592,6 +1676,7 @@ TEE_Result syscall_cryp_obj_populate(unsigned long obj,
 	if (res != TEE_SUCCESS)
 		goto out;
 
+	tee_obj_key_ctx_free(o);
 	res = tee_svc_cryp_obj_populate_type(o, type_props, attrs, attr_count);
 	if (res == TEE_SUCCESS)
 		o->info.handleFlags |= TEE_HANDLE_FLAG_INITIALIZED;
@@ -2232,6 +2317,7 @@ TEE_Result syscall_hash_init(unsigned long state,
 		{
 			struct tee_obj *o;
 			struct tee_cryp_obj_secret *key;
+			const void *key_ctx;
 
 			res = tee_obj_get(to_user_ta_ctx(sess->ctx),
 					  cs->key1, &o);
@@ -2241,6 +2327,13 @@ TEE_Result syscall_hash_init(unsigned long state,
 			     TEE_HANDLE_FLAG_INITIALIZED) == 0)
 				return TEE_ERROR_BAD_PARAMETERS;
 
+			key_ctx = tee_obj_key_ctx_get(o, cs->algo);
+			if (key_ctx) {
+				crypto_mac_copy_state(cs->ctx, (void *)key_ctx,
+						      cs->algo);
+				break;
+			}
+
 			key = (struct tee_cryp_obj_secret *)o->attr;
 			res = crypto_mac_init(cs->ctx, cs->algo,
 					      (void *)(key + 1), key->key_size);
@@ -2403,6 +2496,7 @@ TEE_Result syscall_cipher_init(unsigned long state, const void *iv,
 	struct tee_cryp_state *cs;
 	struct tee_ta_session *sess;
 	struct tee_obj *o;
+	struct tee_obj *o1;
 	struct tee_cryp_obj_secret *key1;
 	struct user_ta_ctx *utc;
 
@@ -2429,6 +2523,7 @@ TEE_Result syscall_cipher_init(unsigned long state, const void *iv,
 		return TEE_ERROR_BAD_PARAMETERS;
 
 	key1 = o->attr;
+	o1 = o;
 
 	if (tee_obj_get(utc, cs->key2, &o) == TEE_SUCCESS) {
 		struct tee_cryp_obj_secret *key2 = o->attr;
@@ -2441,9 +2536,17 @@ TEE_Result syscall_cipher_init(unsigned long state, const void *iv,
 					 (uint8_t *)(key2 + 1), key2->key_size,
 					 iv, iv_len);
 	} else {
-		res = crypto_cipher_init(cs->ctx, cs->algo, cs->mode,
-					 (uint8_t *)(key1 + 1), key1->key_size,
-					 NULL, 0, iv, iv_len);
+		const void *key_ctx = tee_obj_key_ctx_get(o1, cs->algo);
+
+		if (key_ctx)
+			res = crypto_cipher_init_from_key_ctx(cs->ctx, cs->algo,
+							      cs->mode, key_ctx,
+							      iv, iv_len);
+		else
+			res = crypto_cipher_init(cs->ctx, cs->algo, cs->mode,
+						 (uint8_t *)(key1 + 1),
+						 key1->key_size, NULL, 0, iv,
+						 iv_len);
 	}
 	if (res != TEE_SUCCESS)
 		return res;
@@ -2952,6 +3055,7 @@ TEE_Result syscall_authenc_init(unsigned long state, const void *nonce,
 	struct tee_ta_session *sess;
 	struct tee_obj *o;
 	struct tee_cryp_obj_secret *key;
+	const void *key_ctx;
 
 	res = tee_ta_get_current_session(&sess);
 	if (res != TEE_SUCCESS)
@@ -2974,11 +3078,20 @@ TEE_Result syscall_authenc_init(unsigned long state, const void *nonce,
 	if ((o->info.handleFlags & TEE_HANDLE_FLAG_INITIALIZED) == 0)
 		return TEE_ERROR_BAD_PARAMETERS;
 
-	key = o->attr;
-	res = crypto_authenc_init(cs->ctx, cs->algo, cs->mode,
-				  (uint8_t *)(key + 1), key->key_size,
-				  nonce, nonce_len, tag_len, aad_len,
-				  payload_len);
+	key_ctx = tee_obj_key_ctx_get(o, cs->algo);
+	if (key_ctx) {
+		res = crypto_authenc_init_from_key_ctx(cs->ctx, cs->algo,
+						       cs->mode, key_ctx,
+						       nonce, nonce_len,
+						       tag_len, aad_len,
+						       payload_len);
+	} else {
+		key = o->attr;
+		res = crypto_authenc_init(cs->ctx, cs->algo, cs->mode,
+					  (uint8_t *)(key + 1), key->key_size,
+					  nonce, nonce_len, tag_len, aad_len,
+					  payload_len);
+	}
 	if (res != TEE_SUCCESS)
 		return res;
 
@@ -3224,6 +3337,94 @@ out:
 	return res;
 }
 
+static TEE_Result cryp_batch_do_op(const struct utee_cryp_op *op,
+				   uint64_t *dst_len)
+{
+	const void *src = (const void *)(vaddr_t)op->src;
+	void *dst = (void *)(vaddr_t)op->dst;
+	size_t src_len = op->src_len;
+
+	/*
+	 * The fields are 64-bit also for a 32-bit TA, values which don't
+	 * fit would be truncated before the access rights are checked.
+	 */
+	if ((vaddr_t)src != op->src || (vaddr_t)dst != op->dst ||
+	    src_len != op->src_len || (unsigned long)op->state != op->state)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	/*
+	 * dst_len points into the user supplied array of operations so the
+	 * single operation syscalls read and update it in place.
+	 */
+	switch (op->op) {
+	case UTEE_CRYP_OP_HASH_UPDATE:
+		return syscall_hash_update(op->state, src, src_len);
+	case UTEE_CRYP_OP_HASH_FINAL:
+		return syscall_hash_final(op->state, src, src_len, dst,
+					  dst_len);
+	case UTEE_CRYP_OP_CIPHER_UPDATE:
+		return syscall_cipher_update(op->state, src, src_len, dst,
+					     dst_len);
+	case UTEE_CRYP_OP_CIPHER_FINAL:
+		return syscall_cipher_final(op->state, src, src_len, dst,
+					    dst_len);
+	case UTEE_CRYP_OP_AUTHENC_UPDATE_AAD:
+		return syscall_authenc_update_aad(op->state, src, src_len);
+	case UTEE_CRYP_OP_AUTHENC_UPDATE_PAYLOAD:
+		return syscall_authenc_update_payload(op->state, src, src_len,
+						      dst, dst_len);
+	default:
+		return TEE_ERROR_BAD_PARAMETERS;
+	}
+}
+
+TEE_Result syscall_cryp_batch(struct utee_cryp_op *ops, unsigned long num_ops)
+{
+	TEE_Result res;
+	TEE_Result res2;
+	struct tee_ta_session *sess;
+	struct utee_cryp_op op;
+	size_t ops_size;
+	size_t n;
+
+	res = tee_ta_get_current_session(&sess);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	if (MUL_OVERFLOW(num_ops, sizeof(*ops), &ops_size))
+		return TEE_ERROR_OVERFLOW;
+
+	res = tee_mmu_check_access_rights(to_user_ta_ctx(sess->ctx),
+					  TEE_MEMORY_ACCESS_READ |
+					  TEE_MEMORY_ACCESS_WRITE |
+					  TEE_MEMORY_ACCESS_ANY_OWNER,
+					  (uaddr_t)ops, ops_size);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	for (n = 0; n < num_ops; n++) {
+		/*
+		 * Work on a private copy of the descriptor, the TA may
+		 * modify the array concurrently from another thread.
+		 */
+		res = tee_svc_copy_from_user(&op, ops + n, sizeof(op));
+		if (res != TEE_SUCCESS)
+			return res;
+
+		res = cryp_batch_do_op(&op, &ops[n].dst_len);
+
+		op.ret = res;
+		res2 = tee_svc_copy_to_user(&ops[n].ret, &op.ret,
+					    sizeof(op.ret));
+		if (res2 != TEE_SUCCESS)
+			return res2;
+		if (res != TEE_SUCCESS)
+			return res;
+	}
+
+	return TEE_SUCCESS;
+}
+
 static int pkcs1_get_salt_len(const TEE_Attribute *params, uint32_t num_params,
 			      size_t default_len)
 {
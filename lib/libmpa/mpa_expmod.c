@@ -10,22 +10,21 @@
 		*b = tmp; \
 	} while (0)
 
-/*------------------------------------------------------------
- *
- *  mpa_exp_mod
- *
- *  Calculates dest = op1 ^ op2 mod n
+/*
+ * Calculates dest = op1 ^ op2 mod n
  *
  * This function uses the Montgomery ladder concept as proposed by Marc Joye and
  * Sun-Ming Yen, which makes the function more resistant to timing attacks.
+ * Used for small exponents or if there's not enough memory for the table
+ * of exp_mod_window().
  */
-void mpa_exp_mod(mpanum dest,
-		 const mpanum op1,
-		 const mpanum op2,
-		 const mpanum n,
-		 const mpanum r_modn,
-		 const mpanum r2_modn,
-		 const mpa_word_t n_inv, mpa_scratch_mem pool)
+static void exp_mod_ladder(mpanum dest,
+			   const mpanum op1,
+			   const mpanum op2,
+			   const mpanum n,
+			   const mpanum r_modn,
+			   const mpanum r2_modn,
+			   const mpa_word_t n_inv, mpa_scratch_mem pool)
 {
 	mpanum A;
 	mpanum tmp_a;
@@ -96,3 +95,211 @@ void mpa_exp_mod(mpanum dest,
 	mpa_free_static_temp_var(&xtilde, pool);
 	mpa_free_static_temp_var(&tmp_xtilde, pool);
 }
+
+/*
+ * Largest window used by exp_mod_window(), the table holds 1 << k
+ * Montgomery representations of numbers of the size of the modulus.
+ */
+#define EXP_MOD_MAX_WINDOW_BITS		6
+
+/*
+ * get_window_bits() - Select the window size for an exponent
+ *
+ * A window of k bits costs 2^k - 2 multiplications to build the table
+ * and then one multiplication per k bits of exponent (the squarings are
+ * the same for all window sizes). Each limit below is the exponent size
+ * where the next larger window becomes cheaper. A window of one bit
+ * means that the ladder is used instead.
+ */
+static int get_window_bits(int exp_bits)
+{
+	static const int limits[EXP_MOD_MAX_WINDOW_BITS - 1] = {
+		4, 24, 96, 320, 960
+	};
+	int k = 1;
+
+	while (k < EXP_MOD_MAX_WINDOW_BITS && exp_bits > limits[k - 1])
+		k++;
+	return k;
+}
+
+/* Returns the k bits of op2 starting at bit idx */
+static uint32_t get_window(const mpanum op2, int exp_bits, int idx, int k)
+{
+	uint32_t w = 0;
+	int b;
+
+	for (b = idx + k - 1; b >= idx; b--) {
+		w <<= 1;
+		if (b < exp_bits)
+			w |= mpa_get_bit(op2, b);
+	}
+	return w;
+}
+
+static mpanum get_entry(uint32_t *table, size_t entry_u32, uint32_t idx)
+{
+	return (mpanum)(void *)(table + idx * entry_u32);
+}
+
+/*
+ * select_entry() - Copies entry w of the table into dest
+ *
+ * All words of all entries are read and combined with a mask so that
+ * neither the memory access pattern nor the branches depend on w, which
+ * is a part of the secret exponent. This makes the selection independent
+ * of how the table is laid out in cache lines.
+ *
+ * dest always gets the size of the modulus, even if its most significant
+ * words are zero, since normalizing it would take a number of steps
+ * depending on the selected entry. __mpa_montgomery_mul() accepts such
+ * operands.
+ */
+static void select_entry(mpanum dest, uint32_t *table, size_t entry_u32,
+			 uint32_t num_entries, mpa_usize_t size, uint32_t w)
+{
+	mpanum entry;
+	mpa_word_t mask;
+	mpa_usize_t j;
+	uint32_t i;
+
+	for (j = 0; j < size; j++)
+		dest->d[j] = 0;
+
+	for (i = 0; i < num_entries; i++) {
+		entry = get_entry(table, entry_u32, i);
+		/* All ones if i == w, else zero */
+		mask = 0 - (((i ^ w) - 1) >> (WORD_SIZE - 1));
+		for (j = 0; j < size; j++)
+			dest->d[j] |= entry->d[j] & mask;
+	}
+
+	dest->size = size;
+}
+
+/*
+ * Fixed window exponentiation, each window of k bits of the exponent
+ * costs k squarings and one multiplication regardless of its value.
+ *
+ * Returns false without touching dest if the table can't be allocated.
+ */
+static bool exp_mod_window(mpanum dest,
+			   const mpanum op1,
+			   const mpanum op2,
+			   int exp_bits, int k,
+			   const mpanum n,
+			   const mpanum r_modn,
+			   const mpanum r2_modn,
+			   const mpa_word_t n_inv, mpa_scratch_mem pool)
+{
+	mpa_usize_t size = __mpanum_size(n);
+	uint32_t num_entries = 1 << k;
+	size_t entry_u32;
+	uint32_t *table;
+	bool ret = false;
+	mpanum A;
+	mpanum tmp_a;
+	mpanum power;
+	mpanum *ptr_a;
+	mpanum *ptr_tmp_a;
+	uint32_t i;
+	int idx;
+	int b;
+
+	mpa_alloc_static_temp_var(&A, pool);
+	mpa_alloc_static_temp_var(&tmp_a, pool);
+	mpa_alloc_static_temp_var(&power, pool);
+
+	/*
+	 * Entries are destinations of __mpa_montgomery_mul() which needs
+	 * room for intermediate results a bit larger than n * 2^WORD_SIZE.
+	 */
+	entry_u32 = mpa_StaticVarSizeInU32((size + 2) * WORD_SIZE);
+	/* Not an error if the pool is too small, the caller falls back */
+	table = mempool_try_alloc(pool->pool,
+				  num_entries * entry_u32 * sizeof(uint32_t));
+	if (!table)
+		goto out;
+
+	/* table[i] = op1^i in Montgomery space */
+	for (i = 0; i < num_entries; i++)
+		mpa_init_static(get_entry(table, entry_u32, i), entry_u32);
+	mpa_copy(get_entry(table, entry_u32, 0), r_modn);
+	__mpa_set_unused_digits_to_zero(get_entry(table, entry_u32, 0));
+	__mpa_montgomery_mul(get_entry(table, entry_u32, 1), op1, r2_modn, n,
+			     n_inv);
+	for (i = 2; i < num_entries; i++)
+		__mpa_montgomery_mul(get_entry(table, entry_u32, i),
+				     get_entry(table, entry_u32, i - 1),
+				     get_entry(table, entry_u32, 1), n, n_inv);
+
+	ptr_a = &A;
+	ptr_tmp_a = &tmp_a;
+
+	/* Windows are aligned to bit 0, the topmost may be partial */
+	idx = ((exp_bits + k - 1) / k - 1) * k;
+	select_entry(*ptr_a, table, entry_u32, num_entries, size,
+		     get_window(op2, exp_bits, idx, k));
+
+	while (idx > 0) {
+		idx -= k;
+
+		for (b = 0; b < k; b++) {
+			__mpa_montgomery_mul(*ptr_tmp_a, *ptr_a, *ptr_a, n,
+					     n_inv);
+			swp(&ptr_tmp_a, &ptr_a);
+		}
+
+		select_entry(power, table, entry_u32, num_entries, size,
+			     get_window(op2, exp_bits, idx, k));
+		__mpa_montgomery_mul(*ptr_tmp_a, *ptr_a, power, n, n_inv);
+		swp(&ptr_tmp_a, &ptr_a);
+	}
+
+	/* Transform back from Montgomery space */
+	__mpa_montgomery_mul(*ptr_tmp_a, (const mpanum)&const_one, *ptr_a,
+			     n, n_inv);
+
+	mpa_copy(dest, *ptr_tmp_a);
+	/* Done with the secret dependent part, normalize the result */
+	while (dest->size > 0 && !dest->d[dest->size - 1])
+		dest->size--;
+
+	mempool_free(pool->pool, table);
+	ret = true;
+out:
+	mpa_free_static_temp_var(&power, pool);
+	mpa_free_static_temp_var(&tmp_a, pool);
+	mpa_free_static_temp_var(&A, pool);
+	return ret;
+}
+
+/*------------------------------------------------------------
+ *
+ *  mpa_exp_mod
+ *
+ *  Calculates dest = op1 ^ op2 mod n
+ *
+ * Uses fixed window exponentiation with a window size depending on the
+ * size of the exponent. The sequence of operations and memory accesses
+ * only depends on the number of bits in the exponent, not on their values.
+ */
+void mpa_exp_mod(mpanum dest,
+		 const mpanum op1,
+		 const mpanum op2,
+		 const mpanum n,
+		 const mpanum r_modn,
+		 const mpanum r2_modn,
+		 const mpa_word_t n_inv, mpa_scratch_mem pool)
+{
+	int exp_bits = mpa_highest_bit_index(op2) + 1;
+	int k;
+
+	/* Try smaller windows if the pool is too small for the table */
+	for (k = get_window_bits(exp_bits); k > 1; k--)
+		if (exp_mod_window(dest, op1, op2, exp_bits, k, n, r_modn,
+				   r2_modn, n_inv, pool))
+			return;
+
+	exp_mod_ladder(dest, op1, op2, n, r_modn, r2_modn, n_inv, pool);
+}
@@ -2,6 +2,7 @@
 /*
  * Copyright (c) 2014, STMicroelectronics International N.V.
  */
+#include <compiler.h>
 #include "mpa.h"
 
 /*************************************************************
@@ -102,6 +103,66 @@ void __mpa_montgomery_sub_ack(mpanum dest, mpanum src)
 
 #endif /* USE_ARM_ASM */
 
+#if defined(ARM64)
+/*
+ * On AArch64 the multiplication is done with 64-bit limbs by
+ * __mpa_montgomery_mul_a64(). This gives the same result as the generic
+ * code below since R = 2^(WORD_SIZE * n->size) is unchanged as long as
+ * n->size is even.
+ */
+uint64_t __mpa_montgomery_mul_a64(mpa_word_t *t, const mpa_word_t *a,
+				  const mpa_word_t *b, const mpa_word_t *n,
+				  uint64_t n_inv, size_t m);
+
+static bool a64_operand_ok(const mpanum op, mpa_usize_t size)
+{
+	mpa_usize_t idx;
+
+	if (__mpanum_sign(op) == MPA_NEG_SIGN || op->alloc < (mpa_asize_t)size)
+		return false;
+	for (idx = op->size; idx < size; idx++)
+		if (op->d[idx])
+			return false;
+	return true;
+}
+
+static bool a64_montgomery_mul(mpanum dest, mpanum op1, mpanum op2,
+			       mpanum n, mpa_word_t n_inv)
+{
+	mpa_usize_t size = n->size;
+	uint64_t n_inv64;
+	uint64_t x;
+	uint64_t n0;
+
+	if (!size || (size & 1) || !a64_operand_ok(op1, size) ||
+	    !a64_operand_ok(op2, size))
+		return false;
+
+	/*
+	 * n_inv is -n^(-1) mod 2^32, lift it to -n^(-1) mod 2^64 with a
+	 * Newton step.
+	 */
+	n0 = n->d[0] | ((uint64_t)n->d[1] << 32);
+	x = (mpa_word_t)(0 - n_inv);
+	x *= 2 - n0 * x;
+	n_inv64 = 0 - x;
+
+	dest->d[size] = __mpa_montgomery_mul_a64(dest->d, op1->d, op2->d,
+						 n->d, n_inv64, size / 2);
+	dest->size = size + 1;
+	while (dest->size && !dest->d[dest->size - 1])
+		dest->size--;
+	return true;
+}
+#else
+static bool a64_montgomery_mul(mpanum dest __unused, mpanum op1 __unused,
+			       mpanum op2 __unused, mpanum n __unused,
+			       mpa_word_t n_inv __unused)
+{
+	return false;
+}
+#endif
+
 /*------------------------------------------------------------
  *
  *  __mpa_montgomery_mul
@@ -119,6 +180,9 @@ void __mpa_montgomery_mul(mpanum dest, mpanum op1, mpanum op2, mpanum n,
 	/* set dest to zero (with all unused digits to zero as well) */
 	mpa_wipe(dest);
 
+	if (a64_montgomery_mul(dest, op1, op2, n, n_inv))
+		goto reduce;
+
 	for (idx = 0; idx < n->size; idx++) {
 		u = (dest->d[0] +
 		     __mpanum_get_word(idx, op1) *
@@ -135,6 +199,7 @@ void __mpa_montgomery_mul(mpanum dest, mpanum op1, mpanum op2, mpanum n,
 		*(dest->d + dest->size) = 0;	/* set unused digit to zero. */
 	}
 
+reduce:
 	/* check if dest > n, if so set dest = dest - n */
 	if (__mpa_abs_cmp(dest, n) >= 0)
 		__mpa_montgomery_sub_ack(dest, n);
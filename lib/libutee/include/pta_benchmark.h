@@ -23,4 +23,19 @@
 #define BENCHMARK_CMD_GET_MEMREF		BENCHMARK_CMD(2)
 #define BENCHMARK_CMD_UNREGISTER		BENCHMARK_CMD(3)
 
+/*
+ * Get the time spent loading user TAs, accumulated since boot or last
+ * reset, all times in microseconds
+ *
+ * [in/out] value[0].a	In: non-zero to reset after reading
+ *			Out: number of TAs loaded
+ * [out]    value[1].a	Fetching the binaries over RPC
+ * [out]    value[1].b	Verifying the signed headers
+ * [out]    value[2].a	Copying and hashing the binaries
+ * [out]    value[2].b	Processing relocations
+ * [out]    value[3].a	Mapping segments and setting memory protection
+ * [out]    value[3].b	Total time loading the TAs
+ */
+#define BENCHMARK_CMD_GET_TA_LOAD_STATS		BENCHMARK_CMD(4)
+
 #endif /* __PTA_BENCHMARK_H */
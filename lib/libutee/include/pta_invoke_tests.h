@@ -63,9 +63,30 @@
  * [in]  value[0].b	delay number
  * [out] value[1].a	before lock concurency
  * [out] value[1].b	during lock concurency
+ *
+ * The stress tests run a short critical section value[0].b times.
+ * PTA_MUTEX_TEST_STRESS_SHARED locks a mutex shared by all callers,
+ * PTA_MUTEX_TEST_STRESS_SESSION looks up the session of the caller as
+ * each invoke from normal world does. Invoked from several threads
+ * concurrently, each with a session of its own, they compare contention
+ * on the session manager with a plain shared mutex.
+ * [out] value[1].a	number of times the shared mutex was contended
+ * [out] value[1].b	elapsed time in microseconds
+ *
+ * The writer preference test is run by invoking PTA_MUTEX_TEST_PREF_*
+ * from three threads at once. The first reader holds a read lock until
+ * the writer waits for the mutex and the second reader asks for a read
+ * lock, value[0].b is a delay before unlocking. The second reader fails
+ * with TEE_ERROR_BAD_STATE if it gets the mutex before the writer.
+ * TEE_ERROR_BUSY is returned if the other threads don't show up.
  */
 #define PTA_MUTEX_TEST_WRITER			0
 #define PTA_MUTEX_TEST_READER			1
+#define PTA_MUTEX_TEST_STRESS_SHARED		2
+#define PTA_MUTEX_TEST_STRESS_SESSION		3
+#define PTA_MUTEX_TEST_PREF_READER1		4
+#define PTA_MUTEX_TEST_PREF_WRITER		5
+#define PTA_MUTEX_TEST_PREF_READER2		6
 #define PTA_INVOKE_TESTS_CMD_MUTEX		7
 
 /*
@@ -73,5 +94,81 @@
  */
 #define PTA_INVOKE_TESTS_CMD_LOCKDEP		8
 
+/*
+ * AES-GCM performance of core users
+ *
+ * [in]     value[0].a	    Use case, PTA_INVOKE_TESTS_AES_GCM_PERF_*
+ * [in]     value[0].b	    Number of 4 KiB buffers to process
+ * [out]    value[1].a	    Nanoseconds per byte * 100
+ * [out]    value[1].b	    Elapsed time in microseconds
+ */
+#define PTA_INVOKE_TESTS_CMD_AES_GCM_PERF	9
+
+/* Pager: encryption and decryption of a page with a pre-expanded key */
+#define PTA_INVOKE_TESTS_AES_GCM_PERF_PAGER	0
+/* Secure storage: one 4 KiB block with authenticated data per operation */
+#define PTA_INVOKE_TESTS_AES_GCM_PERF_SECSTOR	1
+/* TA: a 4 KiB payload fed in 256 byte updates as TEE_AEUpdate() would */
+#define PTA_INVOKE_TESTS_AES_GCM_PERF_TA	2
+
+/*
+ * RSA private key operation performance
+ *
+ * [in]     value[0].a	    Key size in bits, 2048 or 4096
+ * [in]     value[0].b	    Number of iterations
+ * [out]    value[1].a	    Thousands of cycles per operation
+ * [out]    value[1].b	    Microseconds per operation
+ */
+#define PTA_INVOKE_TESTS_CMD_RSA_PERF		10
+
+/*
+ * Handle database performance, handles are released and allocated while
+ * a number of other handles are kept allocated
+ *
+ * [in]     value[0].a	    Number of handles kept allocated
+ * [in]     value[0].b	    Number of iterations
+ * [out]    value[1].a	    Nanoseconds per handle_get() and handle_put()
+ * [out]    value[1].b	    Elapsed time in microseconds
+ */
+#define PTA_INVOKE_TESTS_CMD_HANDLE_PERF	11
+
+/*
+ * TA image cache: preloads, loads and releases a TA and checks that it's
+ * evicted once the last pin is dropped
+ *
+ * [in]     memref[0]	    UUID of the TA, in octet format
+ */
+#define PTA_INVOKE_TESTS_CMD_TA_IMAGE_CACHE	12
+
+/*
+ * AES-GCM known answer tests, including payloads which aren't a multiple
+ * of four blocks and partial final blocks
+ */
+#define PTA_INVOKE_TESTS_CMD_AES_GCM		13
+
+/*
+ * Checks libmpa Montgomery multiplication over several operand sizes,
+ * only supported when libmpa is used by the core
+ */
+#define PTA_INVOKE_TESTS_CMD_MPA		14
+
+/*
+ * Allocates, sends, retrieves and frees asynchronous notification values
+ * through the system pseudo TA, only supported with CFG_CORE_ASYNC_NOTIF=y
+ * and CFG_SYSTEM_PTA=y
+ */
+#define PTA_INVOKE_TESTS_CMD_NOTIF		15
+
+/*
+ * Checks parsing of the messages from normal world: the entries of
+ * OPTEE_MSG_CMD_INVOKE_BATCH including malformed batches, and lists of
+ * page runs of OPTEE_MSG_ATTR_NONCONTIG buffers which are registered and
+ * mapped, with block entries where possible
+ *
+ * [in/out] memref[0]	    Physically contiguous buffer of at least five
+ *			    pages, the page lists are written in it
+ */
+#define PTA_INVOKE_TESTS_CMD_MSG_PARAM		16
+
 #endif /*__PTA_INVOKE_TESTS_H*/
 
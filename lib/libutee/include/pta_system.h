@@ -23,4 +23,31 @@
  */
 #define PTA_SYSTEM_ADD_RNG_ENTROPY	0
 
+/*
+ * Allocate a value for asynchronous notifications to normal world. The
+ * TA passes the value to its normal world client which waits for
+ * notifications with that value. The value is freed when the session is
+ * closed. A session can hold at most 4 values, TEE_ERROR_OUT_OF_MEMORY is
+ * returned beyond that or when no value is left. Not supported unless the
+ * core is built with CFG_CORE_ASYNC_NOTIF=y.
+ *
+ * [out]    value[0].a: notification value
+ */
+#define PTA_SYSTEM_NOTIF_ALLOC		1
+
+/*
+ * Free a value from PTA_SYSTEM_NOTIF_ALLOC
+ *
+ * [in]     value[0].a: notification value
+ */
+#define PTA_SYSTEM_NOTIF_FREE		2
+
+/*
+ * Send an asynchronous notification to normal world, without waiting
+ * for it to be received
+ *
+ * [in]     value[0].a: notification value from PTA_SYSTEM_NOTIF_ALLOC
+ */
+#define PTA_SYSTEM_NOTIF_SEND		3
+
 #endif /* __PTA_SYSTEM_H */
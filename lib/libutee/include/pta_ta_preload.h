@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2019, Linaro Limited
+ */
+
+/*
+ * Preload user TAs into the TA image cache so the first session opened
+ * to them doesn't have to fetch and verify the binary.
+ *
+ * Sessions can only be opened by TAs and by clients in the REE kernel,
+ * that is with the TEE_LOGIN_REE_KERNEL login method. Other clients get
+ * TEE_ERROR_ACCESS_DENIED.
+ */
+
+#ifndef __PTA_TA_PRELOAD_H
+#define __PTA_TA_PRELOAD_H
+
+#define PTA_TA_PRELOAD_UUID { 0xf48e9ba4, 0xbae8, 0x4aa7, \
+		{ 0xa2, 0x08, 0x2f, 0x34, 0x5f, 0x8d, 0x99, 0x01 } }
+
+/*
+ * Load, verify and pin TAs in the TA image cache
+ *
+ * [in]      memref[0]        Array of TA UUIDs in octet format, or
+ *                            TEE_PARAM_TYPE_NONE to preload the TAs listed
+ *                            in the "ta-uuids" property of the
+ *                            "linaro,optee-ta-preload" node of the secure
+ *                            device tree
+ *
+ * Return codes:
+ * TEE_SUCCESS - All TAs were preloaded
+ * TEE_ERROR_BAD_PARAMETERS - Incorrect input param
+ * TEE_ERROR_OUT_OF_MEMORY - The part of the TA image cache which can be
+ *                           pinned is too small
+ * Any error from loading a TA, remaining TAs aren't preloaded
+ */
+#define PTA_TA_PRELOAD_CMD_PRELOAD	0x0
+
+/*
+ * Unpin previously preloaded TAs, a TA which has been preloaded several
+ * times stays pinned until it has been released as many times. Unpinned
+ * TAs may be evicted from the TA image cache again.
+ *
+ * [in]      memref[0]        Array of TA UUIDs in octet format, or
+ *                            TEE_PARAM_TYPE_NONE for the TAs listed in the
+ *                            secure device tree
+ */
+#define PTA_TA_PRELOAD_CMD_RELEASE	0x1
+
+#endif /* __PTA_TA_PRELOAD_H */
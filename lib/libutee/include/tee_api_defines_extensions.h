@@ -62,6 +62,11 @@
 
 #define TEE_ALG_RSASSA_PKCS1_V1_5	0xF0000830
 
+/*
+ * Implementation-specific login method, the client is in the REE kernel
+ */
+#define TEE_LOGIN_REE_KERNEL	0x80000000
+
 /*
  * Implementation-specific object storage constants
  */
@@ -89,4 +94,16 @@
 #define TEE_MEMORY_ACCESS_NONSECURE          0x10000000
 #define TEE_MEMORY_ACCESS_SECURE             0x20000000
 
+/*
+ * Operation identifiers for TEE_CrypBatch(), each one is equivalent to the
+ * GP function with the corresponding name.
+ */
+#define TEE_CRYP_BATCH_DIGEST_UPDATE		0
+#define TEE_CRYP_BATCH_DIGEST_DO_FINAL		1
+#define TEE_CRYP_BATCH_MAC_UPDATE		2
+#define TEE_CRYP_BATCH_MAC_COMPUTE_FINAL	3
+#define TEE_CRYP_BATCH_CIPHER_UPDATE		4
+#define TEE_CRYP_BATCH_AE_UPDATE_AAD		5
+#define TEE_CRYP_BATCH_AE_UPDATE		6
+
 #endif /* TEE_API_DEFINES_EXTENSIONS_H */
@@ -34,4 +34,34 @@ TEE_Result TEE_CacheClean(char *buf, size_t len);
 TEE_Result TEE_CacheFlush(char *buf, size_t len);
 TEE_Result TEE_CacheInvalidate(char *buf, size_t len);
 
+/*
+ * Batched cryptographic operations
+ *
+ * TEE_CrypBatch() performs numEntries operations on already initialized
+ * operation handles using as few calls into the TEE Core as possible.
+ * Each entry behaves as the GP function selected by @op
+ * (TEE_CRYP_BATCH_*), with @src/@srcLen as input and @dest/@destLen as
+ * output where applicable. The result of each entry is stored in @res.
+ *
+ * Entries are processed in order and each entry is checked against the
+ * state the operation has after the preceding entries, so for instance a
+ * TEE_CRYP_BATCH_MAC_UPDATE following a TEE_CRYP_BATCH_MAC_COMPUTE_FINAL
+ * on the same operation panics the TA as TEE_MACUpdate() would.
+ * Processing stops at the first entry that returns TEE_ERROR_SHORT_BUFFER,
+ * in which case @destLen of that entry is updated with the required size
+ * and TEE_ERROR_SHORT_BUFFER is returned. Other errors panic the TA as the
+ * GP functions do.
+ */
+typedef struct {
+	TEE_OperationHandle operation;
+	uint32_t op;
+	const void *src;
+	uint32_t srcLen;
+	void *dest;
+	uint32_t destLen;
+	TEE_Result res;
+} TEE_CrypBatchEntry;
+
+TEE_Result TEE_CrypBatch(TEE_CrypBatchEntry *entries, uint32_t numEntries);
+
 #endif
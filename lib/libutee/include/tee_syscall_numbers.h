@@ -79,8 +79,9 @@
 #define TEE_SCN_SE_CHANNEL_CLOSE__DEPRECATED		69
 /* End of deprecated Secure Element API syscalls */
 #define TEE_SCN_CACHE_OPERATION			70
+#define TEE_SCN_CRYP_BATCH			71
 
-#define TEE_SCN_MAX				70
+#define TEE_SCN_MAX				71
 
 /* Maximum number of allowed arguments for a syscall */
 #define TEE_SVC_MAX_ARGS			8
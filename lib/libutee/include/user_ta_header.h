@@ -24,8 +24,14 @@
 	 */
 #define TA_FLAG_CONCURRENT		(1 << 8)
 #define TA_FLAG_DEVICE_ENUM		(1 << 9) /* device enumeration */
+	/*
+	 * Page aligned memrefs in the TA private memory are mapped into the
+	 * called TA instead of being copied when invoking another TA.
+	 * Ignored together with TA_FLAG_CONCURRENT.
+	 */
+#define TA_FLAG_SHARE_PRIVATE_MEMREF	(1 << 10)
 
-#define TA_FLAGS_MASK			GENMASK_32(9, 0)
+#define TA_FLAGS_MASK			GENMASK_32(10, 0)
 
 union ta_head_func_ptr {
 	uint64_t ptr64;
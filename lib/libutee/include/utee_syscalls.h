@@ -139,6 +139,13 @@ TEE_Result utee_authenc_dec_final(unsigned long state, const void *src_data,
 			size_t src_len, void *dest_data, uint64_t *dest_len,
 			const void *tag, size_t tag_len);
 
+/*
+ * Executes num_ops operations described by ops in a single call, see
+ * struct utee_cryp_op. Processing stops at the first operation which
+ * doesn't succeed and its result is returned.
+ */
+TEE_Result utee_cryp_batch(struct utee_cryp_op *ops, unsigned long num_ops);
+
 TEE_Result utee_asymm_operate(unsigned long state,
 			const struct utee_attribute *params,
 			unsigned long num_params, const void *src_data,
@@ -47,4 +47,27 @@ struct utee_attribute {
 	uint32_t attribute_id;
 };
 
+/*
+ * Operations accepted by utee_cryp_batch(), each one is equivalent to the
+ * syscall with the corresponding name.
+ */
+enum utee_cryp_op_type {
+	UTEE_CRYP_OP_HASH_UPDATE = 0,
+	UTEE_CRYP_OP_HASH_FINAL,
+	UTEE_CRYP_OP_CIPHER_UPDATE,
+	UTEE_CRYP_OP_CIPHER_FINAL,
+	UTEE_CRYP_OP_AUTHENC_UPDATE_AAD,
+	UTEE_CRYP_OP_AUTHENC_UPDATE_PAYLOAD,
+};
+
+struct utee_cryp_op {
+	uint64_t state;		/* handle from utee_cryp_state_alloc() */
+	uint64_t src;		/* pointer to input data */
+	uint64_t src_len;
+	uint64_t dst;		/* pointer to output or hash buffer */
+	uint64_t dst_len;	/* in: size of dst, out: bytes produced */
+	uint32_t op;		/* enum utee_cryp_op_type */
+	uint32_t ret;		/* TEE_Result of this operation */
+};
+
 #endif /* UTEE_TYPES_H */
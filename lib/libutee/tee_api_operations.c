@@ -1601,6 +1601,244 @@ out:
 	return res;
 }
 
+/* Cryptographic Operations API - Batched Functions (extension) */
+
+/* Number of operations handed to the TEE Core in one utee_cryp_batch() */
+#define CRYP_BATCH_MAX_OPS	8
+
+static uint32_t cryp_batch_check_entry(const TEE_CrypBatchEntry *e)
+{
+	TEE_OperationHandle op = e->operation;
+
+	if (op == TEE_HANDLE_NULL || (!e->src && e->srcLen))
+		TEE_Panic(0);
+
+	switch (e->op) {
+	case TEE_CRYP_BATCH_DIGEST_UPDATE:
+	case TEE_CRYP_BATCH_DIGEST_DO_FINAL:
+		if (op->info.operationClass != TEE_OPERATION_DIGEST)
+			TEE_Panic(0);
+		if (e->op == TEE_CRYP_BATCH_DIGEST_DO_FINAL && !e->dest)
+			TEE_Panic(0);
+		break;
+	case TEE_CRYP_BATCH_MAC_UPDATE:
+	case TEE_CRYP_BATCH_MAC_COMPUTE_FINAL:
+		if (op->info.operationClass != TEE_OPERATION_MAC ||
+		    !(op->info.handleState & TEE_HANDLE_FLAG_INITIALIZED) ||
+		    op->operationState != TEE_OPERATION_STATE_ACTIVE)
+			TEE_Panic(0);
+		if (e->op == TEE_CRYP_BATCH_MAC_COMPUTE_FINAL && !e->dest)
+			TEE_Panic(0);
+		break;
+	case TEE_CRYP_BATCH_CIPHER_UPDATE:
+		if (op->info.operationClass != TEE_OPERATION_CIPHER ||
+		    !(op->info.handleState & TEE_HANDLE_FLAG_INITIALIZED) ||
+		    op->operationState != TEE_OPERATION_STATE_ACTIVE)
+			TEE_Panic(0);
+		if (!e->dest && e->destLen)
+			TEE_Panic(0);
+		break;
+	case TEE_CRYP_BATCH_AE_UPDATE_AAD:
+	case TEE_CRYP_BATCH_AE_UPDATE:
+		if (op->info.operationClass != TEE_OPERATION_AE ||
+		    !(op->info.handleState & TEE_HANDLE_FLAG_INITIALIZED))
+			TEE_Panic(0);
+		if (e->op == TEE_CRYP_BATCH_AE_UPDATE &&
+		    !e->dest && e->destLen)
+			TEE_Panic(0);
+		break;
+	default:
+		TEE_Panic(0);
+	}
+
+	switch (e->op) {
+	case TEE_CRYP_BATCH_DIGEST_UPDATE:
+	case TEE_CRYP_BATCH_MAC_UPDATE:
+		return UTEE_CRYP_OP_HASH_UPDATE;
+	case TEE_CRYP_BATCH_DIGEST_DO_FINAL:
+	case TEE_CRYP_BATCH_MAC_COMPUTE_FINAL:
+		return UTEE_CRYP_OP_HASH_FINAL;
+	case TEE_CRYP_BATCH_CIPHER_UPDATE:
+		return UTEE_CRYP_OP_CIPHER_UPDATE;
+	case TEE_CRYP_BATCH_AE_UPDATE_AAD:
+		return UTEE_CRYP_OP_AUTHENC_UPDATE_AAD;
+	default:
+		return UTEE_CRYP_OP_AUTHENC_UPDATE_PAYLOAD;
+	}
+}
+
+/*
+ * Cipher and AE updates which would need partial blocks to be buffered
+ * in the operation can't be forwarded as is to the TEE Core.
+ */
+static bool cryp_batch_can_forward(const TEE_CrypBatchEntry *e)
+{
+	TEE_OperationHandle op = e->operation;
+
+	if (e->op != TEE_CRYP_BATCH_CIPHER_UPDATE &&
+	    e->op != TEE_CRYP_BATCH_AE_UPDATE)
+		return true;
+
+	if (op->block_size <= 1)
+		return true;
+
+	return !op->buffer_two_blocks && !op->buffer_offs &&
+	       !(e->srcLen % op->block_size);
+}
+
+static bool cryp_batch_is_final(const TEE_CrypBatchEntry *e)
+{
+	return e->op == TEE_CRYP_BATCH_DIGEST_DO_FINAL ||
+	       e->op == TEE_CRYP_BATCH_MAC_COMPUTE_FINAL;
+}
+
+/*
+ * Entries are checked against the state of the operation when they're
+ * queued, but a final changes that state only once it has been
+ * completed. Entries following a pending final on the same operation
+ * must wait until the final is done and the operation state is updated.
+ */
+static bool cryp_batch_final_pending(TEE_CrypBatchEntry **entries,
+				     size_t num_ops, TEE_OperationHandle op)
+{
+	size_t n;
+
+	for (n = 0; n < num_ops; n++)
+		if (entries[n]->operation == op &&
+		    cryp_batch_is_final(entries[n]))
+			return true;
+	return false;
+}
+
+static TEE_Result cryp_batch_call_single(TEE_CrypBatchEntry *e)
+{
+	TEE_OperationHandle op = e->operation;
+
+	switch (e->op) {
+	case TEE_CRYP_BATCH_CIPHER_UPDATE:
+		return TEE_CipherUpdate(op, e->src, e->srcLen, e->dest,
+					&e->destLen);
+	case TEE_CRYP_BATCH_AE_UPDATE:
+		return TEE_AEUpdate(op, e->src, e->srcLen, e->dest,
+				    &e->destLen);
+	default:
+		TEE_Panic(0);
+		return TEE_ERROR_GENERIC;
+	}
+}
+
+static void cryp_batch_entry_done(TEE_CrypBatchEntry *e)
+{
+	TEE_OperationHandle op = e->operation;
+
+	switch (e->op) {
+	case TEE_CRYP_BATCH_DIGEST_DO_FINAL:
+		/* Reset operation state */
+		init_hash_operation(op, NULL, 0);
+		op->operationState = TEE_OPERATION_STATE_INITIAL;
+		break;
+	case TEE_CRYP_BATCH_MAC_COMPUTE_FINAL:
+		op->info.handleState &= ~TEE_HANDLE_FLAG_INITIALIZED;
+		op->operationState = TEE_OPERATION_STATE_INITIAL;
+		break;
+	case TEE_CRYP_BATCH_DIGEST_UPDATE:
+	case TEE_CRYP_BATCH_AE_UPDATE_AAD:
+	case TEE_CRYP_BATCH_AE_UPDATE:
+		op->operationState = TEE_OPERATION_STATE_ACTIVE;
+		break;
+	default:
+		break;
+	}
+}
+
+static TEE_Result cryp_batch_flush(TEE_CrypBatchEntry **entries,
+				   struct utee_cryp_op *ops, size_t num_ops)
+{
+	TEE_Result res;
+	size_t n;
+
+	if (!num_ops)
+		return TEE_SUCCESS;
+
+	res = utee_cryp_batch(ops, num_ops);
+
+	for (n = 0; n < num_ops; n++) {
+		TEE_CrypBatchEntry *e = entries[n];
+
+		e->res = ops[n].ret;
+		if (e->op != TEE_CRYP_BATCH_DIGEST_UPDATE &&
+		    e->op != TEE_CRYP_BATCH_MAC_UPDATE &&
+		    e->op != TEE_CRYP_BATCH_AE_UPDATE_AAD)
+			e->destLen = ops[n].dst_len;
+		if (e->res != TEE_SUCCESS)
+			break;
+		cryp_batch_entry_done(e);
+	}
+
+	if (res != TEE_SUCCESS && res != TEE_ERROR_SHORT_BUFFER)
+		TEE_Panic(res);
+
+	return res;
+}
+
+TEE_Result TEE_CrypBatch(TEE_CrypBatchEntry *entries, uint32_t numEntries)
+{
+	TEE_Result res = TEE_SUCCESS;
+	TEE_CrypBatchEntry *pending[CRYP_BATCH_MAX_OPS];
+	struct utee_cryp_op ops[CRYP_BATCH_MAX_OPS];
+	size_t num_ops = 0;
+	uint32_t n;
+
+	if (!entries && numEntries)
+		TEE_Panic(0);
+
+	for (n = 0; n < numEntries; n++) {
+		TEE_CrypBatchEntry *e = entries + n;
+		uint32_t utee_op;
+
+		if (cryp_batch_final_pending(pending, num_ops, e->operation)) {
+			res = cryp_batch_flush(pending, ops, num_ops);
+			num_ops = 0;
+			if (res != TEE_SUCCESS)
+				return res;
+		}
+
+		utee_op = cryp_batch_check_entry(e);
+		if (!cryp_batch_can_forward(e)) {
+			res = cryp_batch_flush(pending, ops, num_ops);
+			num_ops = 0;
+			if (res != TEE_SUCCESS)
+				return res;
+
+			e->res = cryp_batch_call_single(e);
+			if (e->res != TEE_SUCCESS)
+				return e->res;
+			continue;
+		}
+
+		ops[num_ops] = (struct utee_cryp_op){
+			.state = e->operation->state,
+			.src = (uintptr_t)e->src,
+			.src_len = e->srcLen,
+			.dst = (uintptr_t)e->dest,
+			.dst_len = e->destLen,
+			.op = utee_op,
+			.ret = TEE_ERROR_GENERIC,
+		};
+		pending[num_ops] = e;
+		num_ops++;
+
+		if (num_ops == CRYP_BATCH_MAX_OPS) {
+			res = cryp_batch_flush(pending, ops, num_ops);
+			num_ops = 0;
+			if (res != TEE_SUCCESS)
+				return res;
+		}
+	}
+
+	return cryp_batch_flush(pending, ops, num_ops);
+}
+
 /* Cryptographic Operations API - Asymmetric Functions */
 
 TEE_Result TEE_AsymmetricEncrypt(TEE_OperationHandle operation,
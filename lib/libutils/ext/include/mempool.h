@@ -19,6 +19,22 @@ struct mempool_item {
 
 struct mempool;
 
+/*
+ * struct mempool_stats - usage of a memory pool
+ * @arena_size:		size in bytes of each arena
+ * @num_arenas:		number of arenas in the pool
+ * @max_allocated:	high-water mark in bytes of the most used arena
+ * @max_arenas_in_use:	highest number of arenas in use at the same time
+ * @num_waits:		number of times a thread had to wait for a free arena
+ */
+struct mempool_stats {
+	size_t arena_size;
+	size_t num_arenas;
+	size_t max_allocated;
+	size_t max_arenas_in_use;
+	size_t num_waits;
+};
+
 #define MEMPOOL_ALIGN	__alignof__(long)
 
 /*
@@ -33,6 +49,25 @@ struct mempool;
 struct mempool *mempool_alloc_pool(void *data, size_t size,
 				   void (*release_mem)(void *ptr, size_t size));
 
+/*
+ * mempool_alloc_pool_arenas() - Allocate a new memory pool split in arenas
+ * @data:		a block of memory of @num_arenas * @size bytes to
+ *			carve out items from, must have an alignment of
+ *			MEMPOOL_ALIGN.
+ * @size:		size of each arena, a multiple of MEMPOOL_ALIGN
+ * @num_arenas:		number of arenas
+ * @release_mem:	function to call when an arena has been emptied,
+ *			ignored if NULL.
+ *
+ * In the kernel each thread allocates from an arena of its own, a thread
+ * only has to wait when all arenas are used by other threads. In user
+ * space this is the same as mempool_alloc_pool().
+ * returns a pointer to a valid pool on success or NULL on failure.
+ */
+struct mempool *
+mempool_alloc_pool_arenas(void *data, size_t size, size_t num_arenas,
+			  void (*release_mem)(void *ptr, size_t size));
+
 /*
  * mempool_alloc() - Allocate an item from a memory pool
  * @pool:		A memory pool created with mempool_alloc_pool()
@@ -41,6 +76,18 @@ struct mempool *mempool_alloc_pool(void *data, size_t size,
  */
 void *mempool_alloc(struct mempool *pool, size_t size);
 
+/*
+ * mempool_try_alloc() - Allocate an item from a memory pool, without
+ *			 reporting a failure
+ * @pool:		A memory pool created with mempool_alloc_pool()
+ * @size:		Size in bytes of the item to allocate
+ *
+ * For optional allocations where the caller has a fallback, the pool
+ * being too small isn't an error then.
+ * return a valid pointer on success or NULL on failure.
+ */
+void *mempool_try_alloc(struct mempool *pool, size_t size);
+
 /*
  * mempool_calloc() - Allocate and zero initialize an array of elements from a
  *		      memory pool
@@ -58,4 +105,14 @@ void *mempool_calloc(struct mempool *pool, size_t nmemb, size_t size);
  */
 void mempool_free(struct mempool *pool, void *ptr);
 
+/*
+ * mempool_get_stats() - Get usage statistics of a memory pool
+ * @pool:		A memory pool created with mempool_alloc_pool()
+ * @stats:		Filled in with the statistics
+ * @reset:		If true the high-water marks and the wait counter
+ *			are reset after being reported
+ */
+void mempool_get_stats(struct mempool *pool, struct mempool_stats *stats,
+		       bool reset);
+
 #endif /*__MEMPOOL_H*/
@@ -30,6 +30,12 @@ static inline int buf_compare_ct(const void *s1, const void *s2, size_t n)
 	return consttime_memcmp(s1, s2, n);
 }
 
+/*
+ * Like memset(s, 0, count) but the call can't be optimized away, use it
+ * to clear sensitive data before the memory is released.
+ */
+void memzero_explicit(void *s, size_t count);
+
 /* Variant of strdup() that uses nex_malloc() instead of malloc() */
 char *nex_strdup(const char *s);
 
@@ -54,9 +54,27 @@
  */
 
 
-struct mempool {
-	size_t size;  /* size of the memory pool, in bytes */
+/*
+ * A pool can be split into several arenas of equal size, laid out back to
+ * back in the memory block passed to mempool_alloc_pool_arenas(). In the
+ * kernel an arena is owned by one thread at a time, a thread keeps using
+ * the arena it owns until all its items are freed. Threads which don't
+ * own an arena take a free one and only block when all arenas are owned
+ * by other threads. With one arena per thread, concurrent users of the
+ * pool never wait for each other.
+ */
+struct mempool_arena {
 	ssize_t last_offset;   /* offset to the last one */
+	size_t max_allocated;
+#if defined(__KERNEL__)
+	struct refcount refc;
+	int owner;
+#endif
+};
+
+struct mempool {
+	size_t size;  /* size of each arena, in bytes */
+	size_t num_arenas;
 	vaddr_t data;
 #ifdef CFG_MEMPOOL_REPORT_LAST_OFFSET
 	ssize_t max_last_offset;
@@ -65,102 +83,162 @@ struct mempool {
 	void (*release_mem)(void *ptr, size_t size);
 	struct mutex mu;
 	struct condvar cv;
-	struct refcount refc;
-	int owner;
+	size_t num_in_use;
+	size_t max_in_use;
+	size_t num_waits;
 #endif
+	struct mempool_arena arenas[];
 };
 
-static void get_pool(struct mempool *pool __maybe_unused)
+static vaddr_t arena_data(struct mempool *pool, struct mempool_arena *arena)
+{
+	return pool->data + (arena - pool->arenas) * pool->size;
+}
+
+static struct mempool_arena *get_arena(struct mempool *pool)
 {
 #if defined(__KERNEL__)
+	struct mempool_arena *arena = NULL;
+	int id = thread_get_id();
+	size_t n;
+
 	/*
 	 * Owner matches our thread it cannot be changed. If it doesn't
 	 * match it can change any at time we're not holding the mutex to
 	 * any value but our thread id.
 	 */
-	if (atomic_load_int(&pool->owner) == thread_get_id()) {
-		if (!refcount_inc(&pool->refc))
-			panic();
-		return;
+	for (n = 0; n < pool->num_arenas; n++) {
+		arena = pool->arenas + n;
+		if (atomic_load_int(&arena->owner) == id) {
+			if (!refcount_inc(&arena->refc))
+				panic();
+			return arena;
+		}
 	}
 
 	mutex_lock(&pool->mu);
 
-	/* Wait until the pool is available */
-	while (pool->owner != THREAD_ID_INVALID)
+	/* Wait until an arena is available */
+	while (true) {
+		for (n = 0; n < pool->num_arenas; n++) {
+			arena = pool->arenas + n;
+			if (arena->owner == THREAD_ID_INVALID)
+				goto out;
+		}
+		pool->num_waits++;
 		condvar_wait(&pool->cv, &pool->mu);
-
-	pool->owner = thread_get_id();
-	refcount_set(&pool->refc, 1);
+	}
+out:
+	atomic_store_int(&arena->owner, id);
+	refcount_set(&arena->refc, 1);
+	pool->num_in_use++;
+	if (pool->num_in_use > pool->max_in_use)
+		pool->max_in_use = pool->num_in_use;
 
 	mutex_unlock(&pool->mu);
+
+	return arena;
+#else
+	return pool->arenas;
 #endif
 }
 
-static void put_pool(struct mempool *pool __maybe_unused)
+static void put_arena(struct mempool *pool __maybe_unused,
+		      struct mempool_arena *arena __maybe_unused)
 {
 #if defined(__KERNEL__)
-	assert(atomic_load_int(&pool->owner) == thread_get_id());
+	assert(atomic_load_int(&arena->owner) == thread_get_id());
 
-	if (refcount_dec(&pool->refc)) {
+	if (refcount_dec(&arena->refc)) {
 		mutex_lock(&pool->mu);
 
 		/*
 		 * Do an atomic store to match the atomic load in
-		 * get_pool() above.
+		 * get_arena() above.
 		 */
-		atomic_store_int(&pool->owner, THREAD_ID_INVALID);
+		atomic_store_int(&arena->owner, THREAD_ID_INVALID);
+		pool->num_in_use--;
 		condvar_signal(&pool->cv);
 
 		/* As the refcount is 0 there should be no items left */
-		if (pool->last_offset >= 0)
+		if (arena->last_offset >= 0)
 			panic();
 		if (pool->release_mem)
-			pool->release_mem((void *)pool->data, pool->size);
+			pool->release_mem((void *)arena_data(pool, arena),
+					  pool->size);
 
 		mutex_unlock(&pool->mu);
 	}
 #endif
 }
 
+static struct mempool_arena *find_arena(struct mempool *pool, void *ptr)
+{
+	size_t n = ((vaddr_t)ptr - pool->data) / pool->size;
+
+	assert((vaddr_t)ptr >= pool->data && n < pool->num_arenas);
+	return pool->arenas + n;
+}
+
 struct mempool *
-mempool_alloc_pool(void *data, size_t size,
-		   void (*release_mem)(void *ptr, size_t size) __maybe_unused)
+mempool_alloc_pool_arenas(void *data, size_t size, size_t num_arenas,
+			  void (*release_mem)(void *ptr,
+					      size_t size) __maybe_unused)
 {
-	struct mempool *pool = calloc(1, sizeof(*pool));
+	struct mempool *pool = NULL;
+	size_t sz = 0;
+	size_t n = 0;
 
 	COMPILE_TIME_ASSERT(MEMPOOL_ALIGN >= __alignof__(struct mempool_item));
 	assert(!((vaddr_t)data & (MEMPOOL_ALIGN - 1)));
+	assert(num_arenas == 1 || !(size & (MEMPOOL_ALIGN - 1)));
 
+	if (!num_arenas ||
+	    MUL_OVERFLOW(num_arenas, sizeof(struct mempool_arena), &sz) ||
+	    ADD_OVERFLOW(sz, sizeof(*pool), &sz))
+		return NULL;
+
+	pool = calloc(1, sz);
 	if (pool) {
 		pool->size = size;
+		pool->num_arenas = num_arenas;
 		pool->data = (vaddr_t)data;
-		pool->last_offset = -1;
 #if defined(__KERNEL__)
 		pool->release_mem = release_mem;
 		mutex_init(&pool->mu);
 		condvar_init(&pool->cv);
-		pool->owner = THREAD_ID_INVALID;
 #endif
+		for (n = 0; n < num_arenas; n++) {
+			pool->arenas[n].last_offset = -1;
+#if defined(__KERNEL__)
+			pool->arenas[n].owner = THREAD_ID_INVALID;
+#endif
+		}
 	}
 
 	return pool;
 }
 
-void *mempool_alloc(struct mempool *pool, size_t size)
+struct mempool *
+mempool_alloc_pool(void *data, size_t size,
+		   void (*release_mem)(void *ptr, size_t size) __maybe_unused)
+{
+	return mempool_alloc_pool_arenas(data, size, 1, release_mem);
+}
+
+static void *alloc_item(struct mempool *pool, size_t size, bool log_failure)
 {
 	size_t offset;
 	struct mempool_item *new_item;
 	struct mempool_item *last_item = NULL;
+	struct mempool_arena *arena = get_arena(pool);
+	vaddr_t data = arena_data(pool, arena);
 
-	get_pool(pool);
-
-	if (pool->last_offset < 0) {
+	if (arena->last_offset < 0) {
 		offset = 0;
 	} else {
-		last_item = (struct mempool_item *)(pool->data +
-						    pool->last_offset);
-		offset = pool->last_offset + last_item->size;
+		last_item = (struct mempool_item *)(data + arena->last_offset);
+		offset = arena->last_offset + last_item->size;
 
 		offset = ROUNDUP(offset, MEMPOOL_ALIGN);
 		if (offset > pool->size)
@@ -172,16 +250,18 @@ void *mempool_alloc(struct mempool *pool, size_t size)
 	if (offset + size > pool->size)
 		goto error;
 
-	new_item = (struct mempool_item *)(pool->data + offset);
+	new_item = (struct mempool_item *)(data + offset);
 	new_item->size = size;
-	new_item->prev_item_offset = pool->last_offset;
+	new_item->prev_item_offset = arena->last_offset;
 	if (last_item)
 		last_item->next_item_offset = offset;
 	new_item->next_item_offset = -1;
-	pool->last_offset = offset;
+	arena->last_offset = offset;
+	if (offset + size > arena->max_allocated)
+		arena->max_allocated = offset + size;
 #ifdef CFG_MEMPOOL_REPORT_LAST_OFFSET
-	if (pool->last_offset > pool->max_last_offset) {
-		pool->max_last_offset = pool->last_offset;
+	if (arena->last_offset > pool->max_last_offset) {
+		pool->max_last_offset = arena->last_offset;
 		DMSG("Max memory usage increased to %zu",
 		     (size_t)pool->max_last_offset);
 	}
@@ -190,11 +270,23 @@ void *mempool_alloc(struct mempool *pool, size_t size)
 	return new_item + 1;
 
 error:
-	EMSG("Failed to allocate %zu bytes, please tune the pool size", size);
-	put_pool(pool);
+	if (log_failure)
+		EMSG("Failed to allocate %zu bytes, please tune the pool size",
+		     size);
+	put_arena(pool, arena);
 	return NULL;
 }
 
+void *mempool_alloc(struct mempool *pool, size_t size)
+{
+	return alloc_item(pool, size, true);
+}
+
+void *mempool_try_alloc(struct mempool *pool, size_t size)
+{
+	return alloc_item(pool, size, false);
+}
+
 void *mempool_calloc(struct mempool *pool, size_t nmemb, size_t size)
 {
 	size_t sz;
@@ -212,30 +304,66 @@ void *mempool_calloc(struct mempool *pool, size_t nmemb, size_t size)
 
 void mempool_free(struct mempool *pool, void *ptr)
 {
+	struct mempool_arena *arena;
 	struct mempool_item *item;
 	struct mempool_item *prev_item;
 	struct mempool_item *next_item;
 	ssize_t last_offset = -1;
+	vaddr_t data;
 
 	if (!ptr)
 		return;
 
+	arena = find_arena(pool, ptr);
+	data = arena_data(pool, arena);
 	item = (struct mempool_item *)((vaddr_t)ptr -
 				       sizeof(struct mempool_item));
 	if (item->prev_item_offset >= 0) {
-		prev_item = (struct mempool_item *)(pool->data +
+		prev_item = (struct mempool_item *)(data +
 						    item->prev_item_offset);
 		prev_item->next_item_offset = item->next_item_offset;
 		last_offset = item->prev_item_offset;
 	}
 
 	if (item->next_item_offset >= 0) {
-		next_item = (struct mempool_item *)(pool->data +
+		next_item = (struct mempool_item *)(data +
 						    item->next_item_offset);
 		next_item->prev_item_offset = item->prev_item_offset;
-		last_offset = pool->last_offset;
+		last_offset = arena->last_offset;
 	}
 
-	pool->last_offset = last_offset;
-	put_pool(pool);
+	arena->last_offset = last_offset;
+	put_arena(pool, arena);
+}
+
+void mempool_get_stats(struct mempool *pool, struct mempool_stats *stats,
+		       bool reset)
+{
+	size_t n;
+
+	memset(stats, 0, sizeof(*stats));
+	stats->arena_size = pool->size;
+	stats->num_arenas = pool->num_arenas;
+
+#if defined(__KERNEL__)
+	mutex_lock(&pool->mu);
+	stats->max_arenas_in_use = pool->max_in_use;
+	stats->num_waits = pool->num_waits;
+	if (reset) {
+		pool->max_in_use = pool->num_in_use;
+		pool->num_waits = 0;
+	}
+#endif
+
+	/* Racing with the owners only makes the figures slightly stale */
+	for (n = 0; n < pool->num_arenas; n++) {
+		stats->max_allocated = MAX(stats->max_allocated,
+					   pool->arenas[n].max_allocated);
+		if (reset)
+			pool->arenas[n].max_allocated = 0;
+	}
+
+#if defined(__KERNEL__)
+	mutex_unlock(&pool->mu);
+#endif
 }
@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2018, Linaro Limited
+ */
+
+#include <string.h>
+#include <string_ext.h>
+
+/*
+ * Calling memset() through a volatile function pointer keeps the compiler
+ * from treating the store as dead, even when the buffer is about to be
+ * freed or goes out of scope.
+ */
+static void *(*const volatile memset_func)(void *, int, size_t) = memset;
+
+void memzero_explicit(void *s, size_t count)
+{
+	memset_func(s, 0, count);
+}
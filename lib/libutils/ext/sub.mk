@@ -7,5 +7,6 @@ srcs-y += trace.c
 srcs-y += mempool.c
 srcs-y += nex_strdup.c
 srcs-y += consttime_memcmp.c
+srcs-y += memzero_explicit.c
 
 subdirs-$(arch_arm) += arch/$(ARCH)
@@ -89,6 +89,7 @@
 #if defined(__KERNEL__)
 /* Compiling for TEE Core */
 #include <kernel/asan.h>
+#include <kernel/misc.h>
 #include <kernel/thread.h>
 #include <kernel/spinlock.h>
 
@@ -132,6 +133,37 @@ struct malloc_pool {
 	size_t len;
 };
 
+/*
+ * Small buffers released with free() are kept in per-CPU caches, one list
+ * of buffers per size class, instead of being returned to bget. malloc()
+ * and calloc() of a small size take a buffer from the cache of the
+ * current CPU when possible, which is O(1) and doesn't need the lock of
+ * the malloc context. The caches are drained back into bget when an
+ * allocation fails and before the allocated buffers are inspected.
+ *
+ * The size classes are multiples of SizeQuant up to MALLOC_CACHE_MAX_SIZE,
+ * a cached buffer of size class n has room for at least (n + 1) *
+ * SizeQuant bytes.
+ */
+#define MALLOC_CACHE_MAX_SIZE	128
+#define MALLOC_CACHE_NUM_CLASSES (MALLOC_CACHE_MAX_SIZE / SizeQuant)
+#define MALLOC_CACHE_DEPTH	8
+
+#ifdef __KERNEL__
+#define MALLOC_CACHE_NUM_CPUS	CFG_TEE_CORE_NB_CORE
+#else
+#define MALLOC_CACHE_NUM_CPUS	1
+#endif
+
+struct malloc_cache {
+	void *bufs[MALLOC_CACHE_NUM_CLASSES][MALLOC_CACHE_DEPTH];
+	uint8_t num_bufs[MALLOC_CACHE_NUM_CLASSES];
+	size_t cached_bytes;	/* As accounted by bget, with headers */
+#ifdef __KERNEL__
+	unsigned int spinlock;
+#endif
+};
+
 struct malloc_ctx {
 	struct bpoolset poolset;
 	struct malloc_pool *pool;
@@ -142,6 +174,9 @@ struct malloc_ctx {
 #ifdef __KERNEL__
 	unsigned int spinlock;
 #endif
+#ifndef ENABLE_MDBG
+	struct malloc_cache cache[MALLOC_CACHE_NUM_CPUS];
+#endif
 };
 
 #ifdef __KERNEL__
@@ -181,6 +216,9 @@ static DEFINE_CTX(malloc_ctx);
 static __nex_data DEFINE_CTX(nex_malloc_ctx);
 #endif
 
+static size_t cache_get_cached_bytes(struct malloc_ctx *ctx);
+static void cache_drain(struct malloc_ctx *ctx);
+
 #ifdef BufStats
 
 static void raw_malloc_return_hook(void *p, size_t requested_size,
@@ -201,7 +239,10 @@ static void raw_malloc_return_hook(void *p, size_t requested_size,
 
 static void gen_malloc_reset_stats(struct malloc_ctx *ctx)
 {
-	uint32_t exceptions = malloc_lock(ctx);
+	uint32_t exceptions = 0;
+
+	cache_drain(ctx);
+	exceptions = malloc_lock(ctx);
 
 	ctx->mstats.max_allocated = 0;
 	ctx->mstats.num_alloc_fail = 0;
@@ -218,10 +259,13 @@ void malloc_reset_stats(void)
 static void gen_malloc_get_stats(struct malloc_ctx *ctx,
 				 struct malloc_stats *stats)
 {
+	size_t cached_bytes = cache_get_cached_bytes(ctx);
 	uint32_t exceptions = malloc_lock(ctx);
 
 	memcpy(stats, &ctx->mstats, sizeof(*stats));
-	stats->allocated = ctx->poolset.totalloc;
+	/* Buffers held in the caches are free as seen by the callers */
+	stats->allocated = ctx->poolset.totalloc -
+			   MIN(cached_bytes, (size_t)ctx->poolset.totalloc);
 	malloc_unlock(ctx, exceptions);
 }
 
@@ -438,6 +482,181 @@ static __maybe_unused bufsize bget_buf_size(void *buf)
 
 #ifdef ENABLE_MDBG
 
+/* The debug allocations keep their headers, they are never cached */
+static size_t cache_get_cached_bytes(struct malloc_ctx *ctx __unused)
+{
+	return 0;
+}
+
+static void cache_drain(struct malloc_ctx *ctx __unused)
+{
+}
+
+#else /*ENABLE_MDBG*/
+
+#ifdef __KERNEL__
+
+static struct malloc_cache *cache_lock(struct malloc_ctx *ctx, size_t pos,
+				       uint32_t *exceptions)
+{
+	struct malloc_cache *cache = ctx->cache + pos;
+
+	*exceptions = cpu_spin_lock_xsave(&cache->spinlock);
+	return cache;
+}
+
+static struct malloc_cache *cache_lock_this_cpu(struct malloc_ctx *ctx,
+						uint32_t *exceptions)
+{
+	struct malloc_cache *cache = NULL;
+
+	/* Exceptions must be masked before get_core_pos() */
+	*exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
+	cache = ctx->cache + get_core_pos();
+	cpu_spin_lock(&cache->spinlock);
+	return cache;
+}
+
+static void cache_unlock(struct malloc_cache *cache, uint32_t exceptions)
+{
+	cpu_spin_unlock_xrestore(&cache->spinlock, exceptions);
+}
+
+#else /*__KERNEL__*/
+
+static struct malloc_cache *cache_lock(struct malloc_ctx *ctx, size_t pos,
+				       uint32_t *exceptions __unused)
+{
+	return ctx->cache + pos;
+}
+
+static struct malloc_cache *cache_lock_this_cpu(struct malloc_ctx *ctx,
+						uint32_t *exceptions)
+{
+	return cache_lock(ctx, 0, exceptions);
+}
+
+static void cache_unlock(struct malloc_cache *cache __unused,
+			 uint32_t exceptions __unused)
+{
+}
+
+#endif /*__KERNEL__*/
+
+/* Returns a buffer with room for at least @size bytes, or NULL */
+static void *cache_alloc(struct malloc_ctx *ctx, size_t size)
+{
+	struct malloc_cache *cache = NULL;
+	uint32_t exceptions = 0;
+	void *buf = NULL;
+	size_t cls = 0;
+
+	if (size > MALLOC_CACHE_MAX_SIZE)
+		return NULL;
+	if (size)
+		cls = (size - 1) / SizeQuant;
+
+	cache = cache_lock_this_cpu(ctx, &exceptions);
+	if (cache->num_bufs[cls]) {
+		cache->num_bufs[cls]--;
+		buf = cache->bufs[cls][cache->num_bufs[cls]];
+		cache->cached_bytes -= bget_buf_size(buf) + sizeof(struct bhead);
+	}
+	cache_unlock(cache, exceptions);
+
+	if (buf)
+		tag_asan_alloced(buf, size);
+	return buf;
+}
+
+/* Returns true if @buf was added to the cache */
+static bool cache_free(struct malloc_ctx *ctx, void *buf)
+{
+	struct malloc_cache *cache = NULL;
+	uint32_t exceptions = 0;
+	bool ret = false;
+	size_t size = 0;
+	size_t cls = 0;
+
+	if (!buf)
+		return false;
+
+	size = bget_buf_size(buf);
+	if (size > MALLOC_CACHE_MAX_SIZE)
+		return false;
+	cls = size / SizeQuant - 1;
+
+	cache = cache_lock_this_cpu(ctx, &exceptions);
+	if (cache->num_bufs[cls] < MALLOC_CACHE_DEPTH) {
+		cache->bufs[cls][cache->num_bufs[cls]] = buf;
+		cache->num_bufs[cls]++;
+		cache->cached_bytes += size + sizeof(struct bhead);
+		ret = true;
+	}
+	cache_unlock(cache, exceptions);
+
+	if (ret)
+		tag_asan_free(buf, size);
+	return ret;
+}
+
+static size_t cache_get_cached_bytes(struct malloc_ctx *ctx)
+{
+	struct malloc_cache *cache = NULL;
+	uint32_t exceptions = 0;
+	size_t ret = 0;
+	size_t n = 0;
+
+	for (n = 0; n < MALLOC_CACHE_NUM_CPUS; n++) {
+		cache = cache_lock(ctx, n, &exceptions);
+		ret += cache->cached_bytes;
+		cache_unlock(cache, exceptions);
+	}
+
+	return ret;
+}
+
+/*
+ * Returns all cached buffers to bget. The lock of a cache is never held
+ * together with the lock of the malloc context.
+ */
+static void cache_drain(struct malloc_ctx *ctx)
+{
+	void *bufs[MALLOC_CACHE_DEPTH] = { NULL };
+	struct malloc_cache *cache = NULL;
+	uint32_t exceptions = 0;
+	size_t num_bufs = 0;
+	size_t cls = 0;
+	size_t n = 0;
+	size_t m = 0;
+
+	for (n = 0; n < MALLOC_CACHE_NUM_CPUS; n++) {
+		for (cls = 0; cls < MALLOC_CACHE_NUM_CLASSES; cls++) {
+			cache = cache_lock(ctx, n, &exceptions);
+			num_bufs = cache->num_bufs[cls];
+			for (m = 0; m < num_bufs; m++) {
+				bufs[m] = cache->bufs[cls][m];
+				cache->cached_bytes -= bget_buf_size(bufs[m]) +
+						       sizeof(struct bhead);
+			}
+			cache->num_bufs[cls] = 0;
+			cache_unlock(cache, exceptions);
+
+			if (!num_bufs)
+				continue;
+
+			exceptions = malloc_lock(ctx);
+			for (m = 0; m < num_bufs; m++)
+				raw_free(bufs[m], ctx);
+			malloc_unlock(ctx, exceptions);
+		}
+	}
+}
+
+#endif /*ENABLE_MDBG*/
+
+#ifdef ENABLE_MDBG
+
 struct mdbg_hdr {
 	const char *fname;
 	uint16_t line;
@@ -641,34 +860,77 @@ void mdbg_check(int bufdump)
 }
 #else
 
-void *malloc(size_t size)
+static void *gen_malloc(struct malloc_ctx *ctx, size_t size)
 {
-	void *p;
-	uint32_t exceptions = malloc_lock(&malloc_ctx);
+	void *p = cache_alloc(ctx, size);
+	uint32_t exceptions;
 
-	p = raw_malloc(0, 0, size, &malloc_ctx);
-	malloc_unlock(&malloc_ctx, exceptions);
+	if (p)
+		return p;
+
+	exceptions = malloc_lock(ctx);
+	p = raw_malloc(0, 0, size, ctx);
+	malloc_unlock(ctx, exceptions);
+	if (!p && cache_get_cached_bytes(ctx)) {
+		cache_drain(ctx);
+		exceptions = malloc_lock(ctx);
+		p = raw_malloc(0, 0, size, ctx);
+		malloc_unlock(ctx, exceptions);
+	}
 	return p;
 }
 
-void free(void *ptr)
+static void gen_free(struct malloc_ctx *ctx, void *ptr)
 {
-	uint32_t exceptions = malloc_lock(&malloc_ctx);
+	uint32_t exceptions;
 
-	raw_free(ptr, &malloc_ctx);
-	malloc_unlock(&malloc_ctx, exceptions);
+	if (cache_free(ctx, ptr))
+		return;
+
+	exceptions = malloc_lock(ctx);
+	raw_free(ptr, ctx);
+	malloc_unlock(ctx, exceptions);
 }
 
-void *calloc(size_t nmemb, size_t size)
+static void *gen_calloc(struct malloc_ctx *ctx, size_t nmemb, size_t size)
 {
+	uint32_t exceptions;
+	size_t s;
 	void *p;
-	uint32_t exceptions = malloc_lock(&malloc_ctx);
 
-	p = raw_calloc(0, 0, nmemb, size, &malloc_ctx);
-	malloc_unlock(&malloc_ctx, exceptions);
+	if (!MUL_OVERFLOW(nmemb, size, &s)) {
+		p = cache_alloc(ctx, s);
+		if (p)
+			return memset(p, 0, s);
+	}
+
+	exceptions = malloc_lock(ctx);
+	p = raw_calloc(0, 0, nmemb, size, ctx);
+	malloc_unlock(ctx, exceptions);
+	if (!p && cache_get_cached_bytes(ctx)) {
+		cache_drain(ctx);
+		exceptions = malloc_lock(ctx);
+		p = raw_calloc(0, 0, nmemb, size, ctx);
+		malloc_unlock(ctx, exceptions);
+	}
 	return p;
 }
 
+void *malloc(size_t size)
+{
+	return gen_malloc(&malloc_ctx, size);
+}
+
+void free(void *ptr)
+{
+	gen_free(&malloc_ctx, ptr);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+	return gen_calloc(&malloc_ctx, nmemb, size);
+}
+
 static void *realloc_unlocked(struct malloc_ctx *ctx, void *ptr,
 			      size_t size)
 {
@@ -739,7 +1001,11 @@ static bool gen_malloc_buffer_is_within_alloced(struct malloc_ctx *ctx,
 	uint8_t *start_buf = buf;
 	uint8_t *end_buf = start_buf + len;
 	bool ret = false;
-	uint32_t exceptions = malloc_lock(ctx);
+	uint32_t exceptions = 0;
+
+	/* Cached buffers are free, they must not be found below */
+	cache_drain(ctx);
+	exceptions = malloc_lock(ctx);
 
 	raw_malloc_validate_pools(ctx);
 
@@ -819,22 +1085,12 @@ bool malloc_buffer_overlaps_heap(void *buf, size_t len)
 
 void *nex_malloc(size_t size)
 {
-	void *p;
-	uint32_t exceptions = malloc_lock(&nex_malloc_ctx);
-
-	p = raw_malloc(0, 0, size, &nex_malloc_ctx);
-	malloc_unlock(&nex_malloc_ctx, exceptions);
-	return p;
+	return gen_malloc(&nex_malloc_ctx, size);
 }
 
 void *nex_calloc(size_t nmemb, size_t size)
 {
-	void *p;
-	uint32_t exceptions = malloc_lock(&nex_malloc_ctx);
-
-	p = raw_calloc(0, 0, nmemb, size, &nex_malloc_ctx);
-	malloc_unlock(&nex_malloc_ctx, exceptions);
-	return p;
+	return gen_calloc(&nex_malloc_ctx, nmemb, size);
 }
 
 void *nex_realloc(void *ptr, size_t size)
@@ -849,10 +1105,7 @@ void *nex_realloc(void *ptr, size_t size)
 
 void nex_free(void *ptr)
 {
-	uint32_t exceptions = malloc_lock(&nex_malloc_ctx);
-
-	raw_free(ptr, &nex_malloc_ctx);
-	malloc_unlock(&nex_malloc_ctx, exceptions);
+	gen_free(&nex_malloc_ctx, ptr);
 }
 
 #else  /* ENABLE_MDBG */
@@ -218,6 +218,24 @@ CFG_REE_FS_TA ?= y
 CFG_REE_FS_TA_BUFFERED ?= $(CFG_REE_FS_TA)
 $(eval $(call cfg-depends-all,CFG_REE_FS_TA_BUFFERED,CFG_REE_FS_TA))
 
+# Keep copies of verified TA binaries in a LRU cache in the "Secure DDR" pool.
+# A cached TA is loaded without calling into its store, that is without any
+# RPC to tee-supplicant or signature check. Installing or removing a TA in
+# secure storage drops the cached copy, a TA replaced in the REE filesystem
+# is picked up once its copy has been evicted. CFG_TA_IMAGE_CACHE_SIZE is the
+# maximum number of bytes used by the cache.
+# With CFG_PAGED_USER_TA=y the read-only segments of a TA loaded from the cache
+# are not copied at load time, the pager populates them from the cached copy
+# when they are first accessed.
+# The TA preload pseudo TA (pta_ta_preload.h) can load TAs into the cache and
+# pin them there, for instance the TAs listed in the secure device tree once
+# tee-supplicant is running, so the first session to those TAs is fast too.
+# Only TAs and REE kernel clients can use it. At most half of
+# CFG_TA_IMAGE_CACHE_SIZE can be used by pinned TAs.
+CFG_TA_IMAGE_CACHE ?= n
+CFG_TA_IMAGE_CACHE_SIZE ?= 0x100000
+$(eval $(call cfg-depends-all,CFG_TA_IMAGE_CACHE,CFG_WITH_USER_TA))
+
 # Support for loading user TAs from a special section in the TEE binary.
 # Such TAs are available even before tee-supplicant is available (hence their
 # name), but note that many services exported to TAs may need tee-supplicant,
@@ -262,6 +280,13 @@ CFG_WITH_PAGER ?= n
 # Expect a significant performance impact when enabling this.
 CFG_LOCKDEP ?= n
 
+# Number of times a thread polls a contended mutex, while the thread
+# holding it is executing on another CPU, before sleeping in normal world.
+# Sleeping and being woken up costs a round trip to normal world each, so
+# short critical sections are cheaper to wait for by spinning. 0 disables
+# spinning.
+CFG_MUTEX_SPIN_COUNT ?= 1000
+
 # BestFit algorithm in bget reduces the fragmentation of the heap when running
 # with the pager enabled or lockdep
 CFG_CORE_BGET_BESTFIT ?= $(call cfg-one-enabled, CFG_WITH_PAGER CFG_LOCKDEP)
@@ -378,6 +403,19 @@ $(eval $(call cfg-depends-all,CFG_SECSTOR_TA_MGMT_PTA,CFG_SECSTOR_TA))
 # GlobalPlatform Core API (for example, re-seeding RNG entropy pool etc.)
 CFG_SYSTEM_PTA ?= y
 
+# Asynchronous notifications from secure world to normal world, delivered
+# with an interrupt and retrieved with OPTEE_SMC_GET_ASYNC_NOTIF_VALUE.
+# Once normal world has enabled them wait queue wakeups are sent this way
+# instead of with RPC, and TAs can send notifications through the system
+# pseudo TA. CFG_CORE_ASYNC_NOTIF_GIC_INTID is the non-secure peripheral
+# interrupt raised in normal world, it has to be defined by the platform.
+CFG_CORE_ASYNC_NOTIF ?= n
+ifeq ($(CFG_CORE_ASYNC_NOTIF),y)
+ifeq ($(CFG_CORE_ASYNC_NOTIF_GIC_INTID),)
+$(error CFG_CORE_ASYNC_NOTIF=y requires CFG_CORE_ASYNC_NOTIF_GIC_INTID)
+endif
+endif
+
 # Enable the pseudo TA for enumeration of TEE based devices for the normal
 # world OS.
 CFG_DEVICE_ENUM_PTA ?= y
@@ -412,6 +450,17 @@ CFG_TA_BIGNUM_MAX_BITS ?= 2048
 # Set this to a lower value to reduce the memory footprint.
 CFG_CORE_BIGNUM_MAX_BITS ?= 4096
 
+# Number of arenas in the TEE core big number scratch memory pool. Each
+# thread doing a big number computation uses an arena of its own, threads
+# wait for each other when all arenas are in use. Each arena is a few tens
+# of KiB, so every extra arena adds to the memory footprint, with the pager
+# only the arenas in use are backed by physical pages.
+# Defaults to $(CFG_NUM_THREADS), but at most 4 arenas. Platforms doing many
+# concurrent asymmetric operations in the core can set this up to
+# $(CFG_NUM_THREADS) so those never wait for each other, platforms short on
+# memory can set it to 1.
+CFG_CORE_BIGNUM_NUM_ARENAS ?= $(firstword $(filter $(CFG_NUM_THREADS),1 2 3) 4)
+
 # Compiles mbedTLS for TA usage
 CFG_TA_MBEDTLS ?= y
 